@@ -108,6 +108,7 @@ fast_downward_plugin(
     HELP "System utilities"
     SOURCES
         utils/collections
+        utils/cache_file
         utils/countdown_timer
         utils/exceptions
         utils/hash
@@ -116,6 +117,8 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/memory_mapped_file
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/strings
@@ -224,6 +227,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME MONOTONE_PRIORITY_QUEUES
+    HELP "Monotone priority queues for Dijkstra's algorithm: ZeroOneQueue, DialQueue, RadixHeap and MonotoneQueue"
+    SOURCES
+        algorithms/monotone_priority_queues
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME ORDERED_SET
     HELP "Set of elements ordered by insertion time"
@@ -454,8 +465,11 @@ fast_downward_plugin(
     NAME LP_SOLVER
     HELP "Interface to an LP solver"
     SOURCES
+        lp/coin_solver_interface
+        lp/dual_simplex_solver_interface
         lp/lp_internals
         lp/lp_solver
+        lp/solver_interface
     DEPENDS NAMED_VECTOR
 )
 
@@ -528,7 +542,7 @@ fast_downward_plugin(
     HELP "The h^m heuristic"
     SOURCES
         heuristics/hm_heuristic
-    DEPENDS TASK_PROPERTIES
+    DEPENDS FACT_TUPLE_INDEX PRIORITY_QUEUES TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -570,6 +584,22 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME BIT_PARALLEL_REACHABILITY
+    HELP "Bit-parallel relaxed reachability"
+    SOURCES
+        task_utils/bit_parallel_reachability
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME FACT_TUPLE_INDEX
+    HELP "Perfect hashing of fact tuples"
+    SOURCES
+        task_utils/fact_tuple_index
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME CAUSAL_GRAPH
     HELP "Causal Graph"
@@ -620,12 +650,14 @@ fast_downward_plugin(
     SOURCES
         cegar/abstraction
         cegar/abstract_search
+        cegar/adjacency_lists
         cegar/abstract_state
         cegar/additive_cartesian_heuristic
         cegar/cartesian_heuristic_function
         cegar/cartesian_set
         cegar/cegar
         cegar/cost_saturation
+        cegar/flat_refinement_hierarchy
         cegar/refinement_hierarchy
         cegar/split_selector
         cegar/subtask_generators
@@ -634,15 +666,17 @@ fast_downward_plugin(
         cegar/types
         cegar/utils
         cegar/utils_landmarks
-    DEPENDS ADDITIVE_HEURISTIC DYNAMIC_BITSET EXTRA_TASKS LANDMARKS PRIORITY_QUEUES TASK_PROPERTIES
+    DEPENDS ADDITIVE_HEURISTIC DYNAMIC_BITSET EXTRA_TASKS LANDMARKS MONOTONE_PRIORITY_QUEUES PRIORITY_QUEUES TASK_PROPERTIES
 )
 
 fast_downward_plugin(
     NAME MAS_HEURISTIC
     HELP "The Merge-and-Shrink heuristic"
     SOURCES
+        merge_and_shrink/bisimulation_refinement
         merge_and_shrink/distances
         merge_and_shrink/factored_transition_system
+        merge_and_shrink/flat_merge_and_shrink_representation
         merge_and_shrink/fts_factory
         merge_and_shrink/label_equivalence_relation
         merge_and_shrink/label_reduction
@@ -650,6 +684,7 @@ fast_downward_plugin(
         merge_and_shrink/merge_and_shrink_algorithm
         merge_and_shrink/merge_and_shrink_heuristic
         merge_and_shrink/merge_and_shrink_representation
+        merge_and_shrink/merge_score_cache
         merge_and_shrink/merge_scoring_function
         merge_and_shrink/merge_scoring_function_dfp
         merge_and_shrink/merge_scoring_function_goal_relevance
@@ -670,6 +705,7 @@ fast_downward_plugin(
         merge_and_shrink/merge_tree
         merge_and_shrink/merge_tree_factory
         merge_and_shrink/merge_tree_factory_linear
+        merge_and_shrink/phase_statistics
         merge_and_shrink/shrink_bisimulation
         merge_and_shrink/shrink_bucket_based
         merge_and_shrink/shrink_fh
@@ -678,7 +714,7 @@ fast_downward_plugin(
         merge_and_shrink/transition_system
         merge_and_shrink/types
         merge_and_shrink/utils
-    DEPENDS PRIORITY_QUEUES EQUIVALENCE_RELATION SCCS TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS MONOTONE_PRIORITY_QUEUES PRIORITY_QUEUES EQUIVALENCE_RELATION SCCS TASK_PROPERTIES VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
@@ -696,9 +732,10 @@ fast_downward_plugin(
         landmarks/landmark_factory_rpg_sasp
         landmarks/landmark_factory_zhu_givan
         landmarks/landmark_graph
+        landmarks/landmark_set_pool
         landmarks/landmark_status_manager
         landmarks/util
-    DEPENDS LP_SOLVER PRIORITY_QUEUES SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS BIT_PARALLEL_REACHABILITY DYNAMIC_BITSET FACT_TUPLE_INDEX LP_SOLVER MONOTONE_PRIORITY_QUEUES PRIORITY_QUEUES SUCCESSOR_GENERATOR TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -742,7 +779,7 @@ fast_downward_plugin(
         pdbs/validation
         pdbs/zero_one_pdbs
         pdbs/zero_one_pdbs_heuristic
-    DEPENDS CAUSAL_GRAPH MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS CAUSAL_GRAPH MAX_CLIQUES MONOTONE_PRIORITY_QUEUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
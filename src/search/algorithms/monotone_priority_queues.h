@@ -0,0 +1,308 @@
+#ifndef ALGORITHMS_MONOTONE_PRIORITY_QUEUES_H
+#define ALGORITHMS_MONOTONE_PRIORITY_QUEUES_H
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/*
+  Priority queues for Dijkstra-style distance computations with non-negative
+  integer edge costs. Unlike the queues in priority_queues.h, these queues
+  require that keys are monotone: every pushed key must be at least as large
+  as the last popped key. Additionally, ZeroOneQueue and DialQueue require
+  that every pushed key exceeds the last popped key by at most the maximal
+  edge cost given to the constructor.
+
+  We define three monotone queues: ZeroOneQueue (breadth-first search with
+  a double-ended queue, for edge costs 0 and 1), DialQueue (circular array
+  of buckets, for small edge costs) and RadixHeap (for arbitrary edge
+  costs). MonotoneQueue picks one of them based on the maximal edge cost.
+
+  All queues have the same interface as AbstractQueue (without
+  convert_if_necessary() and add_virtual_pushes()). In contrast to
+  AdaptiveQueue, they never switch their implementation, so no virtual
+  function calls are needed.
+*/
+namespace priority_queues {
+template<typename Value>
+class ZeroOneQueue {
+    typedef std::pair<int, Value> Entry;
+    std::deque<Entry> entries;
+    int current_key;
+public:
+    ZeroOneQueue() : current_key(0) {
+    }
+
+    void push(int key, const Value &value) {
+        assert(key == current_key || key == current_key + 1);
+        if (key == current_key)
+            entries.emplace_front(key, value);
+        else
+            entries.emplace_back(key, value);
+    }
+
+    Entry pop() {
+        assert(!entries.empty());
+        Entry entry = entries.front();
+        entries.pop_front();
+        current_key = entry.first;
+        return entry;
+    }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    void clear() {
+        entries.clear();
+        current_key = 0;
+    }
+};
+
+
+template<typename Value>
+class DialQueue {
+    typedef std::pair<int, Value> Entry;
+    /*
+      Since all keys in the queue lie in [current_key, current_key +
+      max_cost], a bucket for each key modulo (max_cost + 1) suffices and
+      all values in a bucket have the same key.
+    */
+    std::vector<std::vector<Value>> buckets;
+    int current_key;
+    int current_bucket_no;
+    int num_entries;
+public:
+    explicit DialQueue(int max_cost)
+        : buckets(max_cost + 1),
+          current_key(0),
+          current_bucket_no(0),
+          num_entries(0) {
+        assert(max_cost >= 0);
+    }
+
+    void push(int key, const Value &value) {
+        int num_buckets = buckets.size();
+        assert(key >= current_key && key - current_key < num_buckets);
+        int bucket_no = current_bucket_no + (key - current_key);
+        if (bucket_no >= num_buckets)
+            bucket_no -= num_buckets;
+        buckets[bucket_no].push_back(value);
+        ++num_entries;
+    }
+
+    Entry pop() {
+        assert(num_entries > 0);
+        int num_buckets = buckets.size();
+        while (buckets[current_bucket_no].empty()) {
+            ++current_key;
+            if (++current_bucket_no == num_buckets)
+                current_bucket_no = 0;
+        }
+        std::vector<Value> &bucket = buckets[current_bucket_no];
+        Value value = bucket.back();
+        bucket.pop_back();
+        --num_entries;
+        return std::make_pair(current_key, value);
+    }
+
+    bool empty() const {
+        return num_entries == 0;
+    }
+
+    void clear() {
+        for (std::vector<Value> &bucket : buckets)
+            bucket.clear();
+        current_key = 0;
+        current_bucket_no = 0;
+        num_entries = 0;
+    }
+};
+
+
+template<typename Value>
+class RadixHeap {
+    typedef std::pair<int, Value> Entry;
+    static const int NUM_BUCKETS = std::numeric_limits<unsigned int>::digits + 1;
+
+    /*
+      Bucket 0 holds the entries with key last_key. Bucket i > 0 holds the
+      entries whose key differs from last_key in bit i - 1 as the most
+      significant differing bit.
+    */
+    std::vector<std::vector<Entry>> buckets;
+    unsigned int last_key;
+    int num_entries;
+
+    static int get_highest_bit(unsigned int x) {
+        assert(x != 0);
+#if defined(__GNUC__)
+        return std::numeric_limits<unsigned int>::digits - 1 - __builtin_clz(x);
+#else
+        int bit = 0;
+        while (x >>= 1)
+            ++bit;
+        return bit;
+#endif
+    }
+
+    int get_bucket_no(unsigned int key) const {
+        if (key == last_key)
+            return 0;
+        return get_highest_bit(key ^ last_key) + 1;
+    }
+
+    void refill_first_bucket() {
+        int bucket_no = 1;
+        while (buckets[bucket_no].empty())
+            ++bucket_no;
+        std::vector<Entry> &bucket = buckets[bucket_no];
+        unsigned int min_key = std::numeric_limits<unsigned int>::max();
+        for (const Entry &entry : bucket) {
+            min_key = std::min(min_key, static_cast<unsigned int>(entry.first));
+        }
+        last_key = min_key;
+        // All entries move to buckets with a smaller number.
+        for (const Entry &entry : bucket) {
+            int new_bucket_no = get_bucket_no(entry.first);
+            assert(new_bucket_no < bucket_no);
+            buckets[new_bucket_no].push_back(entry);
+        }
+        bucket.clear();
+    }
+public:
+    RadixHeap()
+        : buckets(NUM_BUCKETS),
+          last_key(0),
+          num_entries(0) {
+    }
+
+    void push(int key, const Value &value) {
+        assert(key >= 0 && static_cast<unsigned int>(key) >= last_key);
+        buckets[get_bucket_no(key)].emplace_back(key, value);
+        ++num_entries;
+    }
+
+    Entry pop() {
+        assert(num_entries > 0);
+        if (buckets[0].empty())
+            refill_first_bucket();
+        Entry entry = buckets[0].back();
+        buckets[0].pop_back();
+        --num_entries;
+        return entry;
+    }
+
+    bool empty() const {
+        return num_entries == 0;
+    }
+
+    void clear() {
+        for (std::vector<Entry> &bucket : buckets)
+            bucket.clear();
+        last_key = 0;
+        num_entries = 0;
+    }
+};
+
+
+/*
+  Monotone queue for Dijkstra's algorithm that uses breadth-first search if
+  all edge costs are 0 or 1, Dial's algorithm if the maximal edge cost is
+  at most MAX_DIAL_COST and a radix heap otherwise.
+*/
+template<typename Value>
+class MonotoneQueue {
+    static const int MAX_DIAL_COST = 1000;
+
+    enum class Type {
+        ZERO_ONE,
+        DIAL,
+        RADIX
+    };
+
+    Type type;
+    ZeroOneQueue<Value> zero_one_queue;
+    DialQueue<Value> dial_queue;
+    RadixHeap<Value> radix_heap;
+
+    static Type get_type(int max_cost) {
+        if (max_cost <= 1)
+            return Type::ZERO_ONE;
+        else if (max_cost <= MAX_DIAL_COST)
+            return Type::DIAL;
+        else
+            return Type::RADIX;
+    }
+public:
+    typedef std::pair<int, Value> Entry;
+
+    /*
+      max_cost is the maximal finite edge cost. Edges with infinite cost
+      must not be relaxed by the caller.
+    */
+    explicit MonotoneQueue(int max_cost)
+        : type(get_type(max_cost)),
+          dial_queue(type == Type::DIAL ? max_cost : 0) {
+        assert(max_cost >= 0);
+    }
+
+    void push(int key, const Value &value) {
+        switch (type) {
+        case Type::ZERO_ONE:
+            zero_one_queue.push(key, value);
+            break;
+        case Type::DIAL:
+            dial_queue.push(key, value);
+            break;
+        case Type::RADIX:
+            radix_heap.push(key, value);
+            break;
+        }
+    }
+
+    Entry pop() {
+        switch (type) {
+        case Type::ZERO_ONE:
+            return zero_one_queue.pop();
+        case Type::DIAL:
+            return dial_queue.pop();
+        default:
+            return radix_heap.pop();
+        }
+    }
+
+    bool empty() const {
+        switch (type) {
+        case Type::ZERO_ONE:
+            return zero_one_queue.empty();
+        case Type::DIAL:
+            return dial_queue.empty();
+        default:
+            return radix_heap.empty();
+        }
+    }
+
+    void clear() {
+        zero_one_queue.clear();
+        dial_queue.clear();
+        radix_heap.clear();
+    }
+
+    const char *get_name() const {
+        switch (type) {
+        case Type::ZERO_ONE:
+            return "breadth-first search";
+        case Type::DIAL:
+            return "bucket queue";
+        default:
+            return "radix heap";
+        }
+    }
+};
+}
+
+#endif
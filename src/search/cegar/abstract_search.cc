@@ -4,8 +4,10 @@
 #include "transition_system.h"
 #include "utils.h"
 
+#include "../algorithms/monotone_priority_queues.h"
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -13,153 +15,220 @@ using namespace std;
 namespace cegar {
 AbstractSearch::AbstractSearch(
     const vector<int> &operator_costs)
-    : operator_costs(operator_costs),
-      search_info(1) {
+    : operator_costs(operator_costs) {
 }
 
-void AbstractSearch::reset(int num_states) {
-    open_queue.clear();
-    search_info.resize(num_states);
-    for (AbstractSearchInfo &info : search_info) {
-        info.reset();
-    }
+int AbstractSearch::add_costs(int cost, int distance) const {
+    assert(cost >= 0 && distance >= 0);
+    if (cost == INF || distance == INF)
+        return INF;
+    return cost + distance;
 }
 
-unique_ptr<Solution> AbstractSearch::extract_solution(int init_id, int goal_id) const {
-    unique_ptr<Solution> solution = utils::make_unique_ptr<Solution>();
-    int current_id = goal_id;
-    while (current_id != init_id) {
-        const Transition &prev = search_info[current_id].get_incoming_transition();
-        solution->emplace_front(prev.op_id, current_id);
-        assert(prev.target_id != current_id);
-        current_id = prev.target_id;
+void AbstractSearch::mark_dirty(int state_id) {
+    if (!dirty[state_id]) {
+        dirty[state_id] = true;
+        dirty_states.push_back(state_id);
     }
-    return solution;
 }
 
-void AbstractSearch::update_goal_distances(const Solution &solution) {
-    /*
-      Originally, we only updated the goal distances of states that are part of
-      the trace (see Seipp and Helmert, JAIR 2018). The code below generalizes
-      this idea and potentially updates the goal distances of all states.
+void AbstractSearch::mark_dirty_ancestors(const TransitionLists &incoming) {
+    // The loop adds states to dirty_states, so we can't use iterators.
+    for (size_t i = 0; i < dirty_states.size(); ++i) {
+        int state_id = dirty_states[i];
+        for (const Transition &transition : incoming[state_id]) {
+            int pred_id = transition.target_id;
+            if (shortest_path[pred_id].target_id == state_id) {
+                mark_dirty(pred_id);
+            }
+        }
+    }
+}
 
-      Let C* be the cost of the trace and g(s) be the g value of states s when
-      A* finds the trace. Then for all states s with g(s) < INF (i.e., s has
-      been reached by the search), C*-g(s) is a lower bound on the goal
-      distance. This is the case since
+void AbstractSearch::repair_dirty_states(
+    const TransitionLists &incoming,
+    const TransitionLists &outgoing) {
+    for (int state_id : dirty_states) {
+        goal_distances[state_id] = INF;
+        shortest_path[state_id] = Transition(UNDEFINED, UNDEFINED);
+    }
 
-      g(s) >= g*(s) [1]
+    // The goal distances of all other states are correct.
+    assert(open_queue.empty());
+    for (int state_id : dirty_states) {
+        for (const Transition &transition : outgoing[state_id]) {
+            int succ_id = transition.target_id;
+            if (dirty[succ_id])
+                continue;
+            int distance = add_costs(
+                operator_costs[transition.op_id], goal_distances[succ_id]);
+            if (distance < goal_distances[state_id]) {
+                goal_distances[state_id] = distance;
+                shortest_path[state_id] = transition;
+            }
+        }
+        if (goal_distances[state_id] != INF) {
+            open_queue.push(goal_distances[state_id], state_id);
+        }
+    }
 
-      and
+    while (!open_queue.empty()) {
+        pair<int, int> top_pair = open_queue.pop();
+        int old_distance = top_pair.first;
+        int state_id = top_pair.second;
 
-          f*(s) >= C*         (optimality of A* with an admissible heuristic)
-      ==> g*(s) + h*(s) >= C* (definition of f values)
-      ==> g(s) + h*(s) >= C*  (using [1])
-      ==> h*(s) >= C* - g(s)  (arithmetic)
+        const int distance = goal_distances[state_id];
+        assert(0 <= distance && distance < INF);
+        assert(distance <= old_distance);
+        if (distance < old_distance)
+            continue;
+        for (const Transition &transition : incoming[state_id]) {
+            int pred_id = transition.target_id;
+            if (!dirty[pred_id])
+                continue;
+            int pred_distance = add_costs(
+                operator_costs[transition.op_id], distance);
+            if (pred_distance < goal_distances[pred_id]) {
+                goal_distances[pred_id] = pred_distance;
+                shortest_path[pred_id] = Transition(transition.op_id, state_id);
+                open_queue.push(pred_distance, pred_id);
+            }
+        }
+    }
 
-      Together with our existing lower bound h*(s) >= h(s), i.e., the h values
-      from the last iteration, for each abstract state s with g(s) < INF, we
-      can set h(s) = max(h(s), C*-g(s)).
-    */
-    int solution_cost = 0;
-    for (const Transition &transition : solution) {
-        solution_cost += operator_costs[transition.op_id];
+    for (int state_id : dirty_states) {
+        dirty[state_id] = false;
     }
-    for (auto &info : search_info) {
-        if (info.get_g_value() < INF) {
-            int new_h = max(info.get_h_value(), solution_cost - info.get_g_value());
-            info.increase_h_value_to(new_h);
+    dirty_states.clear();
+}
+
+bool AbstractSearch::test_distances(
+    const TransitionLists &incoming, const Goals &goals) const {
+    if (compute_distances(incoming, operator_costs, goals) != goal_distances)
+        return false;
+    for (size_t state_id = 0; state_id < goal_distances.size(); ++state_id) {
+        const Transition &path = shortest_path[state_id];
+        if (goal_distances[state_id] == INF || goals.count(state_id)) {
+            if (path.op_id != UNDEFINED)
+                return false;
+        } else if (add_costs(operator_costs[path.op_id],
+                             goal_distances[path.target_id]) !=
+                   goal_distances[state_id]) {
+            return false;
         }
     }
+    return true;
 }
 
-unique_ptr<Solution> AbstractSearch::find_solution(
-    const vector<Transitions> &transitions,
-    int init_id,
-    const Goals &goal_ids) {
-    reset(transitions.size());
-    search_info[init_id].decrease_g_value_to(0);
-    open_queue.push(search_info[init_id].get_h_value(), init_id);
-    int goal_id = astar_search(transitions, goal_ids);
-    open_queue.clear();
-    bool has_found_solution = (goal_id != UNDEFINED);
-    if (has_found_solution) {
-        unique_ptr<Solution> solution = extract_solution(init_id, goal_id);
-        update_goal_distances(*solution);
-        return solution;
-    } else {
-        search_info[init_id].increase_h_value_to(INF);
+void AbstractSearch::recompute(
+    const TransitionLists &incoming,
+    const TransitionLists &outgoing,
+    const Goals &goals) {
+    int num_states = incoming.size();
+    goal_distances.assign(num_states, 0);
+    shortest_path.assign(num_states, Transition(UNDEFINED, UNDEFINED));
+    dirty.assign(num_states, false);
+    for (int state_id = 0; state_id < num_states; ++state_id) {
+        if (!goals.count(state_id)) {
+            mark_dirty(state_id);
+        }
     }
-    return nullptr;
+    repair_dirty_states(incoming, outgoing);
+    assert(test_distances(incoming, goals));
 }
 
-int AbstractSearch::astar_search(
-    const vector<Transitions> &transitions, const Goals &goals) {
-    while (!open_queue.empty()) {
-        pair<int, int> top_pair = open_queue.pop();
-        int old_f = top_pair.first;
-        int state_id = top_pair.second;
+void AbstractSearch::update_incrementally(
+    const TransitionLists &incoming,
+    const TransitionLists &outgoing,
+    const Goals &goals,
+    int v1_id,
+    int v2_id) {
+    assert(v2_id == static_cast<int>(goal_distances.size()));
+    assert(incoming.size() == goal_distances.size() + 1);
+    // Goal distances only increase, so v1 and v2 start with the values of v.
+    int old_distance = goal_distances[v1_id];
+    goal_distances.push_back(old_distance);
+    shortest_path.push_back(shortest_path[v1_id]);
+    dirty.push_back(false);
 
-        const int g = search_info[state_id].get_g_value();
-        assert(0 <= g && g < INF);
-        int new_f = g + search_info[state_id].get_h_value();
-        assert(new_f <= old_f);
-        if (new_f < old_f)
-            continue;
+    // No shortest path leads through a dead end.
+    if (old_distance == INF)
+        return;
+
+    // Keep the shortest path of v for v1 and v2 if it is still available.
+    for (int state_id : {v1_id, v2_id}) {
         if (goals.count(state_id)) {
-            return state_id;
+            assert(old_distance == 0);
+            continue;
         }
-        assert(utils::in_bounds(state_id, transitions));
-        for (const Transition &transition : transitions[state_id]) {
-            int op_id = transition.op_id;
-            int succ_id = transition.target_id;
-
-            assert(utils::in_bounds(op_id, operator_costs));
-            const int op_cost = operator_costs[op_id];
-            assert(op_cost >= 0);
-            int succ_g = (op_cost == INF) ? INF : g + op_cost;
-            assert(succ_g >= 0);
+        const Transition &path = shortest_path[state_id];
+        ArrayView<Transition> transitions = outgoing[state_id];
+        if (path.op_id == UNDEFINED ||
+            find(transitions.begin(), transitions.end(), path) == transitions.end()) {
+            mark_dirty(state_id);
+        }
+    }
 
-            if (succ_g < search_info[succ_id].get_g_value()) {
-                search_info[succ_id].decrease_g_value_to(succ_g);
-                int h = search_info[succ_id].get_h_value();
-                if (h == INF)
-                    continue;
-                int f = succ_g + h;
-                assert(f >= 0);
-                assert(f != INF);
-                open_queue.push(f, succ_id);
-                search_info[succ_id].set_incoming_transition(Transition(op_id, state_id));
+    /*
+      The shortest paths of the predecessors of v now lead to v1, to v2 or
+      to both states. If the goal distance of v2 is still correct, we can use
+      it for all predecessors that reach v2 with the operator of their
+      shortest path. Otherwise, predecessors that only reach v2 need to be
+      repaired.
+    */
+    for (const Transition &transition : incoming[v2_id]) {
+        int pred_id = transition.target_id;
+        Transition &path = shortest_path[pred_id];
+        if (path.target_id != v1_id || path.op_id != transition.op_id)
+            continue;
+        if (!dirty[v2_id]) {
+            path.target_id = v2_id;
+        } else {
+            ArrayView<Transition> transitions = outgoing[pred_id];
+            if (find(transitions.begin(), transitions.end(), path) ==
+                transitions.end()) {
+                mark_dirty(pred_id);
             }
         }
     }
-    return UNDEFINED;
-}
 
-int AbstractSearch::get_h_value(int state_id) const {
-    assert(utils::in_bounds(state_id, search_info));
-    return search_info[state_id].get_h_value();
+    mark_dirty_ancestors(incoming);
+    repair_dirty_states(incoming, outgoing);
+    assert(!DEBUG || test_distances(incoming, goals));
 }
 
-void AbstractSearch::set_h_value(int state_id, int h) {
-    assert(utils::in_bounds(state_id, search_info));
-    search_info[state_id].increase_h_value_to(h);
+unique_ptr<Solution> AbstractSearch::find_solution(
+    int init_id, const Goals &goal_ids) const {
+    if (goal_distances[init_id] == INF)
+        return nullptr;
+    unique_ptr<Solution> solution = utils::make_unique_ptr<Solution>();
+    int current_id = init_id;
+    while (!goal_ids.count(current_id)) {
+        const Transition &transition = shortest_path[current_id];
+        assert(transition.op_id != UNDEFINED);
+        solution->push_back(transition);
+        current_id = transition.target_id;
+    }
+    return solution;
 }
 
-void AbstractSearch::copy_h_value_to_children(int v, int v1, int v2) {
-    int h = get_h_value(v);
-    search_info.resize(search_info.size() + 1);
-    set_h_value(v1, h);
-    set_h_value(v2, h);
+int AbstractSearch::get_h_value(int state_id) const {
+    assert(utils::in_bounds(state_id, goal_distances));
+    return goal_distances[state_id];
 }
 
 
 vector<int> compute_distances(
-    const vector<Transitions> &transitions,
+    const TransitionLists &transitions,
     const vector<int> &costs,
     const unordered_set<int> &start_ids) {
+    int max_cost = 0;
+    for (int cost : costs) {
+        if (cost != INF)
+            max_cost = max(max_cost, cost);
+    }
     vector<int> distances(transitions.size(), INF);
-    priority_queues::AdaptiveQueue<int> open_queue;
+    priority_queues::MonotoneQueue<int> open_queue(max_cost);
     for (int goal_id : start_ids) {
         distances[goal_id] = 0;
         open_queue.push(0, goal_id);
@@ -178,7 +247,9 @@ vector<int> compute_distances(
         for (const Transition &transition : transitions[state_id]) {
             const int op_cost = costs[transition.op_id];
             assert(op_cost >= 0);
-            int succ_g = (op_cost == INF) ? INF : g + op_cost;
+            if (op_cost == INF)
+                continue;
+            int succ_g = g + op_cost;
             assert(succ_g >= 0);
             int succ_id = transition.target_id;
             if (succ_g < distances[succ_id]) {
@@ -14,81 +14,74 @@ namespace cegar {
 using Solution = std::deque<Transition>;
 
 /*
-  Find abstract solutions using A*.
+  Maintain the goal distances of all abstract states together with a
+  shortest path to a goal for each state and extract abstract solutions
+  by following these paths.
+
+  After a split, only the states whose shortest path leads through the
+  split state may change their goal distance. We repair the distances of
+  these states with a backward Dijkstra search that starts from the
+  unaffected states (Speck and Seipp, ICAPS 2022).
 */
 class AbstractSearch {
-    class AbstractSearchInfo {
-        int g;
-        int h;
-        Transition incoming_transition;
-public:
-        AbstractSearchInfo()
-            : h(0),
-              incoming_transition(UNDEFINED, UNDEFINED) {
-            reset();
-        }
-
-        void reset() {
-            g = std::numeric_limits<int>::max();
-            incoming_transition = Transition(UNDEFINED, UNDEFINED);
-        }
-
-        void decrease_g_value_to(int new_g) {
-            assert(new_g <= g);
-            g = new_g;
-        }
-
-        int get_g_value() const {
-            return g;
-        }
-
-        void increase_h_value_to(int new_h) {
-            assert(new_h >= h);
-            h = new_h;
-        }
-
-        int get_h_value() const {
-            return h;
-        }
-
-        void set_incoming_transition(const Transition &transition) {
-            incoming_transition = transition;
-        }
-
-        const Transition &get_incoming_transition() const {
-            assert(incoming_transition.op_id != UNDEFINED &&
-                   incoming_transition.target_id != UNDEFINED);
-            return incoming_transition;
-        }
-    };
+    /*
+      Compare the distances to distances computed from scratch after each
+      incremental update (only in debug builds). This makes building an
+      abstraction quadratic in its size, so it is disabled by default.
+    */
+    static const bool DEBUG = false;
 
     const std::vector<int> operator_costs;
 
+    std::vector<int> goal_distances;
+    /* First transition on a shortest path to a goal for each state with a
+       finite goal distance that is not a goal state. */
+    std::vector<Transition> shortest_path;
+
     // Keep data structures around to avoid reallocating them.
     priority_queues::AdaptiveQueue<int> open_queue;
-    std::vector<AbstractSearchInfo> search_info;
-
-    void reset(int num_states);
-    void set_h_value(int state_id, int h);
-    std::unique_ptr<Solution> extract_solution(int init_id, int goal_id) const;
-    void update_goal_distances(const Solution &solution);
-    int astar_search(
-        const std::vector<Transitions> &transitions,
-        const Goals &goals);
+    std::vector<bool> dirty;
+    std::vector<int> dirty_states;
+
+    int add_costs(int cost, int distance) const;
+    void mark_dirty(int state_id);
+    void mark_dirty_ancestors(const TransitionLists &incoming);
+    void repair_dirty_states(
+        const TransitionLists &incoming,
+        const TransitionLists &outgoing);
+    bool test_distances(
+        const TransitionLists &incoming,
+        const Goals &goals) const;
 
 public:
     explicit AbstractSearch(const std::vector<int> &operator_costs);
 
+    // Compute the goal distances of all states from scratch.
+    void recompute(
+        const TransitionLists &incoming,
+        const TransitionLists &outgoing,
+        const Goals &goals);
+
+    /*
+      Update the goal distances after a state has been split into v1 and
+      v2, where v1 reuses the ID of the split state.
+    */
+    void update_incrementally(
+        const TransitionLists &incoming,
+        const TransitionLists &outgoing,
+        const Goals &goals,
+        int v1_id,
+        int v2_id);
+
+    // Return nullptr if no goal is reachable from the initial state.
     std::unique_ptr<Solution> find_solution(
-        const std::vector<Transitions> &transitions,
         int init_id,
-        const Goals &goal_ids);
+        const Goals &goal_ids) const;
     int get_h_value(int state_id) const;
-    void copy_h_value_to_children(int v, int v1, int v2);
 };
 
 std::vector<int> compute_distances(
-    const std::vector<Transitions> &transitions,
+    const TransitionLists &transitions,
     const std::vector<int> &costs,
     const std::unordered_set<int> &start_ids);
 }
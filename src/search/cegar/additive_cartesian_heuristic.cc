@@ -33,7 +33,8 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
         opts.get<bool>("use_general_costs"),
         opts.get<PickSplit>("pick"),
         *rng,
-        opts.get<bool>("debug"));
+        opts.get<bool>("debug"),
+        opts.get<int>("num_threads"));
     return cost_saturation.generate_heuristic_functions(
         opts.get<shared_ptr<AbstractTask>>("transform"));
 }
@@ -139,6 +140,15 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "debug",
         "print debugging output",
         "false");
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for refining subtasks concurrently. With more "
+        "than one thread, batches of subtasks are refined for the same "
+        "remaining costs, which usually yields a different (but still "
+        "admissible) heuristic than refining them one after the other. "
+        "Debugging output disables concurrent refinement.",
+        "1",
+        Bounds("1", "infinity"));
     Heuristic::add_options_to_parser(parser);
     utils::add_rng_options(parser);
     Options opts = parser.parse();
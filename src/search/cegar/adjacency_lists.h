@@ -0,0 +1,183 @@
+#ifndef CEGAR_ADJACENCY_LISTS_H
+#define CEGAR_ADJACENCY_LISTS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace cegar {
+/*
+  Read-only view of consecutively stored elements. Modifying the
+  AdjacencyLists that the elements belong to invalidates the view.
+*/
+template<typename T>
+class ArrayView {
+    const T *begin_;
+    const T *end_;
+public:
+    ArrayView(const T *begin, const T *end)
+        : begin_(begin), end_(end) {
+    }
+
+    const T *begin() const {
+        return begin_;
+    }
+
+    const T *end() const {
+        return end_;
+    }
+
+    const T &operator[](int index) const {
+        return begin_[index];
+    }
+
+    int size() const {
+        return end_ - begin_;
+    }
+
+    bool empty() const {
+        return begin_ == end_;
+    }
+};
+
+/*
+  Store one list of elements per abstract state in a single vector. Each
+  list occupies a segment of the vector that may have some spare capacity.
+  A full segment that needs to grow moves to the end of the vector, which
+  leaves a gap at its old position. We delete gaps lazily by compacting the
+  vector once they make up a quarter of it.
+
+  Compared to one std::vector per state, this saves the memory for the
+  vector objects and allocator headers and it bounds the spare capacity.
+*/
+template<typename T>
+class AdjacencyLists {
+    struct Segment {
+        int begin;
+        int size;
+        int capacity;
+
+        explicit Segment(int begin)
+            : begin(begin), size(0), capacity(0) {
+        }
+    };
+
+    std::vector<T> elements;
+    std::vector<Segment> segments;
+    // Number of elements in gaps between segments.
+    int num_unused;
+
+    // Avoid doubling the capacity of the vector like std::vector does.
+    void resize(int new_size, const T &filler) {
+        if (new_size > static_cast<int>(elements.capacity())) {
+            elements.reserve(new_size + new_size / 4);
+        }
+        elements.resize(new_size, filler);
+    }
+
+    // Give the segment room for more elements. The filler value is ignored.
+    void grow(Segment &segment, const T &filler) {
+        int new_capacity = segment.capacity + segment.capacity / 2 + 2;
+        int end = segment.begin + segment.capacity;
+        if (end == static_cast<int>(elements.size())) {
+            resize(segment.begin + new_capacity, filler);
+        } else {
+            int new_begin = elements.size();
+            resize(new_begin + new_capacity, filler);
+            std::copy(elements.begin() + segment.begin,
+                      elements.begin() + segment.begin + segment.size,
+                      elements.begin() + new_begin);
+            num_unused += segment.capacity;
+            segment.begin = new_begin;
+        }
+        segment.capacity = new_capacity;
+    }
+
+    void compact() {
+        std::vector<T> compacted;
+        compacted.reserve(elements.size() - num_unused);
+        for (Segment &segment : segments) {
+            int new_begin = compacted.size();
+            compacted.insert(
+                compacted.end(),
+                elements.begin() + segment.begin,
+                elements.begin() + segment.begin + segment.size);
+            segment.begin = new_begin;
+            segment.capacity = segment.size;
+        }
+        elements.swap(compacted);
+        num_unused = 0;
+    }
+
+public:
+    AdjacencyLists()
+        : num_unused(0) {
+    }
+
+    void add_list() {
+        segments.emplace_back(elements.size());
+    }
+
+    std::size_t size() const {
+        return segments.size();
+    }
+
+    ArrayView<T> operator[](int id) const {
+        const Segment &segment = segments[id];
+        const T *begin = elements.data() + segment.begin;
+        return ArrayView<T>(begin, begin + segment.size);
+    }
+
+    void push_back(int id, const T &element) {
+        Segment &segment = segments[id];
+        if (segment.size == segment.capacity) {
+            grow(segment, element);
+        }
+        elements[segment.begin + segment.size] = element;
+        ++segment.size;
+    }
+
+    // Remove the elements satisfying the predicate and return their number.
+    template<typename Predicate>
+    int remove_if(int id, Predicate pred) {
+        Segment &segment = segments[id];
+        auto begin = elements.begin() + segment.begin;
+        auto end = begin + segment.size;
+        int num_removed = end - std::remove_if(begin, end, pred);
+        segment.size -= num_removed;
+        return num_removed;
+    }
+
+    void clear(int id) {
+        Segment &segment = segments[id];
+        if (segment.begin + segment.capacity == static_cast<int>(elements.size())) {
+            elements.erase(elements.begin() + segment.begin, elements.end());
+        } else {
+            num_unused += segment.capacity;
+        }
+        segment = Segment(elements.size());
+    }
+
+    void compact_if_fragmented() {
+        if (num_unused > static_cast<int>(elements.size()) / 4) {
+            compact();
+        }
+    }
+
+    // Number of allocated elements that belong to no list.
+    int get_num_unused_elements() const {
+        int num_used = 0;
+        for (const Segment &segment : segments) {
+            num_used += segment.size;
+        }
+        return elements.capacity() - num_used;
+    }
+
+    std::size_t estimate_memory_in_bytes() const {
+        return elements.capacity() * sizeof(T) +
+               segments.capacity() * sizeof(Segment);
+    }
+};
+}
+
+#endif
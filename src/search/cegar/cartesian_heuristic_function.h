@@ -1,6 +1,8 @@
 #ifndef CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 #define CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 
+#include "flat_refinement_hierarchy.h"
+
 #include <memory>
 #include <vector>
 
@@ -9,13 +11,12 @@ class State;
 namespace cegar {
 class RefinementHierarchy;
 /*
-  Store RefinementHierarchy and heuristic values for looking up abstract state
-  IDs and corresponding heuristic values efficiently.
+  Compile RefinementHierarchy and heuristic values into a
+  FlatRefinementHierarchy for looking up heuristic values efficiently.
 */
 class CartesianHeuristicFunction {
     // Avoid const to enable moving.
-    std::unique_ptr<RefinementHierarchy> refinement_hierarchy;
-    std::vector<int> h_values;
+    FlatRefinementHierarchy refinement_hierarchy;
 
 public:
     CartesianHeuristicFunction(
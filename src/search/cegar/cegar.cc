@@ -84,8 +84,8 @@ CEGAR::CEGAR(
     int max_non_looping_transitions,
     double max_time,
     PickSplit pick,
-    utils::RandomNumberGenerator &rng,
-    bool debug)
+    bool debug,
+    utils::Verbosity verbosity)
     : task_proxy(*task),
       domain_sizes(get_domain_sizes(task_proxy)),
       max_states(max_states),
@@ -94,22 +94,30 @@ CEGAR::CEGAR(
       abstraction(utils::make_unique_ptr<Abstraction>(task, debug)),
       abstract_search(task_properties::get_operator_costs(task_proxy)),
       timer(max_time),
-      debug(debug) {
+      debug(debug),
+      verbosity(verbosity) {
     assert(max_states >= 1);
-    utils::g_log << "Start building abstraction." << endl;
-    utils::g_log << "Maximum number of states: " << max_states << endl;
-    utils::g_log << "Maximum number of transitions: "
-                 << max_non_looping_transitions << endl;
-    refinement_loop(rng);
-    utils::g_log << "Done building abstraction." << endl;
-    utils::g_log << "Time for building abstraction: " << timer.get_elapsed_time() << endl;
-
-    print_statistics();
 }
 
 CEGAR::~CEGAR() {
 }
 
+void CEGAR::build_abstraction(utils::RandomNumberGenerator &rng) {
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        utils::g_log << "Start building abstraction." << endl;
+        utils::g_log << "Maximum number of states: " << max_states << endl;
+        utils::g_log << "Maximum number of transitions: "
+                     << max_non_looping_transitions << endl;
+    }
+    refinement_loop(rng);
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        utils::g_log << "Done building abstraction." << endl;
+        utils::g_log << "Time for building abstraction: "
+                     << timer.get_elapsed_time() << endl;
+        print_statistics();
+    }
+}
+
 unique_ptr<Abstraction> CEGAR::extract_abstraction() {
     assert(abstraction);
     return move(abstraction);
@@ -139,17 +147,22 @@ void CEGAR::separate_facts_unreachable_before_goal() {
 }
 
 bool CEGAR::may_keep_refining() const {
+    bool log = verbosity >= utils::Verbosity::NORMAL;
     if (abstraction->get_num_states() >= max_states) {
-        utils::g_log << "Reached maximum number of states." << endl;
+        if (log)
+            utils::g_log << "Reached maximum number of states." << endl;
         return false;
     } else if (abstraction->get_transition_system().get_num_non_loops() >= max_non_looping_transitions) {
-        utils::g_log << "Reached maximum number of transitions." << endl;
+        if (log)
+            utils::g_log << "Reached maximum number of transitions." << endl;
         return false;
     } else if (timer.is_expired()) {
-        utils::g_log << "Reached time limit." << endl;
+        if (log)
+            utils::g_log << "Reached time limit." << endl;
         return false;
     } else if (!utils::extra_memory_padding_is_reserved()) {
-        utils::g_log << "Reached memory limit." << endl;
+        if (log)
+            utils::g_log << "Reached memory limit." << endl;
         return false;
     }
     return true;
@@ -167,19 +180,26 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
         separate_facts_unreachable_before_goal();
     }
 
-    utils::Timer find_trace_timer(false);
+    utils::Timer find_trace_timer;
     utils::Timer find_flaw_timer(false);
     utils::Timer refine_timer(false);
 
+    const TransitionSystem &transition_system = abstraction->get_transition_system();
+    abstract_search.recompute(
+        transition_system.get_incoming_transitions(),
+        transition_system.get_outgoing_transitions(),
+        abstraction->get_goals());
+    find_trace_timer.stop();
+
     while (may_keep_refining()) {
         find_trace_timer.resume();
         unique_ptr<Solution> solution = abstract_search.find_solution(
-            abstraction->get_transition_system().get_outgoing_transitions(),
             abstraction->get_initial_state().get_id(),
             abstraction->get_goals());
         find_trace_timer.stop();
         if (!solution) {
-            utils::g_log << "Abstract task is unsolvable." << endl;
+            if (verbosity >= utils::Verbosity::NORMAL)
+                utils::g_log << "Abstract task is unsolvable." << endl;
             break;
         }
 
@@ -187,30 +207,38 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
         unique_ptr<Flaw> flaw = find_flaw(*solution);
         find_flaw_timer.stop();
         if (!flaw) {
-            utils::g_log << "Found concrete solution during refinement." << endl;
+            if (verbosity >= utils::Verbosity::NORMAL)
+                utils::g_log << "Found concrete solution during refinement." << endl;
             break;
         }
 
         refine_timer.resume();
         const AbstractState &abstract_state = flaw->current_abstract_state;
-        int state_id = abstract_state.get_id();
         vector<Split> splits = flaw->get_possible_splits();
         const Split &split = split_selector.pick_split(abstract_state, splits, rng);
         auto new_state_ids = abstraction->refine(abstract_state, split.var_id, split.values);
-        // Since h-values only increase we can assign the h-value to the children.
-        abstract_search.copy_h_value_to_children(
-            state_id, new_state_ids.first, new_state_ids.second);
         refine_timer.stop();
 
-        if (abstraction->get_num_states() % 1000 == 0) {
+        find_trace_timer.resume();
+        abstract_search.update_incrementally(
+            transition_system.get_incoming_transitions(),
+            transition_system.get_outgoing_transitions(),
+            abstraction->get_goals(),
+            new_state_ids.first, new_state_ids.second);
+        find_trace_timer.stop();
+
+        if (verbosity >= utils::Verbosity::NORMAL &&
+            abstraction->get_num_states() % 1000 == 0) {
             utils::g_log << abstraction->get_num_states() << "/" << max_states << " states, "
                          << abstraction->get_transition_system().get_num_non_loops() << "/"
                          << max_non_looping_transitions << " transitions" << endl;
         }
     }
-    utils::g_log << "Time for finding abstract traces: " << find_trace_timer << endl;
-    utils::g_log << "Time for finding flaws: " << find_flaw_timer << endl;
-    utils::g_log << "Time for splitting states: " << refine_timer << endl;
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        utils::g_log << "Time for finding abstract traces: " << find_trace_timer << endl;
+        utils::g_log << "Time for finding flaws: " << find_flaw_timer << endl;
+        utils::g_log << "Time for splitting states: " << refine_timer << endl;
+    }
 }
 
 unique_ptr<Flaw> CEGAR::find_flaw(const Solution &solution) {
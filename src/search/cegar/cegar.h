@@ -12,6 +12,7 @@
 
 namespace utils {
 class RandomNumberGenerator;
+enum class Verbosity;
 }
 
 namespace cegar {
@@ -40,6 +41,7 @@ class CEGAR {
     utils::CountdownTimer timer;
 
     const bool debug;
+    const utils::Verbosity verbosity;
 
     bool may_keep_refining() const;
 
@@ -57,24 +59,34 @@ class CEGAR {
        first encountered flaw or nullptr if there is no flaw. */
     std::unique_ptr<Flaw> find_flaw(const Solution &solution);
 
-    // Build abstraction.
     void refinement_loop(utils::RandomNumberGenerator &rng);
 
-    void print_statistics();
-
 public:
+    /*
+      Set up the refinement of the given task. The time limit starts
+      with the construction.
+    */
     CEGAR(
         const std::shared_ptr<AbstractTask> &task,
         int max_states,
         int max_non_looping_transitions,
         double max_time,
         PickSplit pick,
-        utils::RandomNumberGenerator &rng,
-        bool debug);
+        bool debug,
+        utils::Verbosity verbosity);
     ~CEGAR();
 
     CEGAR(const CEGAR &) = delete;
 
+    /*
+      Build the abstraction. Without output (verbosity SILENT), this method
+      only reads shared data, so abstractions of different CEGAR objects can
+      be built concurrently.
+    */
+    void build_abstraction(utils::RandomNumberGenerator &rng);
+
+    void print_statistics();
+
     std::unique_ptr<Abstraction> extract_abstraction();
 };
 }
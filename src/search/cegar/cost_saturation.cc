@@ -14,9 +14,13 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
+#include "../utils/rng.h"
+#include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace std;
 
@@ -89,7 +93,8 @@ CostSaturation::CostSaturation(
     bool use_general_costs,
     PickSplit pick_split,
     utils::RandomNumberGenerator &rng,
-    bool debug)
+    bool debug,
+    int num_threads)
     : subtask_generators(subtask_generators),
       max_states(max_states),
       max_non_looping_transitions(max_non_looping_transitions),
@@ -98,6 +103,7 @@ CostSaturation::CostSaturation(
       pick_split(pick_split),
       rng(rng),
       debug(debug),
+      num_threads(num_threads),
       num_abstractions(0),
       num_states(0),
       num_non_looping_transitions(0) {
@@ -187,56 +193,108 @@ bool CostSaturation::state_is_dead_end(const State &state) const {
     return false;
 }
 
+void CostSaturation::build_abstractions_in_parallel(
+    const vector<unique_ptr<CEGAR>> &cegars) {
+    // Each thread gets its own generator since the shared one is not thread-safe.
+    int num_cegars = cegars.size();
+    vector<unique_ptr<utils::RandomNumberGenerator>> rngs;
+    rngs.reserve(num_cegars);
+    for (int i = 0; i < num_cegars; ++i) {
+        rngs.push_back(utils::make_unique_ptr<utils::RandomNumberGenerator>(
+                           rng(numeric_limits<int>::max())));
+    }
+
+    utils::process_jobs_in_parallel(
+        num_cegars, num_threads,
+        [&](int, int i) {
+            cegars[i]->build_abstraction(*rngs[i]);
+        });
+}
+
 void CostSaturation::build_abstractions(
     const vector<shared_ptr<AbstractTask>> &subtasks,
     const utils::CountdownTimer &timer,
     function<bool()> should_abort) {
+    /*
+      Debug output is written while refining, so we only build abstractions
+      concurrently without it.
+    */
+    int batch_size = debug ? 1 : num_threads;
     int rem_subtasks = subtasks.size();
-    for (shared_ptr<AbstractTask> subtask : subtasks) {
-        subtask = get_remaining_costs_task(subtask);
+    for (size_t batch_start = 0; batch_start < subtasks.size();
+         batch_start += batch_size) {
+        int num_cegars = min(batch_size, rem_subtasks);
+        bool parallel = num_cegars > 1;
+        utils::Verbosity verbosity =
+            parallel ? utils::Verbosity::SILENT : utils::Verbosity::NORMAL;
 
+        /*
+          All abstractions of a batch share the limits of the remaining
+          subtasks equally. Since timers measure the CPU time of all
+          threads, each abstraction may use the time of the whole batch.
+        */
         assert(num_states < max_states);
-        CEGAR cegar(
-            subtask,
-            max(1, (max_states - num_states) / rem_subtasks),
-            max(1, (max_non_looping_transitions - num_non_looping_transitions) /
-                rem_subtasks),
-            timer.get_remaining_time() / rem_subtasks,
-            pick_split,
-            rng,
-            debug);
-
-        unique_ptr<Abstraction> abstraction = cegar.extract_abstraction();
-        ++num_abstractions;
-        num_states += abstraction->get_num_states();
-        num_non_looping_transitions += abstraction->get_transition_system().get_num_non_loops();
-        assert(num_states <= max_states);
-
-        vector<int> costs = task_properties::get_operator_costs(TaskProxy(*subtask));
-        vector<int> init_distances = compute_distances(
-            abstraction->get_transition_system().get_outgoing_transitions(),
-            costs,
-            {abstraction->get_initial_state().get_id()});
-        vector<int> goal_distances = compute_distances(
-            abstraction->get_transition_system().get_incoming_transitions(),
-            costs,
-            abstraction->get_goals());
-        vector<int> saturated_costs = compute_saturated_costs(
-            abstraction->get_transition_system(),
-            init_distances,
-            goal_distances,
-            use_general_costs);
-
-        heuristic_functions.emplace_back(
-            abstraction->extract_refinement_hierarchy(),
-            move(goal_distances));
-
-        reduce_remaining_costs(saturated_costs);
-
-        if (should_abort())
-            break;
+        vector<unique_ptr<CEGAR>> cegars;
+        for (int i = 0; i < num_cegars; ++i) {
+            shared_ptr<AbstractTask> subtask = subtasks[batch_start + i];
+            cegars.push_back(utils::make_unique_ptr<CEGAR>(
+                                 get_remaining_costs_task(subtask),
+                                 max(1, (max_states - num_states) / rem_subtasks),
+                                 max(1, (max_non_looping_transitions -
+                                         num_non_looping_transitions) / rem_subtasks),
+                                 timer.get_remaining_time() / rem_subtasks * num_cegars,
+                                 pick_split,
+                                 debug,
+                                 verbosity));
+        }
+        if (parallel) {
+            build_abstractions_in_parallel(cegars);
+        } else {
+            cegars[0]->build_abstraction(rng);
+        }
 
-        --rem_subtasks;
+        for (const unique_ptr<CEGAR> &cegar : cegars) {
+            if (parallel) {
+                cegar->print_statistics();
+            }
+            unique_ptr<Abstraction> abstraction = cegar->extract_abstraction();
+            ++num_abstractions;
+            num_states += abstraction->get_num_states();
+            num_non_looping_transitions += abstraction->get_transition_system().get_num_non_loops();
+            assert(num_states <= max_states);
+
+            /*
+              Abstractions from a batch are built for the same costs, so we
+              use the costs that remain after saturating the previous ones.
+            */
+            utils::Timer distances_timer;
+            vector<int> init_distances = compute_distances(
+                abstraction->get_transition_system().get_outgoing_transitions(),
+                remaining_costs,
+                {abstraction->get_initial_state().get_id()});
+            vector<int> goal_distances = compute_distances(
+                abstraction->get_transition_system().get_incoming_transitions(),
+                remaining_costs,
+                abstraction->get_goals());
+            utils::g_log << "Time for computing abstract distances: "
+                         << distances_timer << endl;
+            vector<int> saturated_costs = compute_saturated_costs(
+                abstraction->get_transition_system(),
+                init_distances,
+                goal_distances,
+                use_general_costs);
+
+            heuristic_functions.emplace_back(
+                abstraction->extract_refinement_hierarchy(),
+                move(goal_distances));
+
+            reduce_remaining_costs(saturated_costs);
+
+            if (should_abort())
+                return;
+
+            --rem_subtasks;
+        }
     }
 }
 
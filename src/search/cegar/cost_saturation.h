@@ -15,6 +15,7 @@ class RandomNumberGenerator;
 
 namespace cegar {
 class CartesianHeuristicFunction;
+class CEGAR;
 class SubtaskGenerator;
 
 /*
@@ -23,6 +24,10 @@ class SubtaskGenerator;
   RefinementHierarchies from Abstractions to
   CartesianHeuristicFunctions, allow extracting
   CartesianHeuristicFunctions into AdditiveCartesianHeuristic.
+
+  With multiple threads, we refine batches of subtasks concurrently. All
+  abstractions of a batch are built for the remaining costs before the
+  batch and are then saturated one after the other in the given order.
 */
 class CostSaturation {
     const std::vector<std::shared_ptr<SubtaskGenerator>> subtask_generators;
@@ -33,6 +38,7 @@ class CostSaturation {
     const PickSplit pick_split;
     utils::RandomNumberGenerator &rng;
     const bool debug;
+    const int num_threads;
 
     std::vector<CartesianHeuristicFunction> heuristic_functions;
     std::vector<int> remaining_costs;
@@ -45,6 +51,8 @@ class CostSaturation {
     std::shared_ptr<AbstractTask> get_remaining_costs_task(
         std::shared_ptr<AbstractTask> &parent) const;
     bool state_is_dead_end(const State &state) const;
+    void build_abstractions_in_parallel(
+        const std::vector<std::unique_ptr<CEGAR>> &cegars);
     void build_abstractions(
         const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
         const utils::CountdownTimer &timer,
@@ -60,7 +68,8 @@ public:
         bool use_general_costs,
         PickSplit pick_split,
         utils::RandomNumberGenerator &rng,
-        bool debug);
+        bool debug,
+        int num_threads);
 
     std::vector<CartesianHeuristicFunction> generate_heuristic_functions(
         const std::shared_ptr<AbstractTask> &task);
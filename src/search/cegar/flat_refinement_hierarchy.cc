@@ -0,0 +1,178 @@
+#include "flat_refinement_hierarchy.h"
+
+#include "refinement_hierarchy.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/collections.h"
+
+#include <deque>
+
+using namespace std;
+
+namespace cegar {
+/*
+  Compile the hierarchy in two passes. The first pass finds the nodes whose
+  leaves all have the same value. The second pass lays out the remaining
+  nodes in breadth-first order.
+*/
+class HierarchyCompiler {
+    const vector<Node> &hierarchy_nodes;
+    vector<int> domain_sizes;
+
+    // Value of all leaves below each node if they agree, UNDEFINED otherwise.
+    vector<int> constant_value;
+    vector<int> offset;
+    deque<NodeID> queue;
+    vector<int> &nodes;
+
+    bool is_constant(NodeID id) const {
+        return constant_value[id] != UNDEFINED;
+    }
+
+    // Number of consecutive nodes that split off values of the same variable.
+    int get_chain_length(NodeID id) const {
+        int var = hierarchy_nodes[id].var;
+        int length = 0;
+        while (!is_constant(id) && hierarchy_nodes[id].is_split() &&
+               hierarchy_nodes[id].var == var) {
+            ++length;
+            id = hierarchy_nodes[id].left_child;
+        }
+        return length;
+    }
+
+    bool use_switch(NodeID id) const {
+        int test_size = 4 * get_chain_length(id);
+        return domain_sizes[hierarchy_nodes[id].var] + 1 <= test_size;
+    }
+
+    int get_size(NodeID id) const {
+        return use_switch(id) ? domain_sizes[hierarchy_nodes[id].var] + 1 : 4;
+    }
+
+    int get_entry(NodeID id) {
+        if (is_constant(id)) {
+            return ~constant_value[id];
+        }
+        if (offset[id] == UNDEFINED) {
+            offset[id] = nodes.size();
+            nodes.resize(nodes.size() + get_size(id), UNDEFINED);
+            queue.push_back(id);
+        }
+        return offset[id];
+    }
+
+    void compile_node(NodeID id) {
+        const Node &node = hierarchy_nodes[id];
+        int pos = offset[id];
+        if (use_switch(id)) {
+            int var = node.var;
+            nodes[pos] = var;
+            vector<NodeID> children(domain_sizes[var], UNDEFINED);
+            NodeID chain_id = id;
+            while (!is_constant(chain_id) && hierarchy_nodes[chain_id].is_split() &&
+                   hierarchy_nodes[chain_id].var == var) {
+                const Node &chain_node = hierarchy_nodes[chain_id];
+                assert(children[chain_node.value] == UNDEFINED);
+                children[chain_node.value] = chain_node.right_child;
+                chain_id = chain_node.left_child;
+            }
+            for (int value = 0; value < domain_sizes[var]; ++value) {
+                NodeID child = children[value];
+                // Calling get_entry may resize the vector, so do it first.
+                int entry = get_entry(child == UNDEFINED ? chain_id : child);
+                nodes[pos + 1 + value] = entry;
+            }
+        } else {
+            nodes[pos] = ~node.var;
+            nodes[pos + 1] = node.value;
+            int right_entry = get_entry(node.right_child);
+            nodes[pos + 2] = right_entry;
+            int left_entry = get_entry(node.left_child);
+            nodes[pos + 3] = left_entry;
+        }
+    }
+
+    void compute_constant_values(const vector<int> &leaf_values) {
+        // Visit the nodes in post-order.
+        vector<bool> expanded(hierarchy_nodes.size(), false);
+        vector<NodeID> stack = {0};
+        while (!stack.empty()) {
+            NodeID id = stack.back();
+            const Node &node = hierarchy_nodes[id];
+            if (!node.is_split()) {
+                stack.pop_back();
+                assert(utils::in_bounds(node.get_state_id(), leaf_values));
+                int value = leaf_values[node.get_state_id()];
+                assert(value >= 0);
+                constant_value[id] = value;
+            } else if (!expanded[id]) {
+                expanded[id] = true;
+                stack.push_back(node.left_child);
+                stack.push_back(node.right_child);
+            } else {
+                stack.pop_back();
+                int left_value = constant_value[node.left_child];
+                if (left_value == constant_value[node.right_child]) {
+                    constant_value[id] = left_value;
+                }
+            }
+        }
+    }
+
+public:
+    HierarchyCompiler(
+        const vector<Node> &hierarchy_nodes,
+        const AbstractTask &task,
+        const vector<int> &leaf_values,
+        vector<int> &nodes)
+        : hierarchy_nodes(hierarchy_nodes),
+          constant_value(hierarchy_nodes.size(), UNDEFINED),
+          offset(hierarchy_nodes.size(), UNDEFINED),
+          nodes(nodes) {
+        for (VariableProxy var : TaskProxy(task).get_variables()) {
+            domain_sizes.push_back(var.get_domain_size());
+        }
+        compute_constant_values(leaf_values);
+    }
+
+    int compile() {
+        int root = get_entry(0);
+        while (!queue.empty()) {
+            NodeID id = queue.front();
+            queue.pop_front();
+            compile_node(id);
+        }
+        return root;
+    }
+};
+
+
+FlatRefinementHierarchy::FlatRefinementHierarchy(
+    const RefinementHierarchy &hierarchy,
+    const vector<int> &leaf_values)
+    : task(hierarchy.task) {
+    HierarchyCompiler compiler(hierarchy.nodes, *task, leaf_values, nodes);
+    root = compiler.compile();
+    nodes.shrink_to_fit();
+}
+
+int FlatRefinementHierarchy::get_value(const State &state) const {
+    TaskProxy subtask_proxy(*task);
+    State subtask_state = subtask_proxy.convert_ancestor_state(state);
+    const vector<int> &values = subtask_state.get_unpacked_values();
+    int entry = root;
+    while (entry >= 0) {
+        int var = nodes[entry];
+        if (var >= 0) {
+            entry = nodes[entry + 1 + values[var]];
+        } else if (values[~var] == nodes[entry + 1]) {
+            entry = nodes[entry + 2];
+        } else {
+            entry = nodes[entry + 3];
+        }
+    }
+    return ~entry;
+}
+}
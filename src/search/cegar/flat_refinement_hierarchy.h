@@ -0,0 +1,49 @@
+#ifndef CEGAR_FLAT_REFINEMENT_HIERARCHY_H
+#define CEGAR_FLAT_REFINEMENT_HIERARCHY_H
+
+#include <memory>
+#include <vector>
+
+class AbstractTask;
+class State;
+
+namespace cegar {
+class RefinementHierarchy;
+
+/*
+  Read-only decision diagram compiled from a RefinementHierarchy that maps
+  states directly to values of the abstract states (e.g., goal distances).
+
+  All nodes are stored in a single vector in breadth-first order. A chain
+  of splits for the same variable becomes a single switch node with one
+  child per value if that is not larger than testing the values one after
+  the other. Subgraphs that map all states to the same value are replaced
+  by this value.
+*/
+class FlatRefinementHierarchy {
+    std::shared_ptr<AbstractTask> task;
+
+    /*
+      Entries are either node offsets (>= 0) or leaves (~value < 0).
+      A switch node for variable var is stored as
+        var, child for value 0, ..., child for value n - 1
+      and a test node as
+        ~var, value, child if var has the value, child otherwise.
+    */
+    std::vector<int> nodes;
+    int root;
+
+public:
+    /*
+      Compile the given hierarchy. The leaf of abstract state s gets the
+      value leaf_values[s]. All values must be non-negative.
+    */
+    FlatRefinementHierarchy(
+        const RefinementHierarchy &hierarchy,
+        const std::vector<int> &leaf_values);
+
+    int get_value(const State &state) const;
+};
+}
+
+#endif
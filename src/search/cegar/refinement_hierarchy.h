@@ -10,7 +10,6 @@
 #include <vector>
 
 class AbstractTask;
-class State;
 
 namespace cegar {
 class Node;
@@ -20,7 +19,8 @@ class Node;
   abstraction. The hierarchy forms a DAG with inner nodes for each
   split and leaf nodes for the abstract states.
 
-  It is used for efficient lookup of abstract states during search.
+  During search, we look up abstract states in a FlatRefinementHierarchy
+  compiled from this class.
 
   Inner nodes correspond to abstract states that have been split (or
   helper nodes, see below). Leaf nodes correspond to the current
@@ -32,7 +32,8 @@ class RefinementHierarchy {
     std::vector<Node> nodes;
 
     NodeID add_node(int state_id);
-    NodeID get_node_id(const State &state) const;
+
+    friend class FlatRefinementHierarchy;
 
 public:
     explicit RefinementHierarchy(const std::shared_ptr<AbstractTask> &task);
@@ -46,8 +47,6 @@ public:
     std::pair<NodeID, NodeID> split(
         NodeID node_id, int var, const std::vector<int> &values,
         int left_state_id, int right_state_id);
-
-    int get_abstract_state_id(const State &state) const;
 };
 
 
@@ -71,6 +70,8 @@ class Node {
 
     bool information_is_valid() const;
 
+    friend class HierarchyCompiler;
+
 public:
     explicit Node(int state_id);
 
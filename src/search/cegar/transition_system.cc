@@ -69,12 +69,12 @@ static int lookup_value(const vector<FactPair> &facts, int var) {
 }
 
 static void remove_transitions_with_given_target(
-    Transitions &transitions, int state_id) {
-    auto new_end = remove_if(
-        transitions.begin(), transitions.end(),
+    TransitionLists &transitions, int src_id, int state_id) {
+    int num_removed = transitions.remove_if(
+        src_id,
         [state_id](const Transition &t) {return t.target_id == state_id;});
-    assert(new_end != transitions.end());
-    transitions.erase(new_end, transitions.end());
+    assert(num_removed > 0);
+    utils::unused_variable(num_removed);
 }
 
 
@@ -95,10 +95,9 @@ int TransitionSystem::get_postcondition_value(int op_id, int var) const {
 }
 
 void TransitionSystem::enlarge_vectors_by_one() {
-    int new_num_states = get_num_states() + 1;
-    outgoing.resize(new_num_states);
-    incoming.resize(new_num_states);
-    loops.resize(new_num_states);
+    outgoing.add_list();
+    incoming.add_list();
+    loops.add_list();
 }
 
 void TransitionSystem::add_loops_in_trivial_abstraction() {
@@ -112,14 +111,14 @@ void TransitionSystem::add_loops_in_trivial_abstraction() {
 
 void TransitionSystem::add_transition(int src_id, int op_id, int target_id) {
     assert(src_id != target_id);
-    outgoing[src_id].emplace_back(op_id, target_id);
-    incoming[target_id].emplace_back(op_id, src_id);
+    outgoing.push_back(src_id, Transition(op_id, target_id));
+    incoming.push_back(target_id, Transition(op_id, src_id));
     ++num_non_loops;
 }
 
 void TransitionSystem::add_loop(int state_id, int op_id) {
     assert(utils::in_bounds(state_id, loops));
-    loops[state_id].push_back(op_id);
+    loops.push_back(state_id, op_id);
     ++num_loops;
 }
 
@@ -136,7 +135,7 @@ void TransitionSystem::rewire_incoming_transitions(
         int u_id = transition.target_id;
         bool is_new_state = updated_states.insert(u_id).second;
         if (is_new_state) {
-            remove_transitions_with_given_target(outgoing[u_id], v1_id);
+            remove_transitions_with_given_target(outgoing, u_id, v1_id);
         }
     }
     num_non_loops -= old_incoming.size();
@@ -181,7 +180,7 @@ void TransitionSystem::rewire_outgoing_transitions(
         int w_id = transition.target_id;
         bool is_new_state = updated_states.insert(w_id).second;
         if (is_new_state) {
-            remove_transitions_with_given_target(incoming[w_id], v1_id);
+            remove_transitions_with_given_target(incoming, w_id, v1_id);
         }
     }
     num_non_loops -= old_outgoing.size();
@@ -277,9 +276,12 @@ void TransitionSystem::rewire(
     const AbstractStates &states, int v_id,
     const AbstractState &v1, const AbstractState &v2, int var) {
     // Retrieve old transitions and make space for new transitions.
-    Transitions old_incoming = move(incoming[v_id]);
-    Transitions old_outgoing = move(outgoing[v_id]);
-    Loops old_loops = move(loops[v_id]);
+    Transitions old_incoming(incoming[v_id].begin(), incoming[v_id].end());
+    Transitions old_outgoing(outgoing[v_id].begin(), outgoing[v_id].end());
+    Loops old_loops(loops[v_id].begin(), loops[v_id].end());
+    incoming.clear(v_id);
+    outgoing.clear(v_id);
+    loops.clear(v_id);
     enlarge_vectors_by_one();
     int v1_id = v1.get_id();
     int v2_id = v2.get_id();
@@ -292,17 +294,21 @@ void TransitionSystem::rewire(
     rewire_incoming_transitions(old_incoming, states, v1, v2, var);
     rewire_outgoing_transitions(old_outgoing, states, v1, v2, var);
     rewire_loops(old_loops, v1, v2, var);
+
+    incoming.compact_if_fragmented();
+    outgoing.compact_if_fragmented();
+    loops.compact_if_fragmented();
 }
 
-const vector<Transitions> &TransitionSystem::get_incoming_transitions() const {
+const TransitionLists &TransitionSystem::get_incoming_transitions() const {
     return incoming;
 }
 
-const vector<Transitions> &TransitionSystem::get_outgoing_transitions() const {
+const TransitionLists &TransitionSystem::get_outgoing_transitions() const {
     return outgoing;
 }
 
-const vector<Loops> &TransitionSystem::get_loops() const {
+const AdjacencyLists<int> &TransitionSystem::get_loops() const {
     return loops;
 }
 
@@ -338,5 +344,14 @@ void TransitionSystem::print_statistics() const {
     assert(get_num_non_loops() == total_outgoing_transitions);
     utils::g_log << "Looping transitions: " << total_loops << endl;
     utils::g_log << "Non-looping transitions: " << total_outgoing_transitions << endl;
+    size_t memory = incoming.estimate_memory_in_bytes() +
+        outgoing.estimate_memory_in_bytes() + loops.estimate_memory_in_bytes();
+    int unused = incoming.get_num_unused_elements() +
+        outgoing.get_num_unused_elements();
+    utils::g_log << "Memory for transitions and self-loops in KB: "
+                 << memory / 1024 << endl;
+    utils::g_log << "Unused transition slots: " << unused << endl;
+    utils::g_log << "Unused self-loop slots: "
+                 << loops.get_num_unused_elements() << endl;
 }
 }
@@ -1,6 +1,8 @@
 #ifndef CEGAR_TRANSITION_SYSTEM_H
 #define CEGAR_TRANSITION_SYSTEM_H
 
+#include "adjacency_lists.h"
+#include "transition.h"
 #include "types.h"
 
 #include <vector>
@@ -11,17 +13,20 @@ class OperatorsProxy;
 namespace cegar {
 /*
   Rewire transitions after each split.
+
+  All transitions and self-loops are kept in AdjacencyLists, which store
+  the lists of all states contiguously.
 */
 class TransitionSystem {
     const std::vector<std::vector<FactPair>> preconditions_by_operator;
     const std::vector<std::vector<FactPair>> postconditions_by_operator;
 
     // Transitions from and to other abstract states.
-    std::vector<Transitions> incoming;
-    std::vector<Transitions> outgoing;
+    TransitionLists incoming;
+    TransitionLists outgoing;
 
     // Store self-loops (operator indices) separately to save space.
-    std::vector<Loops> loops;
+    AdjacencyLists<int> loops;
 
     int num_non_loops;
     int num_loops;
@@ -55,9 +60,9 @@ public:
         const AbstractStates &states, int v_id,
         const AbstractState &v1, const AbstractState &v2, int var);
 
-    const std::vector<Transitions> &get_incoming_transitions() const;
-    const std::vector<Transitions> &get_outgoing_transitions() const;
-    const std::vector<Loops> &get_loops() const;
+    const TransitionLists &get_incoming_transitions() const;
+    const TransitionLists &get_outgoing_transitions() const;
+    const AdjacencyLists<int> &get_loops() const;
 
     int get_num_states() const;
     int get_num_operators() const;
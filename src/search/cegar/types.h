@@ -8,6 +8,8 @@
 
 namespace cegar {
 class AbstractState;
+template<typename T>
+class AdjacencyLists;
 struct Transition;
 
 using AbstractStates = std::vector<std::unique_ptr<AbstractState>>;
@@ -15,6 +17,7 @@ using Goals = std::unordered_set<int>;
 using NodeID = int;
 using Loops = std::vector<int>;
 using Transitions = std::vector<Transition>;
+using TransitionLists = AdjacencyLists<Transition>;
 
 const int UNDEFINED = -1;
 
@@ -17,8 +17,33 @@ const int AdditiveHeuristic::MAX_COST_VALUE;
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      did_write_overflow_warning(false),
+      incremental(opts.get<bool>("incremental")) {
     utils::g_log << "Initializing additive heuristic..." << endl;
+    if (incremental) {
+        initialize_incremental_mode();
+    }
+}
+
+void AdditiveHeuristic::initialize_incremental_mode() {
+    vector<vector<OpID>> achievers_by_prop(propositions.size());
+    int num_unary_ops = unary_operators.size();
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        achievers_by_prop[get_operator_info(op_id).effect].push_back(op_id);
+    }
+    achievers.reserve(propositions.size());
+    num_achievers.reserve(propositions.size());
+    for (const vector<OpID> &prop_achievers : achievers_by_prop) {
+        achievers.push_back(achievers_pool.append(prop_achievers));
+        num_achievers.push_back(prop_achievers.size());
+    }
+
+    propagated_costs.assign(propositions.size(), -1);
+    precondition_cost_sums.assign(num_unary_ops, 0);
+    num_unreached_preconditions.reserve(num_unary_ops);
+    for (const UnaryOperatorInfo &op : unary_operator_infos) {
+        num_unreached_preconditions.push_back(op.num_preconditions);
+    }
 }
 
 void AdditiveHeuristic::write_overflow_warning() {
@@ -36,19 +61,12 @@ void AdditiveHeuristic::write_overflow_warning() {
 // heuristic computation
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
-
-    for (Proposition &prop : propositions) {
-        prop.cost = -1;
-        prop.marked = false;
-    }
+    reset_propositions_and_operators();
 
     // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, get_op_id(op));
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperatorInfo &op = get_operator_info(op_id);
+        enqueue_if_necessary(op.effect, op.base_cost, op_id);
     }
 }
 
@@ -73,27 +91,173 @@ void AdditiveHeuristic::relaxed_exploration() {
             continue;
         if (prop->is_goal && --unsolved_goals == 0)
             return;
-        for (OpID op_id : precondition_of_pool.get_slice(
-                 prop->precondition_of, prop->num_precondition_occurences)) {
+        for (OpID op_id : get_precondition_of(prop_id)) {
             UnaryOperator *unary_op = get_operator(op_id);
             increase_cost(unary_op->cost, prop_cost);
             --unary_op->unsatisfied_preconditions;
             assert(unary_op->unsatisfied_preconditions >= 0);
             if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
+                enqueue_if_necessary(get_operator_info(op_id).effect,
                                      unary_op->cost, op_id);
         }
     }
 }
 
+int AdditiveHeuristic::get_operator_cost(OpID op_id) {
+    if (num_unreached_preconditions[op_id] > 0)
+        return -1;
+    long long cost = get_operator_info(op_id).base_cost +
+        precondition_cost_sums[op_id];
+    if (cost > MAX_COST_VALUE) {
+        write_overflow_warning();
+        return MAX_COST_VALUE;
+    }
+    return cost;
+}
+
+/*
+  Reset the cost of the given proposition, which is no longer true, and
+  of all propositions whose cheapest achiever depends on it, directly or
+  indirectly. The reached_by pointers form an acyclic graph, so we
+  invalidate each proposition at most once.
+*/
+void AdditiveHeuristic::invalidate_costs_depending_on(PropID removed_prop_id) {
+    Proposition *removed_prop = get_proposition(removed_prop_id);
+    assert(removed_prop->cost == 0 && removed_prop->reached_by == NO_OP);
+    removed_prop->cost = -1;
+    size_t next = invalidated_propositions.size();
+    invalidated_propositions.push_back(removed_prop_id);
+    while (next < invalidated_propositions.size()) {
+        PropID prop_id = invalidated_propositions[next++];
+        int old_cost = propagated_costs[prop_id];
+        assert(old_cost != -1);
+        propagated_costs[prop_id] = -1;
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            precondition_cost_sums[op_id] -= old_cost;
+            ++num_unreached_preconditions[op_id];
+            PropID effect_id = get_operator_info(op_id).effect;
+            Proposition *effect = get_proposition(effect_id);
+            if (effect->reached_by == op_id) {
+                effect->cost = -1;
+                effect->reached_by = NO_OP;
+                invalidated_propositions.push_back(effect_id);
+            }
+        }
+    }
+}
+
+/*
+  Update the costs computed for the last state to the costs for the given
+  state. Facts that are no longer true invalidate the costs depending on
+  them. Facts that became true and invalidated propositions, which get the
+  cost of their cheapest achiever with valid precondition costs, are the
+  starting points of a Dijkstra search that only decreases costs. All
+  other costs remain valid because their achievers don't depend on removed
+  facts, so each cost is an upper bound on the correct cost when the
+  search starts.
+*/
+void AdditiveHeuristic::update_costs_incrementally(const State &state) {
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
+    int num_vars = values.size();
+    queue.clear();
+    for (PropID prop_id : marked_propositions) {
+        get_proposition(prop_id)->marked = false;
+    }
+    marked_propositions.clear();
+    invalidated_propositions.clear();
+
+    if (last_state_values.empty()) {
+        int num_propositions = propositions.size();
+        for (PropID prop_id = 0; prop_id < num_propositions; ++prop_id) {
+            Proposition *prop = get_proposition(prop_id);
+            prop->cost = -1;
+            prop->reached_by = NO_OP;
+            invalidated_propositions.push_back(prop_id);
+        }
+        // Treat all facts of the state as new.
+        last_state_values.assign(num_vars, -1);
+    } else {
+        for (int var = 0; var < num_vars; ++var) {
+            if (values[var] != last_state_values[var]) {
+                invalidate_costs_depending_on(
+                    get_prop_id(var, last_state_values[var]));
+            }
+        }
+    }
+
+    for (int var = 0; var < num_vars; ++var) {
+        if (values[var] != last_state_values[var]) {
+            PropID prop_id = get_prop_id(var, values[var]);
+            Proposition *prop = get_proposition(prop_id);
+            prop->cost = 0;
+            prop->reached_by = NO_OP;
+            queue.push(0, prop_id);
+        }
+    }
+
+    for (PropID prop_id : invalidated_propositions) {
+        Proposition *prop = get_proposition(prop_id);
+        if (prop->cost != -1) {
+            // The proposition is true in the state.
+            continue;
+        }
+        for (OpID op_id : achievers_pool.get_slice(
+                 achievers[prop_id], num_achievers[prop_id])) {
+            int cost = get_operator_cost(op_id);
+            if (cost != -1 && (prop->cost == -1 || cost < prop->cost)) {
+                prop->cost = cost;
+                prop->reached_by = op_id;
+            }
+        }
+        if (prop->cost != -1)
+            queue.push(prop->cost, prop_id);
+    }
+
+    propagate_cost_decreases();
+    last_state_values = values;
+}
+
+void AdditiveHeuristic::propagate_cost_decreases() {
+    while (!queue.empty()) {
+        pair<int, PropID> top_pair = queue.pop();
+        int distance = top_pair.first;
+        PropID prop_id = top_pair.second;
+        const Proposition *prop = get_proposition(prop_id);
+        int prop_cost = prop->cost;
+        assert(prop_cost >= 0 && prop_cost <= distance);
+        if (prop_cost < distance)
+            continue;
+        int old_cost = propagated_costs[prop_id];
+        propagated_costs[prop_id] = prop_cost;
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            if (old_cost == -1) {
+                --num_unreached_preconditions[op_id];
+            } else {
+                precondition_cost_sums[op_id] -= old_cost;
+            }
+            precondition_cost_sums[op_id] += prop_cost;
+            int cost = get_operator_cost(op_id);
+            if (cost == -1)
+                continue;
+            PropID effect_id = get_operator_info(op_id).effect;
+            Proposition *effect = get_proposition(effect_id);
+            if (effect->cost == -1 || cost < effect->cost) {
+                effect->cost = cost;
+                effect->reached_by = op_id;
+                queue.push(cost, effect_id);
+            }
+        }
+    }
+}
+
 void AdditiveHeuristic::mark_preferred_operators(
     const State &state, PropID goal_id) {
     Proposition *goal = get_proposition(goal_id);
     if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
+        mark_proposition(goal_id);
         OpID op_id = goal->reached_by;
         if (op_id != NO_OP) { // We have not yet chained back to a start node.
-            UnaryOperator *unary_op = get_operator(op_id);
             bool is_preferred = true;
             for (PropID precond : get_preconditions(op_id)) {
                 mark_preferred_operators(state, precond);
@@ -101,7 +265,7 @@ void AdditiveHeuristic::mark_preferred_operators(
                     is_preferred = false;
                 }
             }
-            int operator_no = unary_op->operator_no;
+            int operator_no = get_operator_info(op_id).operator_no;
             if (is_preferred && operator_no != -1) {
                 // This is not an axiom.
                 OperatorProxy op = task_proxy.get_operators()[operator_no];
@@ -113,9 +277,13 @@ void AdditiveHeuristic::mark_preferred_operators(
 }
 
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (incremental) {
+        update_costs_incrementally(state);
+    } else {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
@@ -142,6 +310,21 @@ void AdditiveHeuristic::compute_heuristic_for_cegar(const State &state) {
     compute_heuristic(state);
 }
 
+void add_incremental_option_to_parser(OptionParser &parser) {
+    parser.add_option<bool>(
+        "incremental",
+        "update the costs computed for the previously evaluated state instead "
+        "of computing all costs from scratch. Consecutively evaluated states "
+        "usually differ in few facts, so only few costs change. Unlike the "
+        "default computation, which stops as soon as all goals are reached, "
+        "this computes the costs of all facts. This pays off for large tasks, "
+        "but can be slower for tasks where many (derived) facts change "
+        "between states. The heuristic values are the same, but the relaxed "
+        "plans and preferred operators may differ since ties between "
+        "achievers can be broken differently.",
+        "false");
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Additive heuristic", "");
     parser.document_language_support("action costs", "supported");
@@ -156,6 +339,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
+    add_incremental_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
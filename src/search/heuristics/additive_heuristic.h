@@ -18,6 +18,7 @@ using relaxation_heuristic::NO_OP;
 
 using relaxation_heuristic::Proposition;
 using relaxation_heuristic::UnaryOperator;
+using relaxation_heuristic::UnaryOperatorInfo;
 
 class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     /* Costs larger than MAX_COST_VALUE are clamped to max_value. The
@@ -32,9 +33,39 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     priority_queues::AdaptiveQueue<PropID> queue;
     bool did_write_overflow_warning;
 
+    /*
+      In incremental mode, we keep the costs of all propositions for the
+      last evaluated state and only update the costs that change for the
+      next state. The remaining members are only used in this mode.
+
+      The cost and unsatisfied_preconditions fields of unary operators are
+      not used in this mode. Instead, we store the sum of the precondition
+      costs in precondition_cost_sums and count the preconditions without
+      cost in num_unreached_preconditions. These only account for the
+      propagated cost of each proposition, which lags behind its cost while
+      the proposition is queued.
+    */
+    const bool incremental;
+    array_pool::ArrayPool achievers_pool;
+    std::vector<array_pool::ArrayPoolIndex> achievers;
+    std::vector<int> num_achievers;
+    std::vector<int> propagated_costs;
+    std::vector<long long> precondition_cost_sums;
+    std::vector<int> num_unreached_preconditions;
+    // Empty if no costs have been computed yet.
+    std::vector<int> last_state_values;
+    std::vector<PropID> invalidated_propositions;
+    std::vector<PropID> marked_propositions;
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
+
+    void initialize_incremental_mode();
+    int get_operator_cost(OpID op_id);
+    void invalidate_costs_depending_on(PropID removed_prop_id);
+    void update_costs_incrementally(const State &state);
+    void propagate_cost_decreases();
     void mark_preferred_operators(const State &state, PropID goal_id);
 
     void enqueue_if_necessary(PropID prop_id, int cost, OpID op_id) {
@@ -60,6 +91,12 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     void write_overflow_warning();
 protected:
+    void mark_proposition(PropID prop_id) {
+        get_proposition(prop_id)->marked = true;
+        if (incremental)
+            marked_propositions.push_back(prop_id);
+    }
+
     virtual int compute_heuristic(const State &ancestor_state) override;
 
     // Common part of h^add and h^ff computation.
@@ -79,6 +116,8 @@ public:
         return get_proposition(var, value)->cost;
     }
 };
+
+void add_incremental_option_to_parser(options::OptionParser &parser);
 }
 
 #endif
@@ -10,6 +10,8 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <map>
+#include <tuple>
 #include <vector>
 
 using namespace std;
@@ -17,8 +19,34 @@ using namespace std;
 namespace cg_heuristic {
 const int CGCache::NOT_COMPUTED;
 
-CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size)
-    : task_proxy(task_proxy) {
+/*
+  Reallocating moves at most max_total_cache_size entries, so waiting for
+  as many lookups between reallocations makes their cost negligible.
+*/
+static const int MIN_LOOKUPS_BETWEEN_REALLOCATIONS = 10000;
+
+using SharedCaches =
+    map<tuple<const AbstractTask *, int, int>, shared_ptr<CGCache>>;
+
+/*
+  Shared caches print their statistics when they are destroyed at program
+  exit. Since the map is a function-local static, it is constructed after
+  and therefore destroyed before the global log.
+*/
+static SharedCaches &get_shared_caches() {
+    static SharedCaches shared_caches;
+    return shared_caches;
+}
+
+CGCache::CGCache(const shared_ptr<AbstractTask> &task, int max_cache_size,
+                 int max_total_cache_size)
+    : task(task),
+      task_proxy(*task),
+      max_total_cache_size(max_total_cache_size),
+      adaptive(false),
+      num_allocated_entries(0),
+      num_lookups_since_reallocation(0),
+      num_reallocations(0) {
     utils::g_log << "Initializing heuristic cache... " << flush;
 
     int var_count = task_proxy.get_variables().size();
@@ -54,20 +82,31 @@ CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size)
 
     cache.resize(var_count);
     helpful_transition_cache.resize(var_count);
+    required_cache_size.resize(var_count);
+    num_hits.resize(var_count, 0);
+    num_misses.resize(var_count, 0);
+    recent_lookups.resize(var_count, 0);
 
+    int64_t total_required_cache_size = 0;
     for (int var = 0; var < var_count; ++var) {
-        int required_cache_size = compute_required_cache_size(
+        required_cache_size[var] = compute_required_cache_size(
             var, depends_on[var], max_cache_size);
-        if (required_cache_size != -1) {
-            cache[var].resize(required_cache_size, NOT_COMPUTED);
-            helpful_transition_cache[var].resize(required_cache_size, nullptr);
-        }
+        if (required_cache_size[var] != -1)
+            total_required_cache_size += required_cache_size[var];
+    }
+    adaptive = total_required_cache_size > max_total_cache_size;
+
+    for (int var = 0; var < var_count; ++var) {
+        int size = required_cache_size[var];
+        if (size != -1 && size <= max_total_cache_size - num_allocated_entries)
+            allocate(var);
     }
 
     utils::g_log << "done!" << endl;
 }
 
 CGCache::~CGCache() {
+    print_statistics();
 }
 
 int CGCache::compute_required_cache_size(
@@ -75,7 +114,7 @@ int CGCache::compute_required_cache_size(
     /*
       Compute the size of the cache required for variable with ID "var_id",
       which depends on the variables in "depends_on". Requires that the caches
-      for all variables in "depends_on" have already been allocated. Returns -1
+      for all variables in "depends_on" have already been computed. Returns -1
       if the variable cannot be cached because the required cache size would be
       too large.
     */
@@ -98,7 +137,7 @@ int CGCache::compute_required_cache_size(
           contributes quadratically to its own cache size but only
           linearly to the cache size of var.
         */
-        if (cache[depend_var_id].empty())
+        if (required_cache_size[depend_var_id] == -1)
             return -1;
 
         if (!utils::is_product_within_limit(required_size, depend_var_domain,
@@ -111,6 +150,96 @@ int CGCache::compute_required_cache_size(
     return required_size;
 }
 
+void CGCache::allocate(int var) {
+    assert(!is_cached(var));
+    int size = required_cache_size[var];
+    cache[var].resize(size, NOT_COMPUTED);
+    helpful_transition_cache[var].resize(size);
+    num_allocated_entries += size;
+}
+
+void CGCache::release(int var) {
+    assert(is_cached(var));
+    num_allocated_entries -= cache[var].size();
+    utils::release_vector_memory(cache[var]);
+    utils::release_vector_memory(helpful_transition_cache[var]);
+}
+
+void CGCache::reallocate() {
+    int var_count = cache.size();
+    vector<int> candidates;
+    vector<double> lookups_per_entry(var_count, 0);
+    for (int var = 0; var < var_count; ++var) {
+        /*
+          Variables with a single value need no cache entries. Since a
+          cache without entries counts as not cached, we skip them.
+        */
+        if (required_cache_size[var] > 0) {
+            candidates.push_back(var);
+            lookups_per_entry[var] =
+                recent_lookups[var] / required_cache_size[var];
+        }
+    }
+    // Prefer the variables with the most recent lookups per cache entry.
+    stable_sort(candidates.begin(), candidates.end(),
+                [&](int var1, int var2) {
+                    return lookups_per_entry[var1] > lookups_per_entry[var2];
+                });
+
+    vector<bool> selected(var_count, false);
+    int64_t budget = max_total_cache_size;
+    for (int var : candidates) {
+        if (required_cache_size[var] <= budget) {
+            selected[var] = true;
+            budget -= required_cache_size[var];
+        }
+    }
+
+    // Release memory before allocating new caches to stay within the budget.
+    for (int var = 0; var < var_count; ++var) {
+        if (is_cached(var) && !selected[var])
+            release(var);
+    }
+    for (int var = 0; var < var_count; ++var) {
+        if (selected[var] && !is_cached(var))
+            allocate(var);
+        recent_lookups[var] /= 2;
+    }
+    num_lookups_since_reallocation = 0;
+    ++num_reallocations;
+}
+
+void CGCache::adapt_allocation() {
+    if (adaptive && num_lookups_since_reallocation >= max(
+            max_total_cache_size, MIN_LOOKUPS_BETWEEN_REALLOCATIONS)) {
+        reallocate();
+    }
+}
+
+void CGCache::print_statistics() const {
+    int64_t total_hits = 0;
+    int64_t total_misses = 0;
+    int num_cached_vars = 0;
+    for (size_t var = 0; var < cache.size(); ++var) {
+        total_hits += num_hits[var];
+        total_misses += num_misses[var];
+        if (is_cached(var))
+            ++num_cached_vars;
+    }
+    int64_t total_lookups = total_hits + total_misses;
+    double hit_rate = total_lookups ? total_hits * 100.0 / total_lookups : 0;
+    size_t entry_size = sizeof(int) + sizeof(HelpfulTransition);
+    utils::g_log << "CG cache hits: " << total_hits << endl;
+    utils::g_log << "CG cache misses: " << total_misses << endl;
+    utils::g_log << "CG cache hit rate: " << hit_rate << "%" << endl;
+    utils::g_log << "CG cache cached variables: " << num_cached_vars
+                 << "/" << cache.size() << endl;
+    utils::g_log << "CG cache entries: " << num_allocated_entries << endl;
+    utils::g_log << "CG cache memory: "
+                 << num_allocated_entries * entry_size / 1024 << " KB" << endl;
+    utils::g_log << "CG cache reallocations: " << num_reallocations << endl;
+}
+
 int CGCache::get_index(int var, const State &state,
                        int from_val, int to_val) const {
     assert(is_cached(var));
@@ -127,4 +256,17 @@ int CGCache::get_index(int var, const State &state,
     assert(utils::in_bounds(index, cache[var]));
     return index;
 }
+
+shared_ptr<CGCache> get_shared_cg_cache(
+    const shared_ptr<AbstractTask> &task, int max_cache_size,
+    int max_total_cache_size) {
+    auto key = make_tuple(task.get(), max_cache_size, max_total_cache_size);
+    shared_ptr<CGCache> &cache = get_shared_caches()[key];
+    if (!cache) {
+        cache = make_shared<CGCache>(task, max_cache_size, max_total_cache_size);
+    } else {
+        utils::g_log << "Reusing shared heuristic cache." << endl;
+    }
+    return cache;
+}
 }
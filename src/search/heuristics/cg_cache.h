@@ -3,26 +3,78 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
-namespace domain_transition_graph {
-struct ValueTransitionLabel;
-}
+class AbstractTask;
 
 namespace cg_heuristic {
+/*
+  A helpful transition of a cached entry, i.e., the first label on a
+  cheapest path from the start value. It refers to the label by its
+  position among the outgoing transitions of the start value. This way, it
+  is valid for all DTGs built for the same task and the cache can be
+  shared by several heuristic objects.
+*/
+struct HelpfulTransition {
+    int transition;
+    int label;
+
+    HelpfulTransition()
+        : transition(-1), label(-1) {
+    }
+
+    HelpfulTransition(int transition, int label)
+        : transition(transition), label(label) {
+    }
+};
+
+/*
+  Cache for the transition costs computed by the CG heuristic. Each
+  variable whose required cache size is at most max_cache_size can be
+  cached, as long as all variables it depends on can be cached, too.
+
+  If the caches of all such variables fit into max_total_cache_size
+  entries, we allocate all of them up front. Otherwise, we start with the
+  variables in order and periodically move the budget to the variables
+  that have been looked up most often per cache entry. Lookups count with
+  exponentially decaying weights, so the allocation follows the current
+  phase of the search.
+
+  The cache prints its statistics when it is destroyed, i.e., together
+  with the heuristic that owns it or at program exit if it is shared.
+*/
 class CGCache {
+    // Keep the task alive as long as shared caches refer to it.
+    const std::shared_ptr<AbstractTask> task;
     TaskProxy task_proxy;
+    const int max_total_cache_size;
+    bool adaptive;
     std::vector<std::vector<int>> cache;
-    std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>> helpful_transition_cache;
+    std::vector<std::vector<HelpfulTransition>> helpful_transition_cache;
     std::vector<std::vector<int>> depends_on;
+    // -1 for variables that cannot be cached.
+    std::vector<int> required_cache_size;
+    int num_allocated_entries;
+
+    std::vector<int64_t> num_hits;
+    std::vector<int64_t> num_misses;
+    std::vector<double> recent_lookups;
+    int64_t num_lookups_since_reallocation;
+    int num_reallocations;
 
     int get_index(int var, const State &state, int from_val, int to_val) const;
     int compute_required_cache_size(
         int var_id, const std::vector<int> &depends_on, int max_cache_size) const;
+    void allocate(int var);
+    void release(int var);
+    void reallocate();
 public:
     static const int NOT_COMPUTED = -2;
 
-    CGCache(const TaskProxy &task_proxy, int max_cache_size);
+    CGCache(const std::shared_ptr<AbstractTask> &task, int max_cache_size,
+            int max_total_cache_size);
     ~CGCache();
 
     bool is_cached(int var) const {
@@ -38,7 +90,7 @@ public:
         cache[var][get_index(var, state, from_val, to_val)] = cost;
     }
 
-    domain_transition_graph::ValueTransitionLabel *lookup_helpful_transition(
+    const HelpfulTransition &lookup_helpful_transition(
         int var, const State &state, int from_val, int to_val) const {
         int index = get_index(var, state, from_val, to_val);
         return helpful_transition_cache[var][index];
@@ -46,11 +98,39 @@ public:
 
     void store_helpful_transition(
         int var, const State &state, int from_val, int to_val,
-        domain_transition_graph::ValueTransitionLabel *helpful_transition) {
+        const HelpfulTransition &helpful_transition) {
         int index = get_index(var, state, from_val, to_val);
         helpful_transition_cache[var][index] = helpful_transition;
     }
+
+    void record_lookup(int var, bool hit) {
+        if (hit)
+            ++num_hits[var];
+        else
+            ++num_misses[var];
+        recent_lookups[var] += 1;
+        ++num_lookups_since_reallocation;
+    }
+
+    /*
+      Move the budget between variables if enough lookups happened since
+      the last reallocation. Must only be called between evaluations since
+      it invalidates cached entries.
+    */
+    void adapt_allocation();
+
+    void print_statistics() const;
 };
+
+/*
+  Return the cache with the given parameters for the given task, creating
+  it if necessary. Shared caches live until the end of the program, so
+  they persist across the phases of an iterated search and print their
+  statistics only once.
+*/
+extern std::shared_ptr<CGCache> get_shared_cg_cache(
+    const std::shared_ptr<AbstractTask> &task, int max_cache_size,
+    int max_total_cache_size);
 }
 
 #endif
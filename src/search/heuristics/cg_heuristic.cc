@@ -8,6 +8,7 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
 #include <algorithm>
 #include <cassert>
@@ -20,15 +21,21 @@ using namespace domain_transition_graph;
 namespace cg_heuristic {
 CGHeuristic::CGHeuristic(const Options &opts)
     : Heuristic(opts),
-      cache_hits(0),
-      cache_misses(0),
       helpful_transition_extraction_counter(0),
       min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
     utils::g_log << "Initializing causal graph heuristic..." << endl;
 
     int max_cache_size = opts.get<int>("max_cache_size");
-    if (max_cache_size > 0)
-        cache = utils::make_unique_ptr<CGCache>(task_proxy, max_cache_size);
+    int max_total_cache_size = opts.get<int>("max_total_cache_size");
+    if (max_cache_size > 0 && max_total_cache_size > 0) {
+        if (opts.get<bool>("shared_cache")) {
+            cache = get_shared_cg_cache(
+                task, max_cache_size, max_total_cache_size);
+        } else {
+            cache = make_shared<CGCache>(
+                task, max_cache_size, max_total_cache_size);
+        }
+    }
 
     unsigned int num_vars = task_proxy.get_variables().size();
     prio_queues.reserve(num_vars);
@@ -50,6 +57,8 @@ bool CGHeuristic::dead_ends_are_reliable() const {
 
 int CGHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+    if (cache)
+        cache->adapt_allocation();
     setup_domain_transition_graphs();
 
     int heuristic = 0;
@@ -94,12 +103,12 @@ int CGHeuristic::get_transition_cost(const State &state,
     if (use_the_cache) {
         int cached_val = cache->lookup(var_no, state, start_val, goal_val);
         if (cached_val != CGCache::NOT_COMPUTED) {
-            ++cache_hits;
+            cache->record_lookup(var_no, true);
             return cached_val;
         }
-    } else {
-        ++cache_misses;
     }
+    if (cache)
+        cache->record_lookup(var_no, false);
 
     ValueNode *start = &dtg->nodes[start_val];
     if (start->distances.empty()) {
@@ -213,14 +222,30 @@ int CGHeuristic::get_transition_cost(const State &state,
             // We should have a helpful transition iff distance is infinite.
             assert((distance == numeric_limits<int>::max()) == !helpful);
             cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
+            if (helpful) {
+                cache->store_helpful_transition(
+                    var_no, state, start_val, val,
+                    get_helpful_transition(*start, helpful));
+            }
         }
     }
 
     return start->distances[goal_val];
 }
 
+HelpfulTransition CGHeuristic::get_helpful_transition(
+    const ValueNode &start, const ValueTransitionLabel *helpful) const {
+    // Helpful transitions always start in the start node.
+    for (size_t i = 0; i < start.transitions.size(); ++i) {
+        const vector<ValueTransitionLabel> &labels = start.transitions[i].labels;
+        if (!labels.empty() && helpful >= &labels.front() &&
+            helpful <= &labels.back()) {
+            return HelpfulTransition(i, helpful - &labels.front());
+        }
+    }
+    ABORT("Helpful transition does not start in the start node.");
+}
+
 void CGHeuristic::mark_helpful_transitions(const State &state,
                                            DomainTransitionGraph *dtg, int to) {
     int var_no = dtg->var;
@@ -256,9 +281,12 @@ void CGHeuristic::mark_helpful_transitions(const State &state,
     int cost;
     // Check cache.
     if (cache && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
+        const HelpfulTransition &helpful_transition =
+            cache->lookup_helpful_transition(var_no, state, from, to);
+        assert(helpful_transition.transition != -1);
+        helpful = &dtg->nodes[from].transitions[
+            helpful_transition.transition].labels[helpful_transition.label];
         cost = cache->lookup(var_no, state, from, to);
-        assert(helpful);
     } else {
         ValueNode *start_node = &dtg->nodes[from];
         assert(!start_node->helpful_transitions.empty());
@@ -304,6 +332,21 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "maximum number of cached entries per variable (set to 0 to disable cache)",
         "1000000",
         Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "max_total_cache_size",
+        "maximum number of cached entries over all variables. If the caches "
+        "of all variables that may be cached need more entries, the budget "
+        "is periodically moved to the variables with the most lookups per "
+        "cache entry (set to 0 to disable cache)",
+        "infinity",
+        Bounds("0", "infinity"));
+    parser.add_option<bool>(
+        "shared_cache",
+        "share the cache with all other cg heuristics with the same cache "
+        "options on the same task, including those of later phases of an "
+        "iterated search. Heuristics that transform the task (e.g., with "
+        "adapted costs) use separate tasks and therefore separate caches.",
+        "false");
 
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
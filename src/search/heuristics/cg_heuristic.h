@@ -12,19 +12,19 @@
 namespace domain_transition_graph {
 class DomainTransitionGraph;
 struct ValueNode;
+struct ValueTransitionLabel;
 }
 
 namespace cg_heuristic {
 class CGCache;
+struct HelpfulTransition;
 
 class CGHeuristic : public Heuristic {
     using ValueNodeQueue = priority_queues::AdaptiveQueue<domain_transition_graph::ValueNode *>;
     std::vector<std::unique_ptr<ValueNodeQueue>> prio_queues;
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
 
-    std::unique_ptr<CGCache> cache;
-    int cache_hits;
-    int cache_misses;
+    std::shared_ptr<CGCache> cache;
 
     int helpful_transition_extraction_counter;
 
@@ -36,6 +36,9 @@ class CGHeuristic : public Heuristic {
         domain_transition_graph::DomainTransitionGraph *dtg,
         int start_val,
         int goal_val);
+    HelpfulTransition get_helpful_transition(
+        const domain_transition_graph::ValueNode &start,
+        const domain_transition_graph::ValueTransitionLabel *helpful) const;
     void mark_helpful_transitions(
         const State &state,
         domain_transition_graph::DomainTransitionGraph *dtg,
@@ -22,10 +22,9 @@ void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
     const State &state, PropID goal_id) {
     Proposition *goal = get_proposition(goal_id);
     if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
+        mark_proposition(goal_id);
         OpID op_id = goal->reached_by;
         if (op_id != NO_OP) { // We have not yet chained back to a start node.
-            UnaryOperator *unary_op = get_operator(op_id);
             bool is_preferred = true;
             for (PropID precond : get_preconditions(op_id)) {
                 mark_preferred_operators_and_relaxed_plan(
@@ -34,7 +33,7 @@ void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
                     is_preferred = false;
                 }
             }
-            int operator_no = unary_op->operator_no;
+            int operator_no = get_operator_info(op_id).operator_no;
             if (operator_no != -1) {
                 // This is not an axiom.
                 relaxed_plan[operator_no] = true;
@@ -83,6 +82,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
+    additive_heuristic::add_incremental_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
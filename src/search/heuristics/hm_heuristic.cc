@@ -4,262 +4,374 @@
 #include "../plugin.h"
 
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+static const int INF = numeric_limits<int>::max();
+
+/*
+  Call the callback for all subsets of the sorted facts with at most
+  max_size elements, including the empty set. The subsets are sorted.
+*/
+template<typename Callback>
+static void for_each_subset(
+    const vector<int> &facts, int max_size, vector<int> &subset,
+    size_t next, const Callback &callback) {
+    callback(subset);
+    if (static_cast<int>(subset.size()) == max_size)
+        return;
+    for (size_t i = next; i < facts.size(); ++i) {
+        subset.push_back(facts[i]);
+        for_each_subset(facts, max_size, subset, i + 1, callback);
+        subset.pop_back();
+    }
+}
+
+template<typename Callback>
+static void for_each_subset(
+    const vector<int> &facts, int max_size, const Callback &callback) {
+    vector<int> subset;
+    for_each_subset(facts, max_size, subset, 0, callback);
+}
+
+bool HMHeuristic::HMOperator::uses_var(int var) const {
+    return binary_search(used_vars.begin(), used_vars.end(), var);
+}
+
 HMHeuristic::HMHeuristic(const Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      tuple_index(task_proxy, m),
+      num_closed_tuples(0) {
     utils::g_log << "Using h^" << m << "." << endl;
-    utils::g_log << "The implementation of the h^m heuristic is preliminary." << endl
-                 << "It is SLOOOOOOOOOOOW." << endl
-                 << "Please do not use this for comparison!" << endl;
-    generate_all_tuples();
-}
-
-
-bool HMHeuristic::dead_ends_are_reliable() const {
-    return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
+    for (OperatorProxy op : task_proxy.get_operators())
+        add_operator(op);
+    build_precondition_of_lists();
+
+    vector<FactPair> goals = task_properties::get_fact_pairs(task_proxy.get_goals());
+    sort(goals.begin(), goals.end());
+    Tuple goal_facts;
+    for (const FactPair &goal : goals)
+        goal_facts.push_back(tuple_index.get_fact_id(goal));
+    for_each_subset(
+        goal_facts, m, [this](const Tuple &subset) {
+            if (!subset.empty())
+                goal_tuple_ids.push_back(tuple_index.get_tuple_id(subset));
+        });
+    is_goal_tuple.resize(tuple_index.get_num_tuples(), false);
+    for (int tuple_id : goal_tuple_ids)
+        is_goal_tuple[tuple_id] = true;
+    utils::g_log << "Number of h^" << m << " tuples: "
+                 << tuple_index.get_num_tuples() << endl;
 }
 
+void HMHeuristic::add_operator(const OperatorProxy &op) {
+    operators.emplace_back();
+    HMOperator &hm_op = operators.back();
+    hm_op.cost = op.get_cost();
 
-int HMHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    if (task_properties::is_goal_state(task_proxy, state)) {
-        return 0;
-    } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
-
-        init_hm_table(s_tup);
-        update_hm_table();
-
-        int h = eval(goals);
-
-        if (h == numeric_limits<int>::max())
-            return DEAD_END;
-        return h;
+    for (FactProxy pre : op.get_preconditions()) {
+        hm_op.preconditions.push_back(tuple_index.get_fact_id(pre.get_pair()));
+        hm_op.used_vars.push_back(pre.get_variable().get_id());
     }
-}
+    sort(hm_op.preconditions.begin(), hm_op.preconditions.end());
 
-
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
+    // Conditional effects are treated as unconditional effects.
+    Tuple effects;
+    vector<int> effect_vars;
+    for (EffectProxy eff : op.get_effects()) {
+        FactPair fact = eff.get_fact().get_pair();
+        effects.push_back(tuple_index.get_fact_id(fact));
+        effect_vars.push_back(fact.var);
     }
-}
-
-
-void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
-            }
-        }
-    } while (was_updated);
-}
-
+    utils::sort_unique(effects);
+    utils::sort_unique(effect_vars);
+    hm_op.used_vars.insert(hm_op.used_vars.end(),
+                           effect_vars.begin(), effect_vars.end());
+    utils::sort_unique(hm_op.used_vars);
+
+    Tuple postconditions = effects;
+    for (int fact_id : hm_op.preconditions) {
+        if (!binary_search(effect_vars.begin(), effect_vars.end(),
+                           tuple_index.get_variable(fact_id)))
+            postconditions.push_back(fact_id);
+    }
+    sort(postconditions.begin(), postconditions.end());
 
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
-            }
-        }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
+    for_each_subset(
+        hm_op.preconditions, m, [this, &hm_op](const Tuple &subset) {
+            if (!subset.empty()) {
+                hm_op.precondition_tuple_ids.push_back(
+                    tuple_index.get_tuple_id(subset));
             }
-
-            sort(pre.begin(), pre.end());
-
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
+            if (static_cast<int>(subset.size()) < m)
+                hm_op.small_precondition_subsets.push_back(subset);
+        });
+
+    for_each_subset(
+        postconditions, m, [this, &hm_op, &effects](const Tuple &subset) {
+            bool has_effect = false;
+            for (size_t i = 0; i < subset.size(); ++i) {
+                if (i > 0 && tuple_index.get_variable(subset[i - 1]) ==
+                    tuple_index.get_variable(subset[i])) {
+                    // Conflicting conditional effects.
+                    return;
                 }
-                vars.insert(fact.var);
+                if (binary_search(effects.begin(), effects.end(), subset[i]))
+                    has_effect = true;
             }
-
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
+            if (has_effect) {
+                hm_op.achieved_subsets.push_back(subset);
+                hm_op.achieved_tuple_ids.push_back(
+                    tuple_index.get_tuple_id(subset));
             }
-        }
-    }
+        });
 }
 
-
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
-        }
+void HMHeuristic::build_precondition_of_lists() {
+    int num_tuples = tuple_index.get_num_tuples();
+    precondition_of_begin.assign(num_tuples + 1, 0);
+    for (const HMOperator &op : operators) {
+        for (int tuple_id : op.precondition_tuple_ids)
+            ++precondition_of_begin[tuple_id + 1];
     }
-    return max;
-}
-
-
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+    for (int tuple_id = 0; tuple_id < num_tuples; ++tuple_id)
+        precondition_of_begin[tuple_id + 1] += precondition_of_begin[tuple_id];
+    precondition_of.resize(precondition_of_begin[num_tuples]);
+    vector<int> next = precondition_of_begin;
+    operators_by_precondition.resize(tuple_index.get_num_facts());
+    int num_ops = operators.size();
+    for (int op_id = 0; op_id < num_ops; ++op_id) {
+        const HMOperator &op = operators[op_id];
+        for (int tuple_id : op.precondition_tuple_ids)
+            precondition_of[next[tuple_id]++] = op_id;
+        for (int fact_id : op.preconditions)
+            operators_by_precondition[fact_id].push_back(op_id);
     }
-    return val;
 }
 
-
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return numeric_limits<int>::max();
-        }
-    }
-    return 0;
+bool HMHeuristic::dead_ends_are_reliable() const {
+    return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
 }
 
-
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+int HMHeuristic::get_union_id(const Tuple &tuple1, const Tuple &tuple2) {
+    tuple_buffer.clear();
+    merge(tuple1.begin(), tuple1.end(), tuple2.begin(), tuple2.end(),
+          back_inserter(tuple_buffer));
+    return tuple_index.get_tuple_id(tuple_buffer);
 }
 
-
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+void HMHeuristic::enqueue_if_necessary(int tuple_id, int cost) {
+    if (cost < hm_table[tuple_id]) {
+        assert(!closed[tuple_id]);
+        hm_table[tuple_id] = cost;
+        queue.push(cost, tuple_id);
     }
-    sort(effects.begin(), effects.end());
-    return effects;
 }
 
+/*
+  Apply a(o, S) for the given noop set S if all of its precondition tuples
+  that are not subsets of pre(o) are closed. The caller guarantees that the
+  remaining precondition tuples are closed and that cost is the largest
+  cost of a closed tuple.
+*/
+void HMHeuristic::apply_operator_with_noop_set(
+    int op_id, const Tuple &noop_set, int cost) {
+    const HMOperator &op = operators[op_id];
+    int target_cost = cost + op.cost;
+    if (noop_set.empty()) {
+        for (int tuple_id : op.achieved_tuple_ids)
+            enqueue_if_necessary(tuple_id, target_cost);
+        return;
+    }
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+    int noop_set_size = noop_set.size();
+    Tuple noop_subset;
+    for (int mask = 1; mask < (1 << noop_set_size); ++mask) {
+        noop_subset.clear();
+        for (int i = 0; i < noop_set_size; ++i) {
+            if (mask & (1 << i))
+                noop_subset.push_back(noop_set[i]);
+        }
+        int max_pre_size = m - noop_subset.size();
+        for (const Tuple &pre_subset : op.small_precondition_subsets) {
+            if (static_cast<int>(pre_subset.size()) <= max_pre_size &&
+                !closed[get_union_id(noop_subset, pre_subset)]) {
+                return;
+            }
         }
     }
-    return false;
-}
 
-
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+    int max_achieved_size = m - noop_set_size;
+    for (const Tuple &achieved : op.achieved_subsets) {
+        if (static_cast<int>(achieved.size()) <= max_achieved_size)
+            enqueue_if_necessary(get_union_id(noop_set, achieved), target_cost);
+    }
 }
 
-
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
+/*
+  Apply a(o, S) for all noop sets S that extend the given noop set by facts
+  with IDs of at least first_fact_id. We add the facts in increasing order
+  to generate each noop set only once. The given noop set is restored
+  before returning.
+*/
+void HMHeuristic::apply_operators_with_noop_sets_containing(
+    int op_id, Tuple &noop_set, int first_fact_id, int cost) {
+    apply_operator_with_noop_set(op_id, noop_set, cost);
+    if (static_cast<int>(noop_set.size()) == m - 1)
+        return;
+    const HMOperator &op = operators[op_id];
+    int num_facts = tuple_index.get_num_facts();
+    for (int fact_id = first_fact_id; fact_id < num_facts; ++fact_id) {
+        int var = tuple_index.get_variable(fact_id);
+        if (op.uses_var(var))
+            continue;
+        bool has_var = false;
+        for (int other_id : noop_set) {
+            if (tuple_index.get_variable(other_id) == var) {
+                has_var = true;
+                break;
             }
         }
+        if (has_var)
+            continue;
+        noop_set.insert(
+            lower_bound(noop_set.begin(), noop_set.end(), fact_id), fact_id);
+        apply_operators_with_noop_sets_containing(
+            op_id, noop_set, fact_id + 1, cost);
+        noop_set.erase(find(noop_set.begin(), noop_set.end(), fact_id));
     }
 }
 
-
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
+void HMHeuristic::apply_operator(int op_id, int cost) {
+    Tuple noop_set;
+    apply_operators_with_noop_sets_containing(op_id, noop_set, 0, cost);
 }
 
-
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
+void HMHeuristic::close_tuple(int tuple_id, const Tuple &tuple, int cost) {
+    for (int i = precondition_of_begin[tuple_id];
+         i < precondition_of_begin[tuple_id + 1]; ++i) {
+        int op_id = precondition_of[i];
+        if (--num_unsatisfied_preconditions[op_id] == 0) {
+            applicable_operators.push_back(op_id);
+            apply_operator(op_id, cost);
         }
+    }
+
+    /*
+      The tuple is a precondition of a(o, S) iff o is applicable and the
+      facts of the tuple that are not in pre(o) are a non-empty subset of S.
+    */
+    ++num_closed_tuples;
+    Tuple noop_facts;
+    auto visit = [&](int op_id) {
+            if (num_unsatisfied_preconditions[op_id] != 0)
+                return;
+            const HMOperator &op = operators[op_id];
+            noop_facts.clear();
+            set_difference(tuple.begin(), tuple.end(),
+                           op.preconditions.begin(), op.preconditions.end(),
+                           back_inserter(noop_facts));
+            if (noop_facts.empty() || static_cast<int>(noop_facts.size()) >= m)
+                return;
+            for (int fact_id : noop_facts) {
+                if (op.uses_var(tuple_index.get_variable(fact_id)))
+                    return;
+            }
+            apply_operators_with_noop_sets_containing(
+                op_id, noop_facts, 0, cost);
+        };
+    auto visit_once = [&](int op_id) {
+            if (last_visit[op_id] != num_closed_tuples) {
+                last_visit[op_id] = num_closed_tuples;
+                visit(op_id);
+            }
+        };
+    if (static_cast<int>(tuple.size()) < m) {
+        // The operator must not mention the variable of some fact.
+        for (int op_id : applicable_operators)
+            visit(op_id);
     } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
+        // Some fact of the tuple must be a precondition.
+        for (int fact_id : tuple) {
+            for (int op_id : operators_by_precondition[fact_id])
+                visit_once(op_id);
         }
     }
 }
 
+bool HMHeuristic::compute_hm_table(const State &state) {
+    int num_tuples = tuple_index.get_num_tuples();
+    hm_table.assign(num_tuples, INF);
+    closed.assign(num_tuples, false);
+    last_visit.assign(operators.size(), -1);
+    num_closed_tuples = 0;
+    applicable_operators.clear();
+    queue.clear();
+
+    Tuple state_facts;
+    for (FactProxy fact : state)
+        state_facts.push_back(tuple_index.get_fact_id(fact.get_pair()));
+    for_each_subset(
+        state_facts, m, [this](const Tuple &subset) {
+            if (!subset.empty())
+                enqueue_if_necessary(tuple_index.get_tuple_id(subset), 0);
+        });
+
+    num_unsatisfied_preconditions.resize(operators.size());
+    int num_ops = operators.size();
+    for (int op_id = 0; op_id < num_ops; ++op_id) {
+        num_unsatisfied_preconditions[op_id] =
+            operators[op_id].precondition_tuple_ids.size();
+        if (num_unsatisfied_preconditions[op_id] == 0) {
+            applicable_operators.push_back(op_id);
+            apply_operator(op_id, 0);
+        }
+    }
 
-void HMHeuristic::dump_table() const {
-    for (auto &hm_ent : hm_table) {
-        utils::g_log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
+    // We can stop as soon as all goal tuples are closed.
+    int num_open_goal_tuples = goal_tuple_ids.size();
+    for (int tuple_id : goal_tuple_ids) {
+        if (closed[tuple_id])
+            --num_open_goal_tuples;
+    }
+    Tuple tuple;
+    while (!queue.empty() && num_open_goal_tuples > 0) {
+        pair<int, int> top_pair = queue.pop();
+        int cost = top_pair.first;
+        int tuple_id = top_pair.second;
+        if (closed[tuple_id])
+            continue;
+        assert(hm_table[tuple_id] == cost);
+        closed[tuple_id] = true;
+        if (is_goal_tuple[tuple_id])
+            --num_open_goal_tuples;
+        tuple_index.get_tuple(tuple_id, tuple);
+        close_tuple(tuple_id, tuple, cost);
     }
+    return num_open_goal_tuples == 0;
 }
 
+int HMHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    if (task_properties::is_goal_state(task_proxy, state))
+        return 0;
+
+    if (!compute_hm_table(state))
+        return DEAD_END;
+    int h = 0;
+    for (int tuple_id : goal_tuple_ids)
+        h = max(h, hm_table[tuple_id]);
+    return h;
+}
 
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("h^m heuristic", "");
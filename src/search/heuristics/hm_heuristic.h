@@ -3,10 +3,9 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <string>
+#include "../algorithms/priority_queues.h"
+#include "../task_utils/fact_tuple_index.h"
+
 #include <vector>
 
 namespace options {
@@ -17,45 +16,82 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  We compute h^m as h^max in the P^m compilation of the task, whose atoms
+  are the tuples of at most m facts. For each operator o and each set S of
+  less than m facts on variables that o neither mentions in its
+  precondition nor in its effect, P^m has an action a(o, S). It requires
+  all tuples of at most m facts from pre(o) and S and achieves all tuples
+  of at most m facts from S and post(o) with at least one effect fact.
+  Here, post(o) consists of the effects and the preconditions on variables
+  without effect.
+
+  The table of tuple costs is a flat array indexed by FactTupleIndex. We
+  run a Dijkstra search over the tuples. The actions a(o, {}) are stored
+  explicitly and use counters for their unsatisfied precondition tuples.
+  Actions a(o, S) with S non-empty are not stored. Whenever a tuple is
+  closed, we enumerate the actions a(o, S) that require it and apply the
+  ones whose precondition tuples are all closed. For tuples of size m, the
+  candidate operators o are looked up by the facts of the closed tuple.
+  For smaller tuples, we check all operators whose precondition tuples
+  are closed against the variables of the tuple.
 */
-
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
-    // parameters
+    using Tuple = std::vector<int>;
+
+    struct HMOperator {
+        int cost;
+        // Sorted fact IDs.
+        Tuple preconditions;
+        // Sorted variables mentioned in the precondition or effect.
+        std::vector<int> used_vars;
+        // IDs of the tuples of at most m precondition facts.
+        std::vector<int> precondition_tuple_ids;
+        // Sets of less than m precondition facts, including the empty set.
+        std::vector<Tuple> small_precondition_subsets;
+        // Sets of at most m facts from post(o) with at least one effect.
+        std::vector<Tuple> achieved_subsets;
+        std::vector<int> achieved_tuple_ids;
+
+        bool uses_var(int var) const;
+    };
+
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
-
-    // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
-
-    // auxiliary methods
-    void init_hm_table(const Tuple &t);
-    void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
-
-    void dump_table() const;
+    fact_tuple_index::FactTupleIndex tuple_index;
+    std::vector<HMOperator> operators;
+    // Operators that have each tuple among their precondition tuples.
+    std::vector<int> precondition_of_begin;
+    std::vector<int> precondition_of;
+    // Operators that have each fact as a precondition.
+    std::vector<std::vector<int>> operators_by_precondition;
+    std::vector<int> goal_tuple_ids;
+    std::vector<bool> is_goal_tuple;
+
+    // Per-evaluation data.
+    std::vector<int> hm_table;
+    std::vector<bool> closed;
+    std::vector<int> num_unsatisfied_preconditions;
+    // Operators whose precondition tuples are all closed.
+    std::vector<int> applicable_operators;
+    priority_queues::AdaptiveQueue<int> queue;
+    // Avoids visiting an operator twice for the same closed tuple.
+    std::vector<int> last_visit;
+    int num_closed_tuples;
+    // Scratch space for building tuples.
+    Tuple tuple_buffer;
+
+    void add_operator(const OperatorProxy &op);
+    void build_precondition_of_lists();
+
+    int get_union_id(const Tuple &tuple1, const Tuple &tuple2);
+    void enqueue_if_necessary(int tuple_id, int cost);
+    void apply_operator(int op_id, int cost);
+    void apply_operator_with_noop_set(int op_id, const Tuple &noop_set, int cost);
+    void apply_operators_with_noop_sets_containing(
+        int op_id, Tuple &noop_set, int first_fact_id, int cost);
+    void close_tuple(int tuple_id, const Tuple &tuple, int cost);
+    bool compute_hm_table(const State &state);
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
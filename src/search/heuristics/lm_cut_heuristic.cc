@@ -10,6 +10,7 @@
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -17,14 +18,100 @@ using namespace std;
 namespace lm_cut_heuristic {
 LandmarkCutHeuristic::LandmarkCutHeuristic(const Options &opts)
     : Heuristic(opts),
-      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)) {
+      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)),
+      incremental(opts.get<bool>("incremental")),
+      max_reuse_depth(opts.get<int>("max_reuse_depth")),
+      parent_id(StateID::no_state) {
     utils::g_log << "Initializing landmark cut heuristic..." << endl;
+    if (incremental) {
+        for (OperatorProxy op : task_proxy.get_operators())
+            operator_costs.push_back(op.get_cost());
+    }
 }
 
 LandmarkCutHeuristic::~LandmarkCutHeuristic() {
 }
 
+void LandmarkCutHeuristic::notify_initial_state(const State &) {
+    parent_id = StateID::no_state;
+    current_parent_landmarks = nullptr;
+}
+
+void LandmarkCutHeuristic::notify_state_transition(
+    const State &parent_state, OperatorID op_id, const State &state) {
+    if (parent_state.get_id() != parent_id) {
+        parent_id = parent_state.get_id();
+        current_parent_landmarks = move(landmarks[parent_state]);
+    }
+    // We don't evaluate states with a cached estimate again.
+    if (current_parent_landmarks && !is_estimate_cached(state)) {
+        ParentLandmarks &entry = parent_landmarks[state];
+        entry.landmarks = current_parent_landmarks;
+        entry.op_id = op_id.get_index();
+    }
+}
+
+int LandmarkCutHeuristic::compute_heuristic_incrementally(
+    const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    bool is_registered = ancestor_state.get_registry();
+    shared_ptr<LandmarkSet> state_landmarks = make_shared<LandmarkSet>();
+    int total_cost = 0;
+    auto add_landmark = [&state_landmarks, &total_cost](
+        vector<int>::const_iterator begin, vector<int>::const_iterator end,
+        int cost) {
+            state_landmarks->operators.insert(
+                state_landmarks->operators.end(), begin, end);
+            state_landmarks->begins.push_back(state_landmarks->operators.size());
+            state_landmarks->costs.push_back(cost);
+            total_cost += cost;
+        };
+
+    if (is_registered) {
+        ParentLandmarks &parent = parent_landmarks[ancestor_state];
+        if (parent.landmarks) {
+            const LandmarkSet &inherited = *parent.landmarks;
+            state_landmarks->reuse_depth = inherited.reuse_depth + 1;
+            for (int i = 0; i < inherited.size(); ++i) {
+                auto begin = inherited.operators.begin() + inherited.begins[i];
+                auto end = inherited.operators.begin() + inherited.begins[i + 1];
+                if (find(begin, end, parent.op_id) == end) {
+                    int cost = inherited.costs[i];
+                    for (auto it = begin; it != end; ++it)
+                        operator_costs[*it] -= cost;
+                    add_landmark(begin, end, cost);
+                }
+            }
+        }
+        parent = ParentLandmarks();
+    }
+    int num_inherited_landmarks = state_landmarks->size();
+
+    bool dead_end = landmark_generator->compute_landmarks(
+        state, operator_costs, nullptr,
+        [&add_landmark](const LandmarkCutLandmarks::Landmark &landmark, int cost) {
+            add_landmark(landmark.begin(), landmark.end(), cost);
+        });
+
+    // Restore the operator costs.
+    for (int i = 0; i < num_inherited_landmarks; ++i) {
+        for (int j = state_landmarks->begins[i];
+             j < state_landmarks->begins[i + 1]; ++j) {
+            operator_costs[state_landmarks->operators[j]] +=
+                state_landmarks->costs[i];
+        }
+    }
+
+    if (dead_end)
+        return DEAD_END;
+    if (is_registered && state_landmarks->reuse_depth < max_reuse_depth)
+        landmarks[ancestor_state] = move(state_landmarks);
+    return total_cost;
+}
+
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
+    if (incremental)
+        return compute_heuristic_incrementally(ancestor_state);
     State state = convert_ancestor_state(ancestor_state);
     int total_cost = 0;
     bool dead_end = landmark_generator->compute_landmarks(
@@ -46,7 +133,31 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("consistent", "no");
     parser.document_property("safe", "yes");
     parser.document_property("preferred operators", "no");
+    parser.document_note(
+        "Incremental computation",
+        "With incremental=true, the heuristic reuses the landmarks of the "
+        "parent state that do not contain the generating operator, as in "
+        "incremental LM-cut by Pommerening and Helmert (ICAPS 2013). It "
+        "reduces the operator costs by the costs of these landmarks and "
+        "only computes the remaining landmarks from scratch. "
+        "The heuristic is then path-dependent, i.e., its value for a state "
+        "depends on the path on which the search reached the state. It "
+        "remains admissible, but may be higher or lower than the "
+        "non-incremental value.");
 
+    parser.add_option<bool>(
+        "incremental",
+        "reuse the landmarks of the parent state (see note below). The "
+        "landmarks of all states in the open list are kept in memory.",
+        "false");
+    parser.add_option<int>(
+        "max_reuse_depth",
+        "maximum number of consecutive generations over which landmarks are "
+        "reused in incremental mode. Reused landmarks tend to become less "
+        "informative, so higher values make evaluations faster but can "
+        "increase the number of expanded states considerably.",
+        "1",
+        Bounds("1", "infinity"));
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -2,8 +2,10 @@
 #define HEURISTICS_LM_CUT_HEURISTIC_H
 
 #include "../heuristic.h"
+#include "../per_state_information.h"
 
 #include <memory>
+#include <vector>
 
 namespace options {
 class Options;
@@ -12,13 +14,79 @@ class Options;
 namespace lm_cut_heuristic {
 class LandmarkCutLandmarks;
 
+/*
+  The landmarks found for a state. The operators of landmark i are
+  operators[begins[i]], ..., operators[begins[i + 1] - 1].
+*/
+struct LandmarkSet {
+    std::vector<int> operators;
+    std::vector<int> begins;
+    std::vector<int> costs;
+    // Number of consecutive ancestors whose landmarks we reused.
+    int reuse_depth;
+
+    LandmarkSet()
+        : begins({0}), reuse_depth(0) {
+    }
+
+    int size() const {
+        return costs.size();
+    }
+};
+
+/*
+  The landmarks of the state in which a state was generated and the ID of
+  the operator that generated it.
+*/
+struct ParentLandmarks {
+    std::shared_ptr<const LandmarkSet> landmarks;
+    int op_id;
+
+    ParentLandmarks()
+        : op_id(-1) {
+    }
+};
+
 class LandmarkCutHeuristic : public Heuristic {
     std::unique_ptr<LandmarkCutLandmarks> landmark_generator;
 
+    /*
+      In incremental mode (Pommerening and Helmert, ICAPS 2013), we store
+      the landmarks of each evaluated state until the search reaches its
+      successors. A landmark of the parent that does not contain the
+      generating operator is also a landmark of the successor. We keep
+      these landmarks, reduce the operator costs by their costs and only
+      compute the remaining cuts for the successor from scratch.
+
+      Reused landmarks become less informative over many generations, so
+      we compute all landmarks from scratch after max_reuse_depth
+      generations and only store landmarks that may be reused.
+    */
+    const bool incremental;
+    const int max_reuse_depth;
+    std::vector<int> operator_costs;
+    PerStateInformation<std::shared_ptr<const LandmarkSet>> landmarks;
+    PerStateInformation<ParentLandmarks> parent_landmarks;
+    StateID parent_id;
+    std::shared_ptr<const LandmarkSet> current_parent_landmarks;
+
+    int compute_heuristic_incrementally(const State &ancestor_state);
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit LandmarkCutHeuristic(const options::Options &opts);
     virtual ~LandmarkCutHeuristic() override;
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override {
+        if (incremental) {
+            evals.insert(this);
+        }
+    }
+
+    virtual void notify_initial_state(const State &initial_state) override;
+    virtual void notify_state_transition(const State &parent_state,
+                                         OperatorID op_id,
+                                         const State &state) override;
 };
 }
 
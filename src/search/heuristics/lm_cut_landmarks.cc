@@ -279,6 +279,27 @@ bool LandmarkCutLandmarks::compute_landmarks(
     for (RelaxedOperator &op : relaxed_operators) {
         op.cost = op.base_cost;
     }
+    return find_cuts(state, cost_callback, landmark_callback);
+}
+
+bool LandmarkCutLandmarks::compute_landmarks(
+    const State &state, const vector<int> &operator_costs,
+    CostCallback cost_callback, LandmarkCallback landmark_callback) {
+    for (RelaxedOperator &op : relaxed_operators) {
+        if (op.original_op_id == -1) {
+            // Artificial goal operator.
+            op.cost = op.base_cost;
+        } else {
+            assert(operator_costs[op.original_op_id] >= 0);
+            op.cost = operator_costs[op.original_op_id];
+        }
+    }
+    return find_cuts(state, cost_callback, landmark_callback);
+}
+
+bool LandmarkCutLandmarks::find_cuts(
+    const State &state, CostCallback cost_callback,
+    LandmarkCallback landmark_callback) {
     // The following three variables could be declared inside the loop
     // ("second_exploration_queue" even inside second_exploration),
     // but having them here saves reallocations and hence provides a
@@ -49,6 +49,11 @@ struct RelaxedProposition {
 };
 
 class LandmarkCutLandmarks {
+public:
+    using Landmark = std::vector<int>;
+    using CostCallback = std::function<void (int)>;
+    using LandmarkCallback = std::function<void (const Landmark &, int)>;
+private:
     std::vector<RelaxedOperator> relaxed_operators;
     std::vector<std::vector<RelaxedProposition>> propositions;
     RelaxedProposition artificial_precondition;
@@ -80,11 +85,9 @@ class LandmarkCutLandmarks {
 
     void mark_goal_plateau(RelaxedProposition *subgoal);
     void validate_h_max() const;
+    bool find_cuts(const State &state, CostCallback cost_callback,
+                   LandmarkCallback landmark_callback);
 public:
-    using Landmark = std::vector<int>;
-    using CostCallback = std::function<void (int)>;
-    using LandmarkCallback = std::function<void (const Landmark &, int)>;
-
     LandmarkCutLandmarks(const TaskProxy &task_proxy);
     virtual ~LandmarkCutLandmarks();
 
@@ -103,6 +106,15 @@ public:
     */
     bool compute_landmarks(const State &state, CostCallback cost_callback,
                            LandmarkCallback landmark_callback);
+
+    /*
+      Like compute_landmarks above, but use the given non-negative costs
+      (indexed by operator ID) instead of the operator costs of the task.
+    */
+    bool compute_landmarks(const State &state,
+                           const std::vector<int> &operator_costs,
+                           CostCallback cost_callback,
+                           LandmarkCallback landmark_callback);
 };
 
 inline void RelaxedOperator::update_h_max_supporter() {
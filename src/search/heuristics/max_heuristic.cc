@@ -32,17 +32,12 @@ HSPMaxHeuristic::HSPMaxHeuristic(const Options &opts)
 // heuristic computation
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
-
-    for (Proposition &prop : propositions)
-        prop.cost = -1;
+    reset_propositions_and_operators();
 
     // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperatorInfo &op = get_operator_info(op_id);
+        enqueue_if_necessary(op.effect, op.base_cost);
     }
 }
 
@@ -67,15 +62,19 @@ void HSPMaxHeuristic::relaxed_exploration() {
             continue;
         if (prop->is_goal && --unsolved_goals == 0)
             return;
-        for (OpID op_id : precondition_of_pool.get_slice(
-                 prop->precondition_of, prop->num_precondition_occurences)) {
+        for (OpID op_id : get_precondition_of(prop_id)) {
             UnaryOperator *unary_op = get_operator(op_id);
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
             --unary_op->unsatisfied_preconditions;
             assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+            if (unary_op->unsatisfied_preconditions == 0) {
+                /*
+                  Propositions leave the queue in order of increasing
+                  cost, so the last reached precondition is the most
+                  expensive one.
+                */
+                const UnaryOperatorInfo &op = get_operator_info(op_id);
+                enqueue_if_necessary(op.effect, op.base_cost + prop_cost);
+            }
         }
     }
 }
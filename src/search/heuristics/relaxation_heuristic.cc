@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <unordered_map>
 #include <vector>
 
@@ -18,12 +19,11 @@ Proposition::Proposition()
     : cost(-1),
       reached_by(NO_OP),
       is_goal(false),
-      marked(false),
-      num_precondition_occurences(-1) {
+      marked(false) {
 }
 
 
-UnaryOperator::UnaryOperator(
+UnaryOperatorInfo::UnaryOperatorInfo(
     int num_preconditions, array_pool::ArrayPoolIndex preconditions,
     PropID effect, int operator_no, int base_cost)
     : effect(effect),
@@ -38,7 +38,7 @@ UnaryOperator::UnaryOperator(
 RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
     : Heuristic(opts) {
     // Build propositions.
-    propositions.resize(task_properties::get_num_facts(task_proxy));
+    initial_propositions.resize(task_properties::get_num_facts(task_proxy));
 
     // Build proposition offsets.
     VariablesProxy variables = task_proxy.get_variables();
@@ -48,19 +48,19 @@ RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
         proposition_offsets.push_back(offset);
         offset += var.get_domain_size();
     }
-    assert(offset == static_cast<int>(propositions.size()));
+    assert(offset == static_cast<int>(initial_propositions.size()));
 
     // Build goal propositions.
     GoalsProxy goals = task_proxy.get_goals();
     goal_propositions.reserve(goals.size());
     for (FactProxy goal : goals) {
         PropID prop_id = get_prop_id(goal);
-        propositions[prop_id].is_goal = true;
+        initial_propositions[prop_id].is_goal = true;
         goal_propositions.push_back(prop_id);
     }
 
     // Build unary operators for operators and axioms.
-    unary_operators.reserve(
+    unary_operator_infos.reserve(
         task_properties::get_num_total_effects(task_proxy));
     for (OperatorProxy op : task_proxy.get_operators())
         build_unary_operators(op);
@@ -73,21 +73,42 @@ RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
     utils::g_log << "time to simplify: " << simplify_timer << endl;
 
     // Cross-reference unary operators.
-    vector<vector<OpID>> precondition_of_vectors(propositions.size());
+    int num_propositions = initial_propositions.size();
+    vector<vector<OpID>> precondition_of_vectors(num_propositions);
 
-    int num_unary_ops = unary_operators.size();
+    int num_unary_ops = unary_operator_infos.size();
+    initial_unary_operators.resize(num_unary_ops);
     for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        const UnaryOperatorInfo &op = unary_operator_infos[op_id];
+        // The cost will be increased by the precondition costs.
+        initial_unary_operators[op_id].cost = op.base_cost;
+        initial_unary_operators[op_id].unsatisfied_preconditions =
+            op.num_preconditions;
+        if (op.num_preconditions == 0)
+            operators_without_preconditions.push_back(op_id);
         for (PropID precond : get_preconditions(op_id))
             precondition_of_vectors[precond].push_back(op_id);
     }
 
-    int num_propositions = propositions.size();
-    for (PropID prop_id = 0; prop_id < num_propositions; ++prop_id) {
-        const auto &precondition_of_vec = precondition_of_vectors[prop_id];
-        propositions[prop_id].precondition_of =
-            precondition_of_pool.append(precondition_of_vec);
-        propositions[prop_id].num_precondition_occurences = precondition_of_vec.size();
+    precondition_of.reserve(num_propositions);
+    num_precondition_occurences.reserve(num_propositions);
+    for (const vector<OpID> &precondition_of_vec : precondition_of_vectors) {
+        precondition_of.push_back(
+            precondition_of_pool.append(precondition_of_vec));
+        num_precondition_occurences.push_back(precondition_of_vec.size());
     }
+
+    propositions = initial_propositions;
+    unary_operators = initial_unary_operators;
+}
+
+void RelaxationHeuristic::reset_propositions_and_operators() {
+    assert(propositions.size() == initial_propositions.size());
+    assert(unary_operators.size() == initial_unary_operators.size());
+    memcpy(propositions.data(), initial_propositions.data(),
+           propositions.size() * sizeof(Proposition));
+    memcpy(unary_operators.data(), initial_unary_operators.data(),
+           unary_operators.size() * sizeof(UnaryOperator));
 }
 
 bool RelaxationHeuristic::dead_ends_are_reliable() const {
@@ -137,7 +158,7 @@ void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op) {
         utils::sort_unique(preconditions_copy);
         array_pool::ArrayPoolIndex precond_index =
             preconditions_pool.append(preconditions_copy);
-        unary_operators.emplace_back(
+        unary_operator_infos.emplace_back(
             preconditions_copy.size(), precond_index, effect_prop,
             op_no, base_cost);
         precondition_props.erase(precondition_props.end() - eff_conds.size(), precondition_props.end());
@@ -159,19 +180,19 @@ void RelaxationHeuristic::simplify() {
       3. cost(o1) <= cost(o2), and either
       4a. At least one of 2. and 3. is strict, or
       4b. id(o1) < id(o2).
-      (Here, "id" is the position in the unary_operators vector.)
+      (Here, "id" is the position in the unary_operator_infos vector.)
 
       This defines a strict partial order.
     */
 #ifndef NDEBUG
-    int num_ops = unary_operators.size();
+    int num_ops = unary_operator_infos.size();
     for (OpID op_id = 0; op_id < num_ops; ++op_id)
         assert(utils::is_sorted_unique(get_preconditions_vector(op_id)));
 #endif
 
     const int MAX_PRECONDITIONS_TO_TEST = 5;
 
-    utils::g_log << "Simplifying " << unary_operators.size() << " unary operators..." << flush;
+    utils::g_log << "Simplifying " << unary_operator_infos.size() << " unary operators..." << flush;
 
     /*
       First, we create a map that maps the preconditions and effect
@@ -192,10 +213,10 @@ void RelaxationHeuristic::simplify() {
     using Value = pair<int, OpID>;
     using Map = utils::HashMap<Key, Value>;
     Map unary_operator_index;
-    unary_operator_index.reserve(unary_operators.size());
+    unary_operator_index.reserve(unary_operator_infos.size());
 
-    for (size_t op_no = 0; op_no < unary_operators.size(); ++op_no) {
-        const UnaryOperator &op = unary_operators[op_no];
+    for (size_t op_no = 0; op_no < unary_operator_infos.size(); ++op_no) {
+        const UnaryOperatorInfo &op = unary_operator_infos[op_no];
         /*
           Note: we consider operators with more than
           MAX_PRECONDITIONS_TO_TEST preconditions here because we can
@@ -226,7 +247,7 @@ void RelaxationHeuristic::simplify() {
       is_dominated: test if a given operator is dominated by an
       operator in the map.
     */
-    auto is_dominated = [&](const UnaryOperator &op) {
+    auto is_dominated = [&](const UnaryOperatorInfo &op) {
             /*
               Check all possible subsets X of pre(op) to see if there is a
               dominating operator with preconditions X represented in the
@@ -286,13 +307,13 @@ void RelaxationHeuristic::simplify() {
             return false;
         };
 
-    unary_operators.erase(
+    unary_operator_infos.erase(
         remove_if(
-            unary_operators.begin(),
-            unary_operators.end(),
+            unary_operator_infos.begin(),
+            unary_operator_infos.end(),
             is_dominated),
-        unary_operators.end());
+        unary_operator_infos.end());
 
-    utils::g_log << " done! [" << unary_operators.size() << " unary operators]" << endl;
+    utils::g_log << " done! [" << unary_operator_infos.size() << " unary operators]" << endl;
 }
 }
@@ -16,12 +16,20 @@ class OperatorProxy;
 namespace relaxation_heuristic {
 struct Proposition;
 struct UnaryOperator;
+struct UnaryOperatorInfo;
 
 using PropID = int;
 using OpID = int;
 
 const OpID NO_OP = -1;
 
+/*
+  The explorations read and write the data of propositions and unary
+  operators in their innermost loops. We keep this data in small structs
+  that are stored in contiguous arrays and store all data that never
+  changes (UnaryOperatorInfo and the cross-references of propositions)
+  separately, so that the explorations touch as little memory as possible.
+*/
 struct Proposition {
     Proposition();
     int cost; // used for h^max cost or h^add cost
@@ -31,20 +39,22 @@ struct Proposition {
        not support packing ints and bools together in a bitfield. */
     unsigned int is_goal : 1;
     unsigned int marked : 1; // used for preferred operators of h^add and h^FF
-    int num_precondition_occurences;
-    array_pool::ArrayPoolIndex precondition_of;
 };
 
-static_assert(sizeof(Proposition) == 16, "Proposition has wrong size");
+static_assert(sizeof(Proposition) == 8, "Proposition has wrong size");
 
 struct UnaryOperator {
-    UnaryOperator(int num_preconditions,
-                  array_pool::ArrayPoolIndex preconditions,
-                  PropID effect,
-                  int operator_no, int base_cost);
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
+    int cost; // Used for h^add cost; includes operator cost (base_cost)
     int unsatisfied_preconditions;
+};
+
+static_assert(sizeof(UnaryOperator) == 8, "UnaryOperator has wrong size");
+
+struct UnaryOperatorInfo {
+    UnaryOperatorInfo(int num_preconditions,
+                      array_pool::ArrayPoolIndex preconditions,
+                      PropID effect,
+                      int operator_no, int base_cost);
     PropID effect;
     int base_cost;
     int num_preconditions;
@@ -52,27 +62,46 @@ struct UnaryOperator {
     int operator_no; // -1 for axioms; index into the task's operators otherwise
 };
 
-static_assert(sizeof(UnaryOperator) == 28, "UnaryOperator has wrong size");
-
 class RelaxationHeuristic : public Heuristic {
     void build_unary_operators(const OperatorProxy &op);
     void simplify();
 
     // proposition_offsets[var_no]: first PropID related to variable var_no
     std::vector<PropID> proposition_offsets;
+
+    /*
+      Values of propositions and unary operators at the start of each
+      exploration. Copying them is cheaper than resetting all fields
+      individually.
+    */
+    std::vector<Proposition> initial_propositions;
+    std::vector<UnaryOperator> initial_unary_operators;
 protected:
     std::vector<UnaryOperator> unary_operators;
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
 
+    std::vector<UnaryOperatorInfo> unary_operator_infos;
+    std::vector<OpID> operators_without_preconditions;
+
     array_pool::ArrayPool preconditions_pool;
     array_pool::ArrayPool precondition_of_pool;
+    std::vector<array_pool::ArrayPoolIndex> precondition_of;
+    std::vector<int> num_precondition_occurences;
 
     array_pool::ArrayPoolSlice get_preconditions(OpID op_id) const {
-        const UnaryOperator &op = unary_operators[op_id];
+        const UnaryOperatorInfo &op = unary_operator_infos[op_id];
         return preconditions_pool.get_slice(op.preconditions, op.num_preconditions);
     }
 
+    array_pool::ArrayPoolSlice get_precondition_of(PropID prop_id) const {
+        return precondition_of_pool.get_slice(
+            precondition_of[prop_id], num_precondition_occurences[prop_id]);
+    }
+
+    // Reset all propositions and unary operators for a new exploration.
+    void reset_propositions_and_operators();
+
     // HACK!
     std::vector<PropID> get_preconditions_vector(OpID op_id) const {
         auto view = get_preconditions(op_id);
@@ -90,9 +119,9 @@ protected:
         return prop_id;
     }
 
-    OpID get_op_id(const UnaryOperator &op) const {
-        OpID op_id = &op - unary_operators.data();
-        assert(utils::in_bounds(op_id, unary_operators));
+    OpID get_op_id(const UnaryOperatorInfo &op) const {
+        OpID op_id = &op - unary_operator_infos.data();
+        assert(utils::in_bounds(op_id, unary_operator_infos));
         return op_id;
     }
 
@@ -105,6 +134,9 @@ protected:
     UnaryOperator *get_operator(OpID op_id) {
         return &unary_operators[op_id];
     }
+    const UnaryOperatorInfo &get_operator_info(OpID op_id) const {
+        return unary_operator_infos[op_id];
+    }
 
     const Proposition *get_proposition(int var, int value) const;
     Proposition *get_proposition(int var, int value);
@@ -6,6 +6,7 @@
 
 #include "../utils/collections.h"
 #include "../utils/language.h"
+#include "../utils/logging.h"
 
 #include <algorithm>
 #include <cstdlib>
@@ -128,19 +129,45 @@ double LandmarkUniformSharedCostAssignment::cost_sharing_h_value(
     return h;
 }
 
+/*
+  Each cache entry needs one bit pair per landmark in its key, so we bound
+  the memory used by the keys rather than the number of entries.
+*/
+static const int64_t MAX_CACHE_BYTES = 64 << 20;
+
+static const int BITS_PER_STATUS = 2;
+static const int STATUSES_PER_WORD = 64 / BITS_PER_STATUS;
+
 LandmarkEfficientOptimalSharedCostAssignment::LandmarkEfficientOptimalSharedCostAssignment(
     const vector<int> &operator_costs, const LandmarkGraph &graph,
     lp::LPSolverType solver_type)
     : LandmarkCostAssignment(operator_costs, graph),
       lp_solver(solver_type),
-      lp(build_initial_lp()) {
+      num_cache_hits(0),
+      status_key(
+          (graph.get_num_landmarks() + STATUSES_PER_WORD - 1) / STATUSES_PER_WORD) {
+    int64_t bytes_per_entry = status_key.size() * sizeof(uint64_t) + 64;
+    max_cache_size = max<int64_t>(1, MAX_CACHE_BYTES / bytes_per_entry);
+    lp_solver.load_problem(build_lp());
+}
+
+LandmarkEfficientOptimalSharedCostAssignment::~LandmarkEfficientOptimalSharedCostAssignment() {
+    lp_solver.print_statistics();
+    utils::g_log << "Landmark cost partitioning cache hits: " << num_cache_hits
+                 << endl;
+    utils::g_log << "Landmark cost partitioning cache entries: " << cache.size()
+                 << endl;
 }
 
-lp::LinearProgram LandmarkEfficientOptimalSharedCostAssignment::build_initial_lp() {
-    /* The LP has one variable (column) per landmark and one
-       inequality (row) per operator. */
-    int num_cols = lm_graph.get_num_landmarks();
-    int num_rows = operator_costs.size();
+lp::LinearProgram LandmarkEfficientOptimalSharedCostAssignment::build_lp() {
+    /* The LP has two variables (columns) per landmark and one
+       inequality (row) per operator that achieves a landmark.
+       Variable lm_id represents the cost of landmark lm_id if it is not
+       reached and variable num_lms + lm_id represents its cost if it is
+       needed again. */
+    int num_lms = lm_graph.get_num_landmarks();
+    int num_cols = 2 * num_lms;
+    int num_ops = operator_costs.size();
 
     named_vector::NamedVector<lp::LPVariable> lp_variables;
 
@@ -148,18 +175,43 @@ lp::LinearProgram LandmarkEfficientOptimalSharedCostAssignment::build_initial_lp
        so the coefficients are all 1.
        Variable bounds are state-dependent; we initialize the range to {0}. */
     lp_variables.resize(num_cols, lp::LPVariable(0.0, 0.0, 1.0));
+    variable_upper_bounds.assign(num_cols, 0.0);
 
     /* Set up lower bounds and upper bounds for the inequalities.
        These simply say that the operator's total cost must fall
-       between 0 and the real operator cost. */
-    lp_constraints.resize(num_rows, lp::LPConstraint(0.0, 0.0));
-    for (size_t op_id = 0; op_id < operator_costs.size(); ++op_id) {
-        lp_constraints[op_id].set_lower_bound(0);
-        lp_constraints[op_id].set_upper_bound(operator_costs[op_id]);
+       between 0 and the real operator cost.
+
+       The constraints are of the form
+       cost(lm_i1) + cost(lm_i2) + ... + cost(lm_in) <= cost(o)
+       where lm_i1 ... lm_in are the landmarks for which o is a
+       relevant achiever. Hence, we add a triple (op, lm, 1.0)
+       for each relevant achiever op of landmark lm, denoting that
+       in the op-th row and lm-th column, the matrix has a 1.0 entry. */
+    vector<lp::LPConstraint> constraints(num_ops, lp::LPConstraint(0.0, 0.0));
+    for (int op_id = 0; op_id < num_ops; ++op_id) {
+        constraints[op_id].set_upper_bound(operator_costs[op_id]);
+    }
+    for (int lm_id = 0; lm_id < num_lms; ++lm_id) {
+        const LandmarkNode *lm = lm_graph.get_landmark(lm_id);
+        for (int op_id : lm->first_achievers) {
+            assert(utils::in_bounds(op_id, constraints));
+            constraints[op_id].insert(lm_id, 1.0);
+        }
+        for (int op_id : lm->possible_achievers) {
+            assert(utils::in_bounds(op_id, constraints));
+            constraints[op_id].insert(num_lms + lm_id, 1.0);
+        }
+    }
+
+    /* Only use non-empty constraints in the LP.
+       This significantly speeds up the heuristic calculation. See issue443. */
+    named_vector::NamedVector<lp::LPConstraint> lp_constraints;
+    for (lp::LPConstraint &constraint : constraints) {
+        if (!constraint.empty())
+            lp_constraints.push_back(move(constraint));
     }
 
-    // Coefficients of constraints will be updated and recreated in each state. We ignore them for the initial LP.
-    return lp::LinearProgram(lp::LPObjectiveSense::MAXIMIZE, move(lp_variables), named_vector::NamedVector<lp::LPConstraint>());
+    return lp::LinearProgram(lp::LPObjectiveSense::MAXIMIZE, move(lp_variables), move(lp_constraints));
 }
 
 double LandmarkEfficientOptimalSharedCostAssignment::cost_sharing_h_value(
@@ -167,64 +219,52 @@ double LandmarkEfficientOptimalSharedCostAssignment::cost_sharing_h_value(
     /* TODO: We could also do the same thing with action landmarks we
              do in the uniform cost partitioning case. */
 
+    int num_lms = lm_graph.get_num_landmarks();
+    fill(status_key.begin(), status_key.end(), 0);
+    for (int lm_id = 0; lm_id < num_lms; ++lm_id) {
+        uint64_t status = lm_status_manager.get_landmark_status(lm_id);
+        status_key[lm_id / STATUSES_PER_WORD] |=
+            status << (BITS_PER_STATUS * (lm_id % STATUSES_PER_WORD));
+    }
+    auto it = cache.find(status_key);
+    if (it != cache.end()) {
+        ++num_cache_hits;
+        return it->second;
+    }
+
     /*
       Set up LP variable bounds for the landmarks.
       The range of cost(lm_1) is {0} if the landmark is already
-      reached; otherwise it is [0, infinity].
+      reached; otherwise it is [0, infinity] for the variable that
+      belongs to the status of the landmark and {0} for the other one.
       The lower bounds are set to 0 in the constructor and never change.
     */
-    int num_cols = lm_graph.get_num_landmarks();
-    for (int lm_id = 0; lm_id < num_cols; ++lm_id) {
-        if (lm_status_manager.get_landmark_status(lm_id) == lm_reached) {
-            lp.get_variables()[lm_id].upper_bound = 0;
-        } else {
-            lp.get_variables()[lm_id].upper_bound = lp_solver.get_infinity();
-        }
-    }
-
-    /*
-      Define the constraint matrix. The constraints are of the form
-      cost(lm_i1) + cost(lm_i2) + ... + cost(lm_in) <= cost(o)
-      where lm_i1 ... lm_in are the landmarks for which o is a
-      relevant achiever. Hence, we add a triple (op, lm, 1.0)
-      for each relevant achiever op of landmark lm, denoting that
-      in the op-th row and lm-th column, the matrix has a 1.0 entry.
-    */
-    // Reuse previous constraint objects to save the effort of recreating them.
-    for (lp::LPConstraint &constraint : lp_constraints) {
-        constraint.clear();
-    }
-    for (int lm_id = 0; lm_id < num_cols; ++lm_id) {
-        const LandmarkNode *lm = lm_graph.get_landmark(lm_id);
+    double infinity = lp_solver.get_infinity();
+    for (int lm_id = 0; lm_id < num_lms; ++lm_id) {
         int lm_status = lm_status_manager.get_landmark_status(lm_id);
-        if (lm_status != lm_reached) {
-            const set<int> &achievers = get_achievers(lm_status, *lm);
-            assert(!achievers.empty());
-            for (int op_id : achievers) {
-                assert(utils::in_bounds(op_id, lp_constraints));
-                lp_constraints[op_id].insert(lm_id, 1.0);
-            }
+        assert(lm_status == lm_reached ||
+               !get_achievers(lm_status, *lm_graph.get_landmark(lm_id)).empty());
+        double not_reached_bound = lm_status == lm_not_reached ? infinity : 0;
+        double needed_again_bound = lm_status == lm_needed_again ? infinity : 0;
+        if (variable_upper_bounds[lm_id] != not_reached_bound) {
+            variable_upper_bounds[lm_id] = not_reached_bound;
+            lp_solver.set_variable_upper_bound(lm_id, not_reached_bound);
+        }
+        if (variable_upper_bounds[num_lms + lm_id] != needed_again_bound) {
+            variable_upper_bounds[num_lms + lm_id] = needed_again_bound;
+            lp_solver.set_variable_upper_bound(num_lms + lm_id, needed_again_bound);
         }
     }
 
-    /* Copy non-empty constraints and use those in the LP.
-       This significantly speeds up the heuristic calculation. See issue443. */
-    // TODO: do not copy the data here.
-    lp.get_constraints().clear();
-    for (const lp::LPConstraint &constraint : lp_constraints) {
-        if (!constraint.empty())
-            lp.get_constraints().push_back(constraint);
-    }
-
-    // Load the problem into the LP solver.
-    lp_solver.load_problem(lp);
-
-    // Solve the linear program.
+    // Solve the linear program, starting from the basis of the last solve.
     lp_solver.solve();
 
     assert(lp_solver.has_optimal_solution());
     double h = lp_solver.get_objective_value();
 
+    if (static_cast<int>(cache.size()) >= max_cache_size)
+        cache.clear();
+    cache[status_key] = h;
     return h;
 }
 }
@@ -2,7 +2,9 @@
 #define LANDMARKS_LANDMARK_COST_ASSIGNMENT_H
 
 #include "../lp/lp_solver.h"
+#include "../utils/hash.h"
 
+#include <cstdint>
 #include <set>
 #include <vector>
 
@@ -43,22 +45,32 @@ public:
 
 class LandmarkEfficientOptimalSharedCostAssignment : public LandmarkCostAssignment {
     lp::LPSolver lp_solver;
-    // We keep an additional copy of the constraints around to avoid some effort with recreating the vector (see issue443).
-    std::vector<lp::LPConstraint> lp_constraints;
     /*
-      We keep the vectors for LP variables and constraints around instead of
-      recreating them for every state. The actual constraints have to be
-      recreated because the coefficient matrix of the LP changes from state to
-      state. Reusing the vectors still saves some dynamic allocation overhead.
-     */
-    lp::LinearProgram lp;
+      The LP stays loaded in the solver for the whole search. It has two
+      variables per landmark: the first one is restricted by the first
+      achievers and the second one by all possible achievers. The status of
+      a landmark only decides which of them may be positive, so only
+      variable bounds change between states and the solver can start from
+      the basis of the previous solve.
+    */
+    std::vector<double> variable_upper_bounds;
 
-    lp::LinearProgram build_initial_lp();
+    /*
+      Cache for heuristic values. The key stores the landmark status of
+      each landmark in two bits.
+    */
+    utils::HashMap<std::vector<uint64_t>, double> cache;
+    int max_cache_size;
+    int64_t num_cache_hits;
+    std::vector<uint64_t> status_key;
+
+    lp::LinearProgram build_lp();
 public:
     LandmarkEfficientOptimalSharedCostAssignment(
         const std::vector<int> &operator_costs,
         const LandmarkGraph &graph,
         lp::LPSolverType solver_type);
+    virtual ~LandmarkEfficientOptimalSharedCostAssignment() override;
 
     virtual double cost_sharing_h_value(
         const LandmarkStatusManager &lm_status_manager) override;
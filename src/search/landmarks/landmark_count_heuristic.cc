@@ -98,6 +98,10 @@ LandmarkCountHeuristic::LandmarkCountHeuristic(const options::Options &opts)
     }
 }
 
+LandmarkCountHeuristic::~LandmarkCountHeuristic() {
+    lm_status_manager->print_statistics();
+}
+
 int LandmarkCountHeuristic::get_heuristic_value(const State &ancestor_state) {
     double epsilon = 0.01;
 
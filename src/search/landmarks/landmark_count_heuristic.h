@@ -43,6 +43,7 @@ protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit LandmarkCountHeuristic(const options::Options &opts);
+    virtual ~LandmarkCountHeuristic() override;
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override {
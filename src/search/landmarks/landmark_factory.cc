@@ -8,24 +8,246 @@
 #include "../plugin.h"
 #include "../task_proxy.h"
 
+#include "../task_utils/bit_parallel_reachability.h"
+#include "../task_utils/task_properties.h"
+
+#include "../utils/cache_file.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/memory_mapped_file.h"
 #include "../utils/timer.h"
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 
 using namespace std;
 
 namespace landmarks {
+/*
+  The payload of a cache file (see utils::CacheFile) is a sequence of ints in
+  native byte order. It starts with the number of landmarks. For each
+  landmark, ordered by ID, it contains the type (simple, disjunctive or
+  conjunctive), the number of facts followed by the variable-value pairs, the
+  flags is_true_in_goal, cost and is_derived, the first achievers and possible
+  achievers (each preceded by their number) and the number of outgoing
+  orderings followed by the child ID and edge type of each ordering.
+*/
+static const int CACHE_FILE_MAGIC = 0x4c4d4b47;
+static const int CACHE_FILE_VERSION = 2;
+
+enum class CachedLandmarkType {
+    SIMPLE = 0,
+    DISJUNCTIVE = 1,
+    CONJUNCTIVE = 2
+};
+
+/*
+  Reads the ints of a cache file payload and checks that they lie in the expected
+  ranges, so that corrupt files cannot produce invalid landmark graphs.
+*/
+class PayloadReader {
+    const int *data;
+    size_t size;
+    size_t pos;
+public:
+    PayloadReader(const int *data, size_t size)
+        : data(data), size(size), pos(0) {
+    }
+
+    // Read the next int and check that it lies in [min_value, max_value].
+    bool read(int &value,
+              int min_value = numeric_limits<int>::min(),
+              int max_value = numeric_limits<int>::max()) {
+        if (pos == size)
+            return false;
+        value = data[pos++];
+        return value >= min_value && value <= max_value;
+    }
+
+    bool at_end() const {
+        return pos == size;
+    }
+};
+
+static bool read_achievers(
+    PayloadReader &reader, const TaskProxy &task_proxy, set<int> &achievers) {
+    int num_operators = task_proxy.get_operators().size();
+    int num_axioms = task_proxy.get_axioms().size();
+    int num_achievers;
+    if (!reader.read(num_achievers, 0, num_operators + num_axioms))
+        return false;
+    for (int i = 0; i < num_achievers; ++i) {
+        // Axioms are stored as -id - 1 (see get_operator_or_axiom_id()).
+        int op_or_axiom_id;
+        if (!reader.read(op_or_axiom_id, -num_axioms, num_operators - 1))
+            return false;
+        achievers.insert(op_or_axiom_id);
+    }
+    return true;
+}
+
+static bool read_landmark_graph(
+    PayloadReader &reader, const TaskProxy &task_proxy, LandmarkGraph &graph) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_landmarks;
+    if (!reader.read(num_landmarks, 0))
+        return false;
+    vector<vector<pair<int, int>>> orderings(num_landmarks);
+    for (int id = 0; id < num_landmarks; ++id) {
+        int type;
+        int num_facts;
+        if (!reader.read(type, 0, static_cast<int>(CachedLandmarkType::CONJUNCTIVE)) ||
+            !reader.read(num_facts, 1))
+            return false;
+        set<FactPair> facts;
+        for (int i = 0; i < num_facts; ++i) {
+            int var;
+            int value;
+            if (!reader.read(var, 0, variables.size() - 1) ||
+                !reader.read(value, 0, variables[var].get_domain_size() - 1))
+                return false;
+            if (!facts.insert(FactPair(var, value)).second)
+                return false;
+        }
+
+        /*
+          The graph looks up simple and disjunctive landmarks by their facts,
+          so these facts may not occur in several such landmarks. Facts of
+          conjunctive landmarks are not indexed.
+        */
+        if (static_cast<CachedLandmarkType>(type) != CachedLandmarkType::CONJUNCTIVE &&
+            any_of(facts.begin(), facts.end(), [&](const FactPair &fact) {
+                       return graph.contains_landmark(fact);
+                   }))
+            return false;
+
+        LandmarkNode *node;
+        if (static_cast<CachedLandmarkType>(type) == CachedLandmarkType::SIMPLE) {
+            if (num_facts != 1)
+                return false;
+            node = &graph.add_simple_landmark(*facts.begin());
+        } else if (static_cast<CachedLandmarkType>(type) ==
+                   CachedLandmarkType::DISJUNCTIVE) {
+            node = &graph.add_disjunctive_landmark(facts);
+        } else {
+            node = &graph.add_conjunctive_landmark(facts);
+        }
+
+        int is_true_in_goal;
+        int is_derived;
+        if (!reader.read(is_true_in_goal, 0, 1) ||
+            !reader.read(node->cost, 0) ||
+            !reader.read(is_derived, 0, 1) ||
+            !read_achievers(reader, task_proxy, node->first_achievers) ||
+            !read_achievers(reader, task_proxy, node->possible_achievers))
+            return false;
+        node->is_true_in_goal = is_true_in_goal;
+        node->is_derived = is_derived;
+
+        int num_children;
+        if (!reader.read(num_children, 0, num_landmarks - 1))
+            return false;
+        for (int i = 0; i < num_children; ++i) {
+            int child_id;
+            int edge_type;
+            if (!reader.read(child_id, 0, num_landmarks - 1) ||
+                !reader.read(edge_type,
+                             static_cast<int>(EdgeType::OBEDIENT_REASONABLE),
+                             static_cast<int>(EdgeType::NECESSARY)) ||
+                child_id == id)
+                return false;
+            orderings[id].emplace_back(child_id, edge_type);
+        }
+    }
+    if (!reader.at_end())
+        return false;
+
+    graph.set_landmark_ids();
+    for (int id = 0; id < num_landmarks; ++id) {
+        LandmarkNode *parent = graph.get_landmark(id);
+        for (const pair<int, int> &ordering : orderings[id]) {
+            LandmarkNode *child = graph.get_landmark(ordering.first);
+            EdgeType type = static_cast<EdgeType>(ordering.second);
+            if (!parent->children.emplace(child, type).second)
+                return false;
+            child->parents.emplace(parent, type);
+        }
+    }
+    return true;
+}
+
+static shared_ptr<LandmarkGraph> read_cache_file(
+    const utils::CacheFile &cache_file, const TaskProxy &task_proxy) {
+    shared_ptr<LandmarkGraph> graph;
+    auto read_payload = [&](const char *data, size_t size) {
+            if (size % sizeof(int) != 0)
+                return false;
+            PayloadReader reader(
+                reinterpret_cast<const int *>(data), size / sizeof(int));
+            graph = make_shared<LandmarkGraph>();
+            return read_landmark_graph(reader, task_proxy, *graph);
+        };
+    if (!cache_file.read(read_payload))
+        return nullptr;
+    utils::g_log << "Read landmark graph from cache file "
+                 << cache_file.get_filename() << "." << endl;
+    return graph;
+}
+
+static void write_cache_file(
+    const utils::CacheFile &cache_file, const LandmarkGraph &graph) {
+    vector<int> data;
+    data.push_back(graph.get_num_landmarks());
+    for (const unique_ptr<LandmarkNode> &node : graph.get_nodes()) {
+        assert(graph.get_landmark(node->get_id()) == node.get());
+        CachedLandmarkType type = CachedLandmarkType::SIMPLE;
+        if (node->disjunctive)
+            type = CachedLandmarkType::DISJUNCTIVE;
+        else if (node->conjunctive)
+            type = CachedLandmarkType::CONJUNCTIVE;
+        data.push_back(static_cast<int>(type));
+        data.push_back(node->facts.size());
+        for (const FactPair &fact : node->facts) {
+            data.push_back(fact.var);
+            data.push_back(fact.value);
+        }
+        data.push_back(node->is_true_in_goal);
+        data.push_back(node->cost);
+        data.push_back(node->is_derived);
+        for (const set<int> *achievers :
+             {&node->first_achievers, &node->possible_achievers}) {
+            data.push_back(achievers->size());
+            data.insert(data.end(), achievers->begin(), achievers->end());
+        }
+        data.push_back(node->children.size());
+        for (const auto &child : node->children) {
+            data.push_back(child.first->get_id());
+            data.push_back(static_cast<int>(child.second));
+        }
+    }
+
+    bool written = cache_file.write([&](ostream &stream) {
+                                        stream.write(
+                                            reinterpret_cast<const char *>(data.data()),
+                                            data.size() * sizeof(int));
+                                    });
+    if (written) {
+        utils::g_log << "Wrote landmark graph to cache file "
+                     << cache_file.get_filename() << "." << endl;
+    }
+}
+
 LandmarkFactory::LandmarkFactory(const options::Options &opts)
     : reasonable_orders(opts.get<bool>("reasonable_orders")),
       only_causal_landmarks(opts.get<bool>("only_causal_landmarks")),
       disjunctive_landmarks(opts.get<bool>("disjunctive_landmarks")),
       conjunctive_landmarks(opts.get<bool>("conjunctive_landmarks")),
       no_orders(opts.get<bool>("no_orders")),
-      lm_graph_task(nullptr) {
+      lm_graph_task(nullptr),
+      opts(opts) {
 }
+
 /*
   TODO: Update this comment
 
@@ -61,11 +283,21 @@ shared_ptr<LandmarkGraph> LandmarkFactory::compute_lm_graph(
     lm_graph_task = task.get();
     utils::Timer lm_generation_timer;
 
-    lm_graph = make_shared<LandmarkGraph>();
-
     TaskProxy task_proxy(*task);
-    generate_operators_lookups(task_proxy);
-    generate_landmarks(task);
+    unique_ptr<utils::CacheFile> cache_file =
+        utils::parse_cache_file_from_options(
+            opts, "landmarks", task_properties::compute_task_fingerprint(task_proxy),
+            CACHE_FILE_MAGIC, CACHE_FILE_VERSION);
+    if (cache_file) {
+        lm_graph = read_cache_file(*cache_file, task_proxy);
+    }
+    if (!lm_graph) {
+        lm_graph = make_shared<LandmarkGraph>();
+        generate_operators_lookups(task_proxy);
+        generate_landmarks(task);
+        if (cache_file)
+            write_cache_file(*cache_file, *lm_graph);
+    }
 
     utils::g_log << "Landmarks generation time: " << lm_generation_timer << endl;
     if (lm_graph->get_num_landmarks() == 0)
@@ -489,6 +721,64 @@ void LandmarkFactory::discard_conjunctive_landmarks() {
     }
 }
 
+void LandmarkFactory::discard_noncausal_landmarks(const TaskProxy &task_proxy) {
+    /*
+      A landmark is causal if it is true in the goal or if the relaxed task
+      is unsolvable without the operators that have the landmark as a
+      precondition. We test up to NUM_LANES landmarks in one exploration.
+    */
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<vector<vector<int>>> operators_by_precondition(variables.size());
+    for (VariableProxy var : variables)
+        operators_by_precondition[var.get_id()].resize(var.get_domain_size());
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        for (FactProxy pre : op.get_preconditions()) {
+            FactPair fact = pre.get_pair();
+            operators_by_precondition[fact.var][fact.value].push_back(op.get_id());
+        }
+    }
+
+    vector<const LandmarkNode *> candidates;
+    for (auto &node : lm_graph->get_nodes()) {
+        if (!node->is_true_in_goal)
+            candidates.push_back(node.get());
+    }
+
+    const int num_lanes = bit_parallel_reachability::BitParallelReachability::NUM_LANES;
+    bit_parallel_reachability::BitParallelReachability reachability(task_proxy);
+    State initial_state = task_proxy.get_initial_state();
+    vector<FactPair> goals = task_properties::get_fact_pairs(task_proxy.get_goals());
+    unordered_set<const LandmarkNode *> noncausal_landmarks;
+    for (size_t begin = 0; begin < candidates.size(); begin += num_lanes) {
+        size_t end = min(candidates.size(), begin + num_lanes);
+        reachability.clear();
+        for (size_t i = begin; i < end; ++i) {
+            int lane = i - begin;
+            reachability.add_initial_state(lane, initial_state);
+            for (const FactPair &lm_fact : candidates[i]->facts) {
+                for (int op_id : operators_by_precondition[lm_fact.var][lm_fact.value])
+                    reachability.exclude_operator(lane, op_id);
+            }
+        }
+        reachability.run();
+        bit_parallel_reachability::LaneMask solvable =
+            reachability.get_lanes_reaching_all(goals);
+        for (size_t i = begin; i < end; ++i) {
+            if (solvable & (bit_parallel_reachability::LaneMask(1) << (i - begin)))
+                noncausal_landmarks.insert(candidates[i]);
+        }
+    }
+
+    int num_all_landmarks = lm_graph->get_num_landmarks();
+    lm_graph->remove_node_if(
+        [&noncausal_landmarks](const LandmarkNode &node) {
+            return noncausal_landmarks.count(&node);
+        });
+    int num_causal_landmarks = lm_graph->get_num_landmarks();
+    utils::g_log << "Discarded " << num_all_landmarks - num_causal_landmarks
+                 << " non-causal landmarks" << endl;
+}
+
 void LandmarkFactory::discard_all_orderings() {
     utils::g_log << "Removing all orderings." << endl;
     for (auto &node : lm_graph->get_nodes()) {
@@ -642,6 +932,7 @@ void _add_options_to_parser(OptionParser &parser) {
     parser.add_option<bool>("no_orders",
                             "discard all orderings",
                             "false");
+    utils::add_cache_dir_option_to_parser(parser);
 }
 
 
@@ -3,6 +3,8 @@
 
 #include "landmark_graph.h"
 
+#include "../options/options.h"
+
 #include <list>
 #include <map>
 #include <memory>
@@ -55,6 +57,7 @@ protected:
 
     void discard_disjunctive_landmarks();
     void discard_conjunctive_landmarks();
+    void discard_noncausal_landmarks(const TaskProxy &task_proxy);
     void discard_all_orderings();
     void approximate_reasonable_orders(
         const TaskProxy &task_proxy, bool obedient_orders);
@@ -69,6 +72,8 @@ protected:
 
 private:
     AbstractTask *lm_graph_task;
+    // Needed to find the cache file once the task is known.
+    const options::Options opts;
 
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task) = 0;
 
@@ -1,7 +1,5 @@
 #include "landmark_factory_h_m.h"
 
-#include "exploration.h"
-
 #include "../abstract_task.h"
 #include "../option_parser.h"
 #include "../plugin.h"
@@ -9,6 +7,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 #include "../utils/system.h"
 
 using namespace std;
@@ -479,8 +478,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
         unsat_pc_count_[op.get_id()].first = pc_subsets.size();
 
         for (const FluentSet &pc_subset : pc_subsets) {
-            assert(set_indices_.find(pc_subset) != set_indices_.end());
-            set_index = set_indices_[pc_subset];
+            set_index = get_set_index(pc_subset);
             pm_op.pc.push_back(set_index);
             h_m_table_[set_index].pc_for.emplace_back(op.get_id(), -1);
         }
@@ -491,8 +489,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
         pm_op.eff.reserve(eff_subsets.size());
 
         for (const FluentSet &eff_subset : eff_subsets) {
-            assert(set_indices_.find(eff_subset) != set_indices_.end());
-            set_index = set_indices_[eff_subset];
+            set_index = get_set_index(eff_subset);
             pm_op.eff.push_back(set_index);
         }
 
@@ -502,10 +499,9 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
         // they conflict with the effect of the operator (no need to check pc
         // because mvvs appearing in pc also appear in effect
 
-        FluentSetToIntMap::const_iterator it = set_indices_.begin();
-        while (static_cast<int>(it->first.size()) < m_
-               && it != set_indices_.end()) {
-            if (possible_noop_set(variables, eff, it->first)) {
+        for (int small_set_index : small_set_indices_) {
+            const FluentSet &small_set = h_m_table_[small_set_index].fluents;
+            if (possible_noop_set(variables, eff, small_set)) {
                 // for each such set, add a "conditional effect" to the operator
                 pm_op.cond_noops.resize(pm_op.cond_noops.size() + 1);
 
@@ -517,8 +513,8 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                 // get the subsets that have >= 1 element in the pc (unless pc is empty)
                 // and >= 1 element in the other set
 
-                get_split_m_sets(variables, m_, noop_pc_subsets, pc, it->first);
-                get_split_m_sets(variables, m_, noop_eff_subsets, eff, it->first);
+                get_split_m_sets(variables, m_, noop_pc_subsets, pc, small_set);
+                get_split_m_sets(variables, m_, noop_eff_subsets, eff, small_set);
 
                 this_cond_noop.reserve(noop_pc_subsets.size() + noop_eff_subsets.size() + 1);
 
@@ -527,9 +523,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                 // push back all noop preconditions
                 for (size_t j = 0; j < noop_pc_subsets.size(); ++j) {
                     assert(static_cast<int>(noop_pc_subsets[j].size()) <= m_);
-                    assert(set_indices_.find(noop_pc_subsets[j]) != set_indices_.end());
-
-                    set_index = set_indices_[noop_pc_subsets[j]];
+                    set_index = get_set_index(noop_pc_subsets[j]);
                     this_cond_noop.push_back(set_index);
                     // these facts are "conditional pcs" for this action
                     h_m_table_[set_index].pc_for.emplace_back(op.get_id(), noop_index);
@@ -541,20 +535,23 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
                 // and the noop effects
                 for (size_t j = 0; j < noop_eff_subsets.size(); ++j) {
                     assert(static_cast<int>(noop_eff_subsets[j].size()) <= m_);
-                    assert(set_indices_.find(noop_eff_subsets[j]) != set_indices_.end());
-
-                    set_index = set_indices_[noop_eff_subsets[j]];
+                    set_index = get_set_index(noop_eff_subsets[j]);
                     this_cond_noop.push_back(set_index);
                 }
 
                 ++noop_index;
             }
-            ++it;
         }
         //    print_pm_op(pm_ops_[i]);
     }
 }
 
+int LandmarkFactoryHM::get_set_index(const FluentSet &fs) const {
+    int set_index = set_indices_[tuple_index_->get_tuple_id(fs)];
+    assert(set_index != -1);
+    return set_index;
+}
+
 bool LandmarkFactoryHM::interesting(const VariablesProxy &variables,
                                     const FactPair &fact1, const FactPair &fact2) const {
     // mutexes can always be safely pruned
@@ -578,21 +575,29 @@ void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
     get_m_sets(task_proxy.get_variables(), m_, msets);
 
     // map each set to an integer
+    tuple_index_ = utils::make_unique_ptr<fact_tuple_index::FactTupleIndex>(
+        task_proxy, m_);
+    set_indices_.assign(tuple_index_->get_num_tuples(), -1);
     for (size_t i = 0; i < msets.size(); ++i) {
         h_m_table_.emplace_back();
-        set_indices_[msets[i]] = i;
+        set_indices_[tuple_index_->get_tuple_id(msets[i])] = i;
         h_m_table_[i].fluents = msets[i];
+        if (static_cast<int>(msets[i].size()) < m_)
+            small_set_indices_.push_back(i);
     }
+    sort(small_set_indices_.begin(), small_set_indices_.end(),
+         [&](int index1, int index2) {
+             return FluentSetComparer()(h_m_table_[index1].fluents,
+                                        h_m_table_[index2].fluents);
+         });
     utils::g_log << "Using " << h_m_table_.size() << " P^m fluents." << endl;
 
     build_pm_ops(task_proxy);
 }
 
 void LandmarkFactoryHM::generate(const TaskProxy &task_proxy) {
-    if (only_causal_landmarks) {
-        Exploration exploration(task_proxy);
-        discard_noncausal_landmarks(task_proxy, exploration);
-    }
+    if (only_causal_landmarks)
+        discard_noncausal_landmarks(task_proxy);
     if (!disjunctive_landmarks)
         discard_disjunctive_landmarks();
     if (!conjunctive_landmarks)
@@ -611,57 +616,6 @@ void LandmarkFactoryHM::generate(const TaskProxy &task_proxy) {
     calc_achievers(task_proxy);
 }
 
-void LandmarkFactoryHM::discard_noncausal_landmarks(
-    const TaskProxy &task_proxy, Exploration &exploration) {
-    int num_all_landmarks = lm_graph->get_num_landmarks();
-    lm_graph->remove_node_if(
-        [this, &task_proxy, &exploration](const LandmarkNode &node) {
-            return !is_causal_landmark(task_proxy, exploration, node);
-        });
-    int num_causal_landmarks = lm_graph->get_num_landmarks();
-    utils::g_log << "Discarded " << num_all_landmarks - num_causal_landmarks
-                 << " non-causal landmarks" << endl;
-}
-
-bool LandmarkFactoryHM::is_causal_landmark(
-    const TaskProxy &task_proxy, Exploration &exploration,
-    const LandmarkNode &landmark) const {
-    /* Test whether the relaxed planning task is unsolvable without using any operator
-       that has "landmark" as a precondition.
-       Similar to "relaxed_task_solvable" above.
-     */
-
-    if (landmark.is_true_in_goal)
-        return true;
-    vector<vector<int>> lvl_var;
-    vector<utils::HashMap<FactPair, int>> lvl_op;
-    // Initialize lvl_var to numeric_limits<int>::max()
-    VariablesProxy variables = task_proxy.get_variables();
-    lvl_var.resize(variables.size());
-    for (VariableProxy var : variables) {
-        lvl_var[var.get_id()].resize(var.get_domain_size(),
-                                     numeric_limits<int>::max());
-    }
-    unordered_set<int> exclude_op_ids;
-    vector<FactPair> exclude_props;
-    for (OperatorProxy op : task_proxy.get_operators()) {
-        if (is_landmark_precondition(op, &landmark)) {
-            exclude_op_ids.insert(op.get_id());
-        }
-    }
-    // Do relaxed exploration
-    exploration.compute_reachability_with_excludes(
-        lvl_var, lvl_op, true, exclude_props, exclude_op_ids, false);
-
-    // Test whether all goal propositions have a level of less than numeric_limits<int>::max()
-    for (FactProxy goal : task_proxy.get_goals())
-        if (lvl_var[goal.get_variable().get_id()][goal.get_value()] ==
-            numeric_limits<int>::max())
-            return true;
-
-    return false;
-}
-
 void LandmarkFactoryHM::calc_achievers(const TaskProxy &task_proxy) {
     utils::g_log << "Calculating achievers." << endl;
 
@@ -723,7 +677,9 @@ void LandmarkFactoryHM::free_unneeded_memory() {
     utils::release_vector_memory(pm_ops_);
     utils::release_vector_memory(unsat_pc_count_);
 
-    set_indices_.clear();
+    tuple_index_ = nullptr;
+    utils::release_vector_memory(set_indices_);
+    utils::release_vector_memory(small_set_indices_);
     lm_node_table_.clear();
 }
 
@@ -773,7 +729,7 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
 
     // for all of the initial state <= m subsets, mark level = 0
     for (size_t i = 0; i < init_subsets.size(); ++i) {
-        int index = set_indices_[init_subsets[i]];
+        int index = get_set_index(init_subsets[i]);
         h_m_table_[index].level = 0;
 
         // set actions to be applied
@@ -981,13 +937,12 @@ void LandmarkFactoryHM::generate_landmarks(
     // now construct landmarks graph
     vector<FluentSet> goal_subsets;
     FluentSet goals = task_properties::get_fact_pairs(task_proxy.get_goals());
+    sort(goals.begin(), goals.end());
     VariablesProxy variables = task_proxy.get_variables();
     get_m_sets(variables, m_, goal_subsets, goals);
     list<int> all_lms;
     for (const FluentSet &goal_subset : goal_subsets) {
-        assert(set_indices_.find(goal_subset) != set_indices_.end());
-
-        int set_index = set_indices_[goal_subset];
+        int set_index = get_set_index(goal_subset);
 
         if (h_m_table_[set_index].level == -1) {
             utils::g_log << endl << endl << "Subset of goal not reachable !!." << endl << endl << endl;
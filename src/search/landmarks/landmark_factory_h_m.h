@@ -3,9 +3,9 @@
 
 #include "landmark_factory.h"
 
-namespace landmarks {
-class Exploration;
+#include "../task_utils/fact_tuple_index.h"
 
+namespace landmarks {
 using FluentSet = std::vector<FactPair>;
 
 std::ostream &
@@ -56,8 +56,6 @@ struct HMEntry {
     }
 };
 
-using FluentSetToIntMap = std::map<FluentSet, int, FluentSetComparer>;
-
 class LandmarkFactoryHM : public LandmarkFactory {
     using TriggerSet = std::unordered_map<int, std::set<int>>;
 
@@ -83,14 +81,6 @@ class LandmarkFactoryHM : public LandmarkFactory {
 
     void generate(const TaskProxy &task_proxy);
 
-    // TODO: this is duplicated here and in LandmarkFactoryRelaxation
-    void discard_noncausal_landmarks(const TaskProxy &task_proxy,
-                                     Exploration &exploration);
-    // TODO: this is duplicated here and in LandmarkFactoryRelaxation
-    bool is_causal_landmark(const TaskProxy &task_proxy,
-                            Exploration &exploration,
-                            const LandmarkNode &landmark) const;
-
     void calc_achievers(const TaskProxy &task_proxy);
 
     void add_lm_node(int set_index, bool goal = false);
@@ -99,6 +89,8 @@ class LandmarkFactoryHM : public LandmarkFactory {
     void free_unneeded_memory();
 
     void print_fluentset(const VariablesProxy &variables, const FluentSet &fs);
+
+    int get_set_index(const FluentSet &fs) const;
     void print_pm_op(const VariablesProxy &variables, const PMOp &op);
 
     const int m_;
@@ -107,8 +99,12 @@ class LandmarkFactoryHM : public LandmarkFactory {
 
     std::vector<HMEntry> h_m_table_;
     std::vector<PMOp> pm_ops_;
-    // maps each <m set to an int
-    FluentSetToIntMap set_indices_;
+    std::unique_ptr<fact_tuple_index::FactTupleIndex> tuple_index_;
+    // maps the tuple ID of each set of size <= m to its index in
+    // h_m_table_ (-1 for sets that contain mutex facts)
+    std::vector<int> set_indices_;
+    // indices of the sets of size < m, ordered by FluentSetComparer
+    std::vector<int> small_set_indices_;
     // first is unsat pcs for operator
     // second is unsat pcs for conditional noops
     std::vector<std::pair<int, std::vector<int>>> unsat_pc_count_;
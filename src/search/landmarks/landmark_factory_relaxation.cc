@@ -1,6 +1,9 @@
 #include "landmark_factory_relaxation.h"
 
 #include "exploration.h"
+#include "util.h"
+
+#include "../utils/logging.h"
 
 using namespace std;
 
@@ -14,7 +17,7 @@ void LandmarkFactoryRelaxation::generate_landmarks(const shared_ptr<AbstractTask
 
 void LandmarkFactoryRelaxation::generate(const TaskProxy &task_proxy, Exploration &exploration) {
     if (only_causal_landmarks)
-        discard_noncausal_landmarks(task_proxy, exploration);
+        discard_noncausal_landmarks(task_proxy);
     if (!disjunctive_landmarks)
         discard_disjunctive_landmarks();
     if (!conjunctive_landmarks)
@@ -33,57 +36,6 @@ void LandmarkFactoryRelaxation::generate(const TaskProxy &task_proxy, Exploratio
     calc_achievers(task_proxy, exploration);
 }
 
-void LandmarkFactoryRelaxation::discard_noncausal_landmarks(
-    const TaskProxy &task_proxy, Exploration &exploration) {
-    int num_all_landmarks = lm_graph->get_num_landmarks();
-    lm_graph->remove_node_if(
-        [this, &task_proxy, &exploration](const LandmarkNode &node) {
-            return !is_causal_landmark(task_proxy, exploration, node);
-        });
-    int num_causal_landmarks = lm_graph->get_num_landmarks();
-    utils::g_log << "Discarded " << num_all_landmarks - num_causal_landmarks
-                 << " non-causal landmarks" << endl;
-}
-
-bool LandmarkFactoryRelaxation::is_causal_landmark(
-    const TaskProxy &task_proxy, Exploration &exploration,
-    const LandmarkNode &landmark) const {
-    /* Test whether the relaxed planning task is unsolvable without using any operator
-       that has "landmark" as a precondition.
-       Similar to "relaxed_task_solvable" above.
-     */
-
-    if (landmark.is_true_in_goal)
-        return true;
-    vector<vector<int>> lvl_var;
-    vector<utils::HashMap<FactPair, int>> lvl_op;
-    // Initialize lvl_var to numeric_limits<int>::max()
-    VariablesProxy variables = task_proxy.get_variables();
-    lvl_var.resize(variables.size());
-    for (VariableProxy var : variables) {
-        lvl_var[var.get_id()].resize(var.get_domain_size(),
-                                     numeric_limits<int>::max());
-    }
-    unordered_set<int> exclude_op_ids;
-    vector<FactPair> exclude_props;
-    for (OperatorProxy op : task_proxy.get_operators()) {
-        if (is_landmark_precondition(op, &landmark)) {
-            exclude_op_ids.insert(op.get_id());
-        }
-    }
-    // Do relaxed exploration
-    exploration.compute_reachability_with_excludes(
-        lvl_var, lvl_op, true, exclude_props, exclude_op_ids, false);
-
-    // Test whether all goal propositions have a level of less than numeric_limits<int>::max()
-    for (FactProxy goal : task_proxy.get_goals())
-        if (lvl_var[goal.get_variable().get_id()][goal.get_value()] ==
-            numeric_limits<int>::max())
-            return true;
-
-    return false;
-}
-
 void LandmarkFactoryRelaxation::calc_achievers(const TaskProxy &task_proxy, Exploration &exploration) {
     VariablesProxy variables = task_proxy.get_variables();
     for (auto &lmn : lm_graph->get_nodes()) {
@@ -146,12 +98,12 @@ bool LandmarkFactoryRelaxation::relaxed_task_solvable(
                                      numeric_limits<int>::max());
     }
     // Extract propositions from "exclude"
-    unordered_set<int> exclude_op_ids;
+    vector<int> exclude_op_ids;
     vector<FactPair> exclude_props;
     if (exclude) {
         for (OperatorProxy op : operators) {
             if (achieves_non_conditional(op, exclude))
-                exclude_op_ids.insert(op.get_id());
+                exclude_op_ids.push_back(op.get_id());
         }
         exclude_props.insert(exclude_props.end(),
                              exclude->facts.begin(), exclude->facts.end());
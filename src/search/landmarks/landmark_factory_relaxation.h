@@ -21,6 +21,8 @@ protected:
                                bool level_out,
                                const LandmarkNode *exclude,
                                bool compute_lvl_op = false) const;
+    bool achieves_non_conditional(const OperatorProxy &o,
+                                  const LandmarkNode *lmp) const;
 
 private:
     void generate_landmarks(const std::shared_ptr<AbstractTask> &task) override;
@@ -29,17 +31,7 @@ private:
                                             Exploration &exploration) = 0;
     void generate(const TaskProxy &task_proxy, Exploration &exploration);
 
-    // TODO: this is duplicated here and in LandmarkFactoryHM
-    void discard_noncausal_landmarks(const TaskProxy &task_proxy,
-                                     Exploration &exploration);
-    // TODO: this is duplicated here and in LandmarkFactoryHM
-    bool is_causal_landmark(const TaskProxy &task_proxy,
-                            Exploration &exploration,
-                            const LandmarkNode &landmark) const;
-
     void calc_achievers(const TaskProxy &task_proxy, Exploration &exploration);
-    bool achieves_non_conditional(const OperatorProxy &o,
-                                  const LandmarkNode *lmp) const;
     void add_operator_and_propositions_to_list(
         const OperatorProxy &op, std::vector<utils::HashMap<FactPair, int>> &lvl_op) const;
 };
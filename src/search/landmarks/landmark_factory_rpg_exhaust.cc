@@ -6,8 +6,11 @@
 #include "../plugin.h"
 #include "../task_proxy.h"
 
+#include "../task_utils/bit_parallel_reachability.h"
+#include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <vector>
 using namespace std;
 
@@ -21,7 +24,7 @@ LandmarkFactoryRpgExhaust::LandmarkFactoryRpgExhaust(const Options &opts)
 }
 
 void LandmarkFactoryRpgExhaust::generate_relaxed_landmarks(
-    const shared_ptr<AbstractTask> &task, Exploration &exploration) {
+    const shared_ptr<AbstractTask> &task, Exploration &) {
     TaskProxy task_proxy(*task);
     utils::g_log << "Generating landmarks by testing all facts with RPG method" << endl;
 
@@ -32,19 +35,78 @@ void LandmarkFactoryRpgExhaust::generate_relaxed_landmarks(
     }
     // test all other possible facts
     State initial_state = task_proxy.get_initial_state();
+    vector<FactPair> candidates;
     for (VariableProxy var : task_proxy.get_variables()) {
         for (int value = 0; value < var.get_domain_size(); ++value) {
             const FactPair lm(var.get_id(), value);
-            if (!lm_graph->contains_simple_landmark(lm)) {
-                vector<FactPair> facts = {lm};
-                LandmarkNode node(facts, false, false);
-                if (initial_state[lm.var].get_value() == lm.value ||
-                    !relaxed_task_solvable(task_proxy, exploration, true, &node)) {
-                    lm_graph->add_simple_landmark(lm);
+            if (!lm_graph->contains_simple_landmark(lm) &&
+                initial_state[lm.var].get_value() != lm.value) {
+                candidates.push_back(lm);
+            }
+        }
+    }
+    utils::HashSet<FactPair> landmarks =
+        compute_relaxed_landmarks(task_proxy, initial_state, candidates);
+
+    for (VariableProxy var : task_proxy.get_variables()) {
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            const FactPair lm(var.get_id(), value);
+            if (!lm_graph->contains_simple_landmark(lm) &&
+                (initial_state[lm.var].get_value() == lm.value ||
+                 landmarks.count(lm))) {
+                lm_graph->add_simple_landmark(lm);
+            }
+        }
+    }
+}
+
+utils::HashSet<FactPair> LandmarkFactoryRpgExhaust::compute_relaxed_landmarks(
+    const TaskProxy &task_proxy, const State &initial_state,
+    const vector<FactPair> &candidates) const {
+    /*
+      Return the candidates without which the relaxed task is unsolvable,
+      i.e., the candidates for which relaxed_task_solvable() with the
+      candidate as excluded landmark returns false. We test up to
+      NUM_LANES candidates in one exploration.
+    */
+    OperatorsProxy operators = task_proxy.get_operators();
+    const int num_lanes = bit_parallel_reachability::BitParallelReachability::NUM_LANES;
+    bit_parallel_reachability::BitParallelReachability reachability(task_proxy);
+    vector<FactPair> goals = task_properties::get_fact_pairs(task_proxy.get_goals());
+    utils::HashSet<FactPair> landmarks;
+    for (size_t begin = 0; begin < candidates.size(); begin += num_lanes) {
+        size_t end = min(candidates.size(), begin + num_lanes);
+        reachability.clear();
+        for (size_t i = begin; i < end; ++i) {
+            int lane = i - begin;
+            const FactPair &lm = candidates[i];
+            reachability.add_initial_state(lane, initial_state);
+            vector<FactPair> facts = {lm};
+            LandmarkNode node(facts, false, false);
+            bool excludes_operators = false;
+            for (int op_or_axiom_id : get_operators_including_eff(lm)) {
+                if (op_or_axiom_id >= 0 &&
+                    achieves_non_conditional(operators[op_or_axiom_id], &node)) {
+                    reachability.exclude_operator(lane, op_or_axiom_id);
+                    excludes_operators = true;
                 }
             }
+            /*
+              Like Exploration, we only block the remaining achievers of the
+              candidate if some operator achieves it unconditionally.
+            */
+            if (excludes_operators)
+                reachability.exclude_achievers(lane, lm);
+        }
+        reachability.run();
+        bit_parallel_reachability::LaneMask solvable =
+            reachability.get_lanes_reaching_all(goals);
+        for (size_t i = begin; i < end; ++i) {
+            if (!(solvable & (bit_parallel_reachability::LaneMask(1) << (i - begin))))
+                landmarks.insert(candidates[i]);
         }
     }
+    return landmarks;
 }
 
 bool LandmarkFactoryRpgExhaust::supports_conditional_effects() const {
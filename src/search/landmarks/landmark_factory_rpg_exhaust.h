@@ -3,10 +3,17 @@
 
 #include "landmark_factory_relaxation.h"
 
+#include "../utils/hash.h"
+
+#include <vector>
+
 namespace landmarks {
 class LandmarkFactoryRpgExhaust : public LandmarkFactoryRelaxation {
     virtual void generate_relaxed_landmarks(const std::shared_ptr<AbstractTask> &task,
                                             Exploration &exploration) override;
+    utils::HashSet<FactPair> compute_relaxed_landmarks(
+        const TaskProxy &task_proxy, const State &initial_state,
+        const std::vector<FactPair> &candidates) const;
 
 public:
     explicit LandmarkFactoryRpgExhaust(const options::Options &opts);
@@ -0,0 +1,87 @@
+#include "landmark_set_pool.h"
+
+#include "../utils/logging.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace landmarks {
+/*
+  The number of pairs of sets is quadratic in the number of sets, so we
+  bound the size of the intersection cache and start over when it is full.
+*/
+static const size_t MAX_INTERSECTION_CACHE_SIZE = 1 << 20;
+
+// IntHashSet needs roughly 12-16 bytes per entry (see int_hash_set.h).
+static const int BYTES_PER_HASH_SET_ENTRY = 16;
+
+LandmarkSetPool::LandmarkSetPool(int num_landmarks)
+    : num_bits(num_landmarks),
+      num_blocks(max(BitsetMath::compute_num_blocks(num_landmarks), 1)),
+      data_pool(num_blocks),
+      registered_sets(
+          SemanticHash(data_pool, num_blocks),
+          SemanticEqual(data_pool, num_blocks)),
+      num_intersection_cache_hits(0),
+      num_intersections(0) {
+}
+
+int LandmarkSetPool::insert(const Block *data) {
+    /*
+      Like StateRegistry::insert_id_or_pop_state(), add the set to the pool
+      and remove it again if the pool already contains it.
+    */
+    data_pool.push_back(data);
+    pair<int, bool> result = registered_sets.insert(data_pool.size() - 1);
+    if (!result.second) {
+        data_pool.pop_back();
+    }
+    assert(registered_sets.size() == static_cast<int>(data_pool.size()));
+    return result.first;
+}
+
+int LandmarkSetPool::intersect(int handle1, int handle2) {
+    if (handle1 == handle2)
+        return handle1;
+    ++num_intersections;
+    pair<int, int> key = minmax(handle1, handle2);
+    auto it = intersection_cache.find(key);
+    if (it != intersection_cache.end()) {
+        ++num_intersection_cache_hits;
+        return it->second;
+    }
+
+    vector<Block> intersection(data_pool[handle1], data_pool[handle1] + num_blocks);
+    const Block *other = data_pool[handle2];
+    for (int i = 0; i < num_blocks; ++i) {
+        intersection[i] &= other[i];
+    }
+    int result = insert(intersection.data());
+
+    if (intersection_cache.size() >= MAX_INTERSECTION_CACHE_SIZE)
+        intersection_cache.clear();
+    intersection_cache[key] = result;
+    return result;
+}
+
+BitsetView LandmarkSetPool::operator[](int handle) {
+    return BitsetView(ArrayView<Block>(data_pool[handle], num_blocks), num_bits);
+}
+
+void LandmarkSetPool::print_statistics(int64_t num_states) const {
+    int num_sets = size();
+    int64_t bytes_per_set = num_blocks * sizeof(Block);
+    int64_t bitset_bytes = num_states * bytes_per_set;
+    int64_t pool_bytes = num_states * sizeof(int) +
+        num_sets * (bytes_per_set + BYTES_PER_HASH_SET_ENTRY);
+    utils::g_log << "Distinct landmark sets: " << num_sets
+                 << " for " << num_states << " states" << endl;
+    utils::g_log << "Landmark set intersections: " << num_intersections
+                 << " (" << num_intersection_cache_hits << " cached)" << endl;
+    utils::g_log << "Landmark set memory: " << pool_bytes / 1024
+                 << " KB (" << bitset_bytes / 1024
+                 << " KB with one bitset per state)" << endl;
+}
+}
@@ -0,0 +1,106 @@
+#ifndef LANDMARKS_LANDMARK_SET_POOL_H
+#define LANDMARKS_LANDMARK_SET_POOL_H
+
+#include "../per_state_bitset.h"
+
+#include "../algorithms/int_hash_set.h"
+#include "../algorithms/segmented_vector.h"
+#include "../utils/hash.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace landmarks {
+/*
+  Stores each distinct set of landmarks only once. A set is represented by
+  a bitset over the landmark IDs and identified by a non-negative handle.
+  The bitsets are stored like the states in StateRegistry: in a
+  SegmentedArrayVector, indexed by an IntHashSet that compares the bitsets
+  they refer to.
+
+  Interned sets are never modified or removed. Intersections of interned
+  sets are memoized.
+*/
+class LandmarkSetPool {
+    using Block = BitsetMath::Block;
+
+    struct SemanticHash {
+        const segmented_vector::SegmentedArrayVector<Block> &data_pool;
+        int num_blocks;
+        SemanticHash(
+            const segmented_vector::SegmentedArrayVector<Block> &data_pool,
+            int num_blocks)
+            : data_pool(data_pool),
+              num_blocks(num_blocks) {
+        }
+
+        int_hash_set::HashType operator()(int id) const {
+            const Block *data = data_pool[id];
+            utils::HashState hash_state;
+            for (int i = 0; i < num_blocks; ++i) {
+                hash_state.feed(data[i]);
+            }
+            return hash_state.get_hash32();
+        }
+    };
+
+    struct SemanticEqual {
+        const segmented_vector::SegmentedArrayVector<Block> &data_pool;
+        int num_blocks;
+        SemanticEqual(
+            const segmented_vector::SegmentedArrayVector<Block> &data_pool,
+            int num_blocks)
+            : data_pool(data_pool),
+              num_blocks(num_blocks) {
+        }
+
+        bool operator()(int lhs, int rhs) const {
+            const Block *lhs_data = data_pool[lhs];
+            const Block *rhs_data = data_pool[rhs];
+            return std::equal(lhs_data, lhs_data + num_blocks, rhs_data);
+        }
+    };
+
+    const int num_bits;
+    const int num_blocks;
+    segmented_vector::SegmentedArrayVector<Block> data_pool;
+    int_hash_set::IntHashSet<SemanticHash, SemanticEqual> registered_sets;
+    // Maps pairs of handles (smaller handle first) to their intersection.
+    utils::HashMap<std::pair<int, int>, int> intersection_cache;
+    int64_t num_intersection_cache_hits;
+    int64_t num_intersections;
+public:
+    explicit LandmarkSetPool(int num_landmarks);
+
+    LandmarkSetPool(const LandmarkSetPool &) = delete;
+    LandmarkSetPool &operator=(const LandmarkSetPool &) = delete;
+
+    int get_num_blocks() const {
+        return num_blocks;
+    }
+
+    // Return the handle of the set given by num_blocks blocks.
+    int insert(const Block *data);
+
+    int intersect(int handle1, int handle2);
+
+    const Block *get_data(int handle) const {
+        return data_pool[handle];
+    }
+
+    /*
+      Return a view of the set. The set may be shared by many states, so
+      the view must not be modified.
+    */
+    BitsetView operator[](int handle);
+
+    int size() const {
+        return data_pool.size();
+    }
+
+    void print_statistics(int64_t num_states) const;
+};
+}
+
+#endif
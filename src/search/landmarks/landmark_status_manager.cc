@@ -2,27 +2,46 @@
 
 #include "../utils/logging.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace landmarks {
 /*
-  By default we mark all landmarks as reached, since we do an intersection when
-  computing new landmark information.
+  States that have not been reached yet have the handle NOT_REACHED. We
+  treat them as if all landmarks were reached, since we do an intersection
+  when computing new landmark information.
 */
+static const int NOT_REACHED = -1;
+
 LandmarkStatusManager::LandmarkStatusManager(LandmarkGraph &graph)
-    : reached_lms(vector<bool>(graph.get_num_landmarks(), true)),
+    : reached_lm_sets(graph.get_num_landmarks()),
+      reached_lms(NOT_REACHED),
+      scratch_lms(reached_lm_sets.get_num_blocks()),
+      num_states(0),
       lm_status(graph.get_num_landmarks(), lm_not_reached),
       lm_graph(graph) {
+    BitsetView all(ArrayView<BitsetMath::Block>(
+                       scratch_lms.data(), scratch_lms.size()),
+                   graph.get_num_landmarks());
+    for (int id = 0; id < graph.get_num_landmarks(); ++id) {
+        all.set(id);
+    }
+    all_landmarks = reached_lm_sets.insert(scratch_lms.data());
 }
 
 BitsetView LandmarkStatusManager::get_reached_landmarks(const State &state) {
-    return reached_lms[state];
+    int handle = reached_lms[state];
+    if (handle == NOT_REACHED)
+        handle = all_landmarks;
+    return reached_lm_sets[handle];
 }
 
 void LandmarkStatusManager::set_landmarks_for_initial_state(
     const State &initial_state) {
-    BitsetView reached = get_reached_landmarks(initial_state);
-    // This is necessary since the default is "true for all" (see comment above).
+    BitsetView reached(ArrayView<BitsetMath::Block>(
+                           scratch_lms.data(), scratch_lms.size()),
+                       lm_graph.get_num_landmarks());
     reached.reset();
 
     int inserted = 0;
@@ -57,6 +76,11 @@ void LandmarkStatusManager::set_landmarks_for_initial_state(
             }
         }
     }
+    int &handle = reached_lms[initial_state];
+    if (handle == NOT_REACHED)
+        ++num_states;
+    handle = reached_lm_sets.insert(scratch_lms.data());
+
     utils::g_log << inserted << " initial landmarks, "
                  << num_goal_lms << " goal landmarks" << endl;
 }
@@ -69,38 +93,51 @@ bool LandmarkStatusManager::update_reached_lms(const State &parent_ancestor_stat
         return false;
     }
 
-    const BitsetView parent_reached = get_reached_landmarks(parent_ancestor_state);
-    BitsetView reached = get_reached_landmarks(ancestor_state);
-
-    int num_landmarks = lm_graph.get_num_landmarks();
-    assert(reached.size() == num_landmarks);
-    assert(parent_reached.size() == num_landmarks);
+    int parent_handle = reached_lms[parent_ancestor_state];
+    assert(parent_handle != NOT_REACHED);
+    int &handle = reached_lms[ancestor_state];
 
     /*
        Set all landmarks not reached by this parent as "not reached".
        Over multiple paths, this has the effect of computing the intersection
-       of "reached" for the parents. It is important here that upon first visit,
-       all elements in "reached" are true because true is the neutral element
-       of intersection.
+       of "reached" for the parents. Upon first visit, the state behaves as
+       if all landmarks were reached because this is the neutral element of
+       intersection.
 
        In the case where the landmark we are setting to false here is actually
        achieved right now, it is set to "true" again below.
     */
-    reached.intersect(parent_reached);
-
+    int intersection;
+    if (handle == NOT_REACHED) {
+        ++num_states;
+        intersection = parent_handle;
+    } else {
+        intersection = reached_lm_sets.intersect(handle, parent_handle);
+    }
+    const BitsetMath::Block *intersection_data =
+        reached_lm_sets.get_data(intersection);
+    copy(intersection_data, intersection_data + scratch_lms.size(),
+         scratch_lms.begin());
+    int num_landmarks = lm_graph.get_num_landmarks();
+    BitsetView reached(ArrayView<BitsetMath::Block>(
+                           scratch_lms.data(), scratch_lms.size()),
+                       num_landmarks);
 
     // Mark landmarks reached right now as "reached" (if they are "leaves").
+    bool changed = false;
     for (int id = 0; id < num_landmarks; ++id) {
         if (!reached.test(id)) {
             LandmarkNode *node = lm_graph.get_landmark(id);
             if (node->is_true_in_state(ancestor_state)) {
                 if (landmark_is_leaf(*node, reached)) {
                     reached.set(id);
+                    changed = true;
                 }
             }
         }
     }
 
+    handle = changed ? reached_lm_sets.insert(scratch_lms.data()) : intersection;
     return true;
 }
 
@@ -185,4 +222,8 @@ bool LandmarkStatusManager::landmark_is_leaf(const LandmarkNode &node,
     }
     return true;
 }
+
+void LandmarkStatusManager::print_statistics() const {
+    reached_lm_sets.print_statistics(num_states);
+}
 }
@@ -2,8 +2,12 @@
 #define LANDMARKS_LANDMARK_STATUS_MANAGER_H
 
 #include "landmark_graph.h"
+#include "landmark_set_pool.h"
 
 #include "../per_state_bitset.h"
+#include "../per_state_information.h"
+
+#include <cstdint>
 
 namespace landmarks {
 class LandmarkGraph;
@@ -12,7 +16,16 @@ class LandmarkNode;
 enum landmark_status {lm_reached = 0, lm_not_reached = 1, lm_needed_again = 2};
 
 class LandmarkStatusManager {
-    PerStateBitset reached_lms;
+    /*
+      Many states reach the same set of landmarks. Therefore, we intern the
+      sets and store only the handle of the reached set for each state.
+    */
+    LandmarkSetPool reached_lm_sets;
+    PerStateInformation<int> reached_lms;
+    // Handle of the set of all landmarks.
+    int all_landmarks;
+    std::vector<BitsetMath::Block> scratch_lms;
+    int64_t num_states;
     std::vector<landmark_status> lm_status;
 
     LandmarkGraph &lm_graph;
@@ -22,6 +35,10 @@ class LandmarkStatusManager {
 public:
     explicit LandmarkStatusManager(LandmarkGraph &graph);
 
+    /*
+      The set of reached landmarks may be shared with other states, so the
+      returned view must not be modified.
+    */
     BitsetView get_reached_landmarks(const State &state);
 
     void update_lm_status(const State &ancestor_state);
@@ -32,6 +49,8 @@ public:
                             OperatorID op_id,
                             const State &ancestor_state);
 
+    void print_statistics() const;
+
     /*
       TODO:
       The status of a landmark is actually dependent on the state. This
@@ -0,0 +1,87 @@
+#ifndef LP_COIN_SOLVER_INTERFACE_H
+#define LP_COIN_SOLVER_INTERFACE_H
+
+#include "solver_interface.h"
+
+#include <memory>
+#include <vector>
+
+class CoinPackedVectorBase;
+class OsiSolverInterface;
+
+namespace lp {
+enum class LPSolverType;
+
+#ifdef USE_LP
+/*
+  Solve LPs and MIPs with one of the external solvers supported by OSI.
+*/
+class CoinSolverInterface : public SolverInterface {
+    bool is_initialized;
+    bool is_mip;
+    bool is_solved;
+    int num_permanent_constraints;
+    bool has_temporary_constraints_;
+    std::unique_ptr<OsiSolverInterface> lp_solver;
+
+    /*
+      Temporary data for assigning a new problem. We keep the vectors
+      around to avoid recreating them in every assignment.
+    */
+    std::vector<double> elements;
+    std::vector<int> indices;
+    std::vector<int> starts;
+    std::vector<double> col_lb;
+    std::vector<double> col_ub;
+    std::vector<double> objective;
+    std::vector<double> row_lb;
+    std::vector<double> row_ub;
+    std::vector<CoinPackedVectorBase *> rows;
+    void clear_temporary_data();
+public:
+    explicit CoinSolverInterface(LPSolverType solver_type);
+    /*
+      The destructor cannot be set to the default destructor here
+      (~CoinSolverInterface() = default;) because OsiSolverInterface is a
+      forward declaration and the incomplete type cannot be destroyed.
+    */
+    virtual ~CoinSolverInterface() override;
+
+    virtual void load_problem(const LinearProgram &lp) override;
+    virtual void add_temporary_constraints(const std::vector<LPConstraint> &constraints) override;
+    virtual void clear_temporary_constraints() override;
+    virtual double get_infinity() const override;
+
+    virtual void set_objective_coefficients(const std::vector<double> &coefficients) override;
+    virtual void set_objective_coefficient(int index, double coefficient) override;
+    virtual void set_constraint_lower_bound(int index, double bound) override;
+    virtual void set_constraint_upper_bound(int index, double bound) override;
+    virtual void set_variable_lower_bound(int index, double bound) override;
+    virtual void set_variable_upper_bound(int index, double bound) override;
+
+    virtual void solve() override;
+    virtual int get_iteration_count() const override;
+
+    virtual void write_lp(const std::string &filename) const override;
+    virtual void print_failure_analysis() const override;
+    virtual bool is_infeasible() const override;
+    virtual bool is_unbounded() const override;
+    virtual bool has_optimal_solution() const override;
+    virtual double get_objective_value() const override;
+    virtual std::vector<double> extract_solution() const override;
+
+    virtual int get_num_variables() const override;
+    virtual int get_num_constraints() const override;
+    virtual bool has_temporary_constraints() const override;
+};
+#endif
+
+/*
+  Create an interface to the given OSI solver. Exit with an error if the
+  planner was compiled without LP support.
+*/
+std::unique_ptr<SolverInterface> create_coin_solver_interface(
+    LPSolverType solver_type);
+}
+
+#endif
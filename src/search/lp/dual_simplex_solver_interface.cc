@@ -0,0 +1,1030 @@
+#include "dual_simplex_solver_interface.h"
+
+#include "lp_solver.h"
+
+#include "../utils/collections.h"
+#include "../utils/language.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace lp {
+static const double PRIMAL_TOLERANCE = 1e-7;
+static const double DUAL_TOLERANCE = 1e-7;
+// Smallest absolute value of a pivot element.
+static const double PIVOT_TOLERANCE = 1e-7;
+// We drop smaller entries from eta vectors and LU factors.
+static const double DROP_TOLERANCE = 1e-12;
+// Pivots of the LU factorization must not be much smaller than their column.
+static const double PIVOT_THRESHOLD = 0.1;
+static const int MAX_SEARCHED_COLUMNS = 4;
+static const int MAX_NUM_ETAS = 64;
+
+DualSimplexSolverInterface::DualSimplexSolverInterface()
+    : num_cols(0),
+      num_rows(0),
+      num_permanent_rows(0),
+      objective_sign(1),
+      is_factorized(false),
+      solve_status(SolveStatus::UNSOLVED),
+      num_iterations(0) {
+}
+
+double DualSimplexSolverInterface::get_nonbasic_value(int var) const {
+    switch (var_status[var]) {
+    case VarStatus::AT_LOWER:
+        return lower[var];
+    case VarStatus::AT_UPPER:
+        return upper[var];
+    case VarStatus::AT_ZERO:
+        return 0;
+    default:
+        ABORT("Basic variables have no fixed value.");
+    }
+}
+
+void DualSimplexSolverInterface::add_column(int var, vector<double> &vec) const {
+    if (var < num_cols) {
+        for (const Entry &entry : columns[var]) {
+            vec[entry.index] += entry.value;
+        }
+    } else {
+        vec[var - num_cols] -= 1;
+    }
+}
+
+double DualSimplexSolverInterface::dot_column(int var, const vector<double> &vec) const {
+    if (var < num_cols) {
+        double sum = 0;
+        for (const Entry &entry : columns[var]) {
+            sum += entry.value * vec[entry.index];
+        }
+        return sum;
+    } else {
+        return -vec[var - num_cols];
+    }
+}
+
+void DualSimplexSolverInterface::reset_to_slack_basis() {
+    var_status.assign(get_num_vars(), VarStatus::AT_LOWER);
+    for (int row = 0; row < num_rows; ++row) {
+        var_status[num_cols + row] = VarStatus::BASIC;
+    }
+    is_factorized = false;
+}
+
+/*
+  Factorize K for the current set of basic variables. If the basic
+  structural columns are linearly dependent (for example, because the basis
+  was restored after removing constraints), we replace some of them by
+  slack variables. Return true if we had to change the basis.
+*/
+bool DualSimplexSolverInterface::refactor() {
+    vector<int> cols;
+    for (int var = 0; var < num_cols; ++var) {
+        if (var_status[var] == VarStatus::BASIC) {
+            cols.push_back(var);
+        }
+    }
+    vector<int> candidate_rows;
+    for (int row = 0; row < num_rows; ++row) {
+        if (var_status[num_cols + row] != VarStatus::BASIC) {
+            candidate_rows.push_back(row);
+        }
+    }
+    factorize(cols, candidate_rows);
+
+    int num_factor_cols = factor_cols.size();
+    factor_index_of_row.assign(num_rows, -1);
+    for (int j = 0; j < num_factor_cols; ++j) {
+        factor_index_of_row[factor_rows[j]] = j;
+    }
+
+    bool changed_basis = false;
+    vector<bool> is_factor_col(num_cols, false);
+    for (int var : factor_cols) {
+        is_factor_col[var] = true;
+    }
+    for (int var : cols) {
+        if (!is_factor_col[var]) {
+            var_status[var] = lower[var] > -numeric_limits<double>::infinity()
+                ? VarStatus::AT_LOWER
+                : (upper[var] < numeric_limits<double>::infinity()
+                   ? VarStatus::AT_UPPER : VarStatus::AT_ZERO);
+            changed_basis = true;
+        }
+    }
+    for (int row : candidate_rows) {
+        if (factor_index_of_row[row] == -1) {
+            var_status[num_cols + row] = VarStatus::BASIC;
+            changed_basis = true;
+        }
+    }
+
+    basic_vars.resize(num_rows);
+    for (int row = 0; row < num_rows; ++row) {
+        int index = factor_index_of_row[row];
+        basic_vars[row] = (index == -1) ? num_cols + row : factor_cols[index];
+    }
+    etas.clear();
+    is_factorized = true;
+    return changed_basis;
+}
+
+/*
+  Compute a sparse LU factorization of the matrix of the given columns and
+  rows with Gaussian elimination. In each step, we choose the pivot with the
+  Markowitz rule: among the entries whose absolute value is at least
+  PIVOT_THRESHOLD times the largest absolute value in their column, we pick
+  one that minimizes (r - 1) * (c - 1), where r and c are the numbers of
+  nonzeros in its row and column of the remaining submatrix. We only search
+  the MAX_SEARCHED_COLUMNS columns with the fewest nonzeros. Columns without
+  an entry above PIVOT_TOLERANCE depend linearly on the chosen columns and
+  are skipped. The chosen columns and rows form K.
+*/
+void DualSimplexSolverInterface::factorize(
+    const vector<int> &cols, const vector<int> &rows) {
+    int num_factor_candidate_cols = cols.size();
+    int num_factor_candidate_rows = rows.size();
+    vector<int> index_of_row(num_rows, -1);
+    for (int i = 0; i < num_factor_candidate_rows; ++i) {
+        index_of_row[rows[i]] = i;
+    }
+
+    // Column-wise values and row-wise patterns of the remaining submatrix.
+    vector<vector<Entry>> active_cols(num_factor_candidate_cols);
+    vector<vector<int>> active_rows(num_factor_candidate_rows);
+    for (int j = 0; j < num_factor_candidate_cols; ++j) {
+        for (const Entry &entry : columns[cols[j]]) {
+            int i = index_of_row[entry.index];
+            if (i != -1 && entry.value != 0) {
+                active_cols[j].emplace_back(i, entry.value);
+                active_rows[i].push_back(j);
+            }
+        }
+    }
+
+    // Doubly-linked lists of the remaining columns with the same number of nonzeros.
+    vector<int> first_col_with_count(num_factor_candidate_rows + 1, -1);
+    vector<int> next_col(num_factor_candidate_cols, -1);
+    vector<int> prev_col(num_factor_candidate_cols, -1);
+    auto link_col = [&](int j) {
+            int count = active_cols[j].size();
+            prev_col[j] = -1;
+            next_col[j] = first_col_with_count[count];
+            if (next_col[j] != -1) {
+                prev_col[next_col[j]] = j;
+            }
+            first_col_with_count[count] = j;
+        };
+    // Must be called before the number of nonzeros in the column changes.
+    auto unlink_col = [&](int j) {
+            if (prev_col[j] == -1) {
+                first_col_with_count[active_cols[j].size()] = next_col[j];
+            } else {
+                next_col[prev_col[j]] = next_col[j];
+            }
+            if (next_col[j] != -1) {
+                prev_col[next_col[j]] = prev_col[j];
+            }
+        };
+    auto remove_col_from_rows = [&](int j) {
+            for (const Entry &entry : active_cols[j]) {
+                vector<int> &pattern = active_rows[entry.index];
+                *find(pattern.begin(), pattern.end(), j) = pattern.back();
+                pattern.pop_back();
+            }
+            utils::release_vector_memory(active_cols[j]);
+        };
+    for (int j = 0; j < num_factor_candidate_cols; ++j) {
+        link_col(j);
+    }
+
+    factor_cols.clear();
+    factor_rows.clear();
+    factor_pivots.clear();
+    vector<int> step_of_col(num_factor_candidate_cols, -1);
+    vector<int> step_of_row(num_factor_candidate_rows, -1);
+    // Position of each row in the column that is currently updated.
+    vector<int> position(num_factor_candidate_rows, -1);
+    int num_remaining_cols = num_factor_candidate_cols;
+    while (num_remaining_cols > 0) {
+        int pivot_col = -1;
+        int pivot_row = -1;
+        double pivot_value = 0;
+        int64_t min_cost = numeric_limits<int64_t>::max();
+        int num_searched_cols = 0;
+        for (int count = 0; count <= num_factor_candidate_rows &&
+             num_searched_cols < MAX_SEARCHED_COLUMNS; ++count) {
+            int j = first_col_with_count[count];
+            while (j != -1 && num_searched_cols < MAX_SEARCHED_COLUMNS) {
+                int next = next_col[j];
+                double max_abs_value = 0;
+                for (const Entry &entry : active_cols[j]) {
+                    max_abs_value = max(max_abs_value, abs(entry.value));
+                }
+                if (max_abs_value <= PIVOT_TOLERANCE) {
+                    unlink_col(j);
+                    remove_col_from_rows(j);
+                    --num_remaining_cols;
+                } else {
+                    double min_abs_value =
+                        max(PIVOT_TOLERANCE, PIVOT_THRESHOLD * max_abs_value);
+                    for (const Entry &entry : active_cols[j]) {
+                        int64_t cost =
+                            static_cast<int64_t>(active_rows[entry.index].size() - 1) *
+                            (count - 1);
+                        if (abs(entry.value) >= min_abs_value && cost < min_cost) {
+                            pivot_col = j;
+                            pivot_row = entry.index;
+                            pivot_value = entry.value;
+                            min_cost = cost;
+                        }
+                    }
+                    ++num_searched_cols;
+                }
+                j = next;
+            }
+        }
+        if (pivot_col == -1) {
+            assert(num_remaining_cols == 0);
+            break;
+        }
+
+        FactorPivot pivot;
+        pivot.value = pivot_value;
+        for (const Entry &entry : active_cols[pivot_col]) {
+            if (entry.index != pivot_row) {
+                pivot.lower.emplace_back(entry.index, entry.value / pivot_value);
+            }
+        }
+        unlink_col(pivot_col);
+        remove_col_from_rows(pivot_col);
+        --num_remaining_cols;
+
+        // Subtract multiples of the pivot row from the other rows.
+        for (int j : active_rows[pivot_row]) {
+            unlink_col(j);
+            vector<Entry> &col = active_cols[j];
+            int num_entries = col.size();
+            for (int k = 0; k < num_entries; ++k) {
+                position[col[k].index] = k;
+            }
+            int pivot_row_position = position[pivot_row];
+            double value = col[pivot_row_position].value;
+            pivot.upper.emplace_back(j, value);
+            for (const Entry &multiplier : pivot.lower) {
+                int i = multiplier.index;
+                if (position[i] != -1) {
+                    col[position[i]].value -= multiplier.value * value;
+                } else {
+                    col.emplace_back(i, -multiplier.value * value);
+                    active_rows[i].push_back(j);
+                }
+            }
+            for (int k = 0; k < num_entries; ++k) {
+                position[col[k].index] = -1;
+            }
+            col[pivot_row_position] = col.back();
+            col.pop_back();
+            link_col(j);
+        }
+        utils::release_vector_memory(active_rows[pivot_row]);
+
+        step_of_col[pivot_col] = factor_cols.size();
+        step_of_row[pivot_row] = factor_rows.size();
+        factor_cols.push_back(cols[pivot_col]);
+        factor_rows.push_back(rows[pivot_row]);
+        factor_pivots.push_back(move(pivot));
+    }
+
+    /*
+      Refer to rows and columns by their pivot steps and drop the entries of
+      rows and columns that are not part of K. They do not affect the
+      factorization of K.
+    */
+    auto convert_entries = [](vector<Entry> &entries, const vector<int> &step) {
+            size_t num_kept = 0;
+            for (const Entry &entry : entries) {
+                if (step[entry.index] != -1 && abs(entry.value) > DROP_TOLERANCE) {
+                    entries[num_kept++] = Entry(step[entry.index], entry.value);
+                }
+            }
+            entries.erase(entries.begin() + num_kept, entries.end());
+        };
+    for (FactorPivot &pivot : factor_pivots) {
+        convert_entries(pivot.lower, step_of_row);
+        convert_entries(pivot.upper, step_of_col);
+    }
+}
+
+/*
+  Solve K x = b in place. On input, entry k of vec belongs to row
+  factor_rows[k], on output to variable factor_cols[k].
+*/
+void DualSimplexSolverInterface::solve_with_factor(vector<double> &vec) const {
+    int n = factor_pivots.size();
+    for (int k = 0; k < n; ++k) {
+        double value = vec[k];
+        if (value != 0) {
+            for (const Entry &entry : factor_pivots[k].lower) {
+                vec[entry.index] -= entry.value * value;
+            }
+        }
+    }
+    for (int k = n - 1; k >= 0; --k) {
+        const FactorPivot &pivot = factor_pivots[k];
+        double sum = vec[k];
+        for (const Entry &entry : pivot.upper) {
+            sum -= entry.value * vec[entry.index];
+        }
+        vec[k] = sum / pivot.value;
+    }
+}
+
+/*
+  Solve x^T K = b^T in place. On input, entry k of vec belongs to variable
+  factor_cols[k], on output to row factor_rows[k].
+*/
+void DualSimplexSolverInterface::solve_with_factor_transposed(
+    vector<double> &vec) const {
+    int n = factor_pivots.size();
+    for (int k = 0; k < n; ++k) {
+        const FactorPivot &pivot = factor_pivots[k];
+        double value = vec[k] / pivot.value;
+        vec[k] = value;
+        if (value != 0) {
+            for (const Entry &entry : pivot.upper) {
+                vec[entry.index] -= entry.value * value;
+            }
+        }
+    }
+    for (int k = n - 1; k >= 0; --k) {
+        double sum = vec[k];
+        for (const Entry &entry : factor_pivots[k].lower) {
+            sum -= entry.value * vec[entry.index];
+        }
+        vec[k] = sum;
+    }
+}
+
+// Replace the vector vec (indexed by rows) by B^{-1} vec (indexed by positions).
+void DualSimplexSolverInterface::ftran(vector<double> &vec) const {
+    int n = factor_cols.size();
+    vector<double> factor_values(n);
+    for (int j = 0; j < n; ++j) {
+        factor_values[j] = vec[factor_rows[j]];
+    }
+    solve_with_factor(factor_values);
+    for (int row = 0; row < num_rows; ++row) {
+        if (factor_index_of_row[row] == -1) {
+            vec[row] = -vec[row];
+        }
+    }
+    for (int j = 0; j < n; ++j) {
+        double value = factor_values[j];
+        if (value != 0) {
+            for (const Entry &entry : columns[factor_cols[j]]) {
+                if (factor_index_of_row[entry.index] == -1) {
+                    vec[entry.index] += entry.value * value;
+                }
+            }
+        }
+    }
+    for (int j = 0; j < n; ++j) {
+        vec[factor_rows[j]] = factor_values[j];
+    }
+    for (const Eta &eta : etas) {
+        double &pivot_value = vec[eta.position];
+        pivot_value /= eta.pivot;
+        if (pivot_value != 0) {
+            for (const Entry &entry : eta.entries) {
+                vec[entry.index] -= entry.value * pivot_value;
+            }
+        }
+    }
+}
+
+// Replace the vector vec (indexed by positions) by vec^T B^{-1} (indexed by rows).
+void DualSimplexSolverInterface::btran(vector<double> &vec) const {
+    for (auto it = etas.rbegin(); it != etas.rend(); ++it) {
+        const Eta &eta = *it;
+        double sum = vec[eta.position];
+        for (const Entry &entry : eta.entries) {
+            sum -= entry.value * vec[entry.index];
+        }
+        vec[eta.position] = sum / eta.pivot;
+    }
+    int n = factor_cols.size();
+    vector<double> rhs(n);
+    for (int j = 0; j < n; ++j) {
+        rhs[j] = vec[factor_rows[j]];
+    }
+    for (int row = 0; row < num_rows; ++row) {
+        if (factor_index_of_row[row] == -1) {
+            vec[row] = -vec[row];
+        }
+    }
+    for (int j = 0; j < n; ++j) {
+        for (const Entry &entry : columns[factor_cols[j]]) {
+            if (factor_index_of_row[entry.index] == -1) {
+                rhs[j] -= entry.value * vec[entry.index];
+            }
+        }
+    }
+    solve_with_factor_transposed(rhs);
+    for (int p = 0; p < n; ++p) {
+        vec[factor_rows[p]] = rhs[p];
+    }
+}
+
+void DualSimplexSolverInterface::compute_values() {
+    vector<double> rhs(num_rows, 0.0);
+    for (int var = 0; var < get_num_vars(); ++var) {
+        if (var_status[var] != VarStatus::BASIC) {
+            double value = get_nonbasic_value(var);
+            values[var] = value;
+            if (value != 0) {
+                if (var < num_cols) {
+                    for (const Entry &entry : columns[var]) {
+                        rhs[entry.index] -= entry.value * value;
+                    }
+                } else {
+                    rhs[var - num_cols] += value;
+                }
+            }
+        }
+    }
+    ftran(rhs);
+    for (int pos = 0; pos < num_rows; ++pos) {
+        values[basic_vars[pos]] = rhs[pos];
+    }
+}
+
+void DualSimplexSolverInterface::compute_reduced_costs() {
+    vector<double> duals(num_rows);
+    for (int pos = 0; pos < num_rows; ++pos) {
+        duals[pos] = get_cost(basic_vars[pos]);
+    }
+    btran(duals);
+    for (int var = 0; var < get_num_vars(); ++var) {
+        if (var_status[var] == VarStatus::BASIC) {
+            reduced_costs[var] = 0;
+        } else {
+            reduced_costs[var] = get_cost(var) - dot_column(var, duals);
+        }
+    }
+}
+
+/*
+  Move each nonbasic variable to the bound that makes its reduced cost dual
+  feasible. Return false if this is impossible for some variable because
+  the required bound is infinite.
+*/
+bool DualSimplexSolverInterface::choose_dual_feasible_bounds() {
+    const double infinity = numeric_limits<double>::infinity();
+    bool dual_feasible = true;
+    for (int var = 0; var < get_num_vars(); ++var) {
+        VarStatus &status = var_status[var];
+        if (status == VarStatus::BASIC) {
+            continue;
+        }
+        bool has_lower = lower[var] > -infinity;
+        bool has_upper = upper[var] < infinity;
+        double reduced_cost = reduced_costs[var];
+        if (is_fixed(var)) {
+            status = VarStatus::AT_LOWER;
+        } else if (reduced_cost > DUAL_TOLERANCE) {
+            if (has_lower) {
+                status = VarStatus::AT_LOWER;
+            } else {
+                dual_feasible = false;
+            }
+        } else if (reduced_cost < -DUAL_TOLERANCE) {
+            if (has_upper) {
+                status = VarStatus::AT_UPPER;
+            } else {
+                dual_feasible = false;
+            }
+        } else if (!(status == VarStatus::AT_LOWER && has_lower) &&
+                   !(status == VarStatus::AT_UPPER && has_upper)) {
+            if (has_lower) {
+                status = VarStatus::AT_LOWER;
+            } else if (has_upper) {
+                status = VarStatus::AT_UPPER;
+            } else {
+                status = VarStatus::AT_ZERO;
+            }
+        }
+    }
+    return dual_feasible;
+}
+
+// Return the position of the most infeasible basic variable or -1.
+int DualSimplexSolverInterface::choose_leaving_position() const {
+    int best_pos = -1;
+    double max_infeasibility = PRIMAL_TOLERANCE;
+    for (int pos = 0; pos < num_rows; ++pos) {
+        int var = basic_vars[pos];
+        double infeasibility = max(lower[var] - values[var], values[var] - upper[var]);
+        if (infeasibility > max_infeasibility) {
+            best_pos = pos;
+            max_infeasibility = infeasibility;
+        }
+    }
+    return best_pos;
+}
+
+/*
+  Choose the entering variable with the two-pass ratio test by Harris: the
+  first pass computes the largest dual step that violates no reduced cost
+  by more than the tolerance. Among the variables that bound the step
+  within this limit, the second pass chooses the one with the largest
+  pivot element. The direction is -1 if the leaving variable moves to its
+  lower bound and +1 if it moves to its upper bound.
+*/
+int DualSimplexSolverInterface::choose_entering_variable(int direction) const {
+    const int num_vars = get_num_vars();
+    auto get_slack = [&](int var) {
+            double alpha = direction * row_alpha[var];
+            VarStatus status = var_status[var];
+            if (status == VarStatus::AT_LOWER && alpha > PIVOT_TOLERANCE) {
+                return max(reduced_costs[var], 0.0);
+            } else if (status == VarStatus::AT_UPPER && alpha < -PIVOT_TOLERANCE) {
+                return max(-reduced_costs[var], 0.0);
+            } else if (status == VarStatus::AT_ZERO && abs(alpha) > PIVOT_TOLERANCE) {
+                return 0.0;
+            }
+            return -1.0;
+        };
+    double max_step = numeric_limits<double>::infinity();
+    for (int var = 0; var < num_vars; ++var) {
+        if (var_status[var] != VarStatus::BASIC && !is_fixed(var)) {
+            double slack = get_slack(var);
+            if (slack >= 0) {
+                max_step = min(max_step, (slack + DUAL_TOLERANCE) / abs(row_alpha[var]));
+            }
+        }
+    }
+    int entering = -1;
+    double max_abs_alpha = 0;
+    for (int var = 0; var < num_vars; ++var) {
+        if (var_status[var] != VarStatus::BASIC && !is_fixed(var)) {
+            double slack = get_slack(var);
+            double abs_alpha = abs(row_alpha[var]);
+            if (slack >= 0 && slack / abs_alpha <= max_step && abs_alpha > max_abs_alpha) {
+                entering = var;
+                max_abs_alpha = abs_alpha;
+            }
+        }
+    }
+    return entering;
+}
+
+/*
+  Run the dual simplex method from the current basis, which must be dual
+  feasible. Return RESTART if we had to change the basis because of
+  numerical problems, since this can make the basis dual infeasible.
+*/
+DualSimplexSolverInterface::PhaseResult
+DualSimplexSolverInterface::run_dual_simplex() {
+    const int num_vars = get_num_vars();
+    const int max_num_iterations = 10000 + 50 * num_vars;
+    while (true) {
+        int pos = choose_leaving_position();
+        if (pos == -1) {
+            return PhaseResult::OPTIMAL;
+        }
+        if (num_iterations >= max_num_iterations) {
+            cerr << "Abandoned LP after " << num_iterations
+                 << " dual simplex iterations." << endl;
+            utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        int leaving = basic_vars[pos];
+        bool to_lower = values[leaving] < lower[leaving];
+        double target = to_lower ? lower[leaving] : upper[leaving];
+        int direction = to_lower ? -1 : 1;
+
+        rho.assign(num_rows, 0.0);
+        rho[pos] = 1;
+        btran(rho);
+        row_alpha.resize(num_vars);
+        for (int var = 0; var < num_vars; ++var) {
+            row_alpha[var] = (var_status[var] == VarStatus::BASIC)
+                ? 0.0 : dot_column(var, rho);
+        }
+
+        int entering = choose_entering_variable(direction);
+        if (entering == -1) {
+            return PhaseResult::INFEASIBLE;
+        }
+
+        column_alpha.assign(num_rows, 0.0);
+        add_column(entering, column_alpha);
+        ftran(column_alpha);
+        double pivot = column_alpha[pos];
+        if (abs(pivot - row_alpha[entering]) > 1e-6 * (1 + abs(pivot)) ||
+            abs(pivot) < PIVOT_TOLERANCE) {
+            if (!etas.empty()) {
+                // Try again with a fresh inverse.
+                is_factorized = false;
+                return PhaseResult::RESTART;
+            } else if (abs(pivot) < PIVOT_TOLERANCE) {
+                cerr << "Abandoned LP because of numerical difficulties." << endl;
+                utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+            }
+        }
+
+        double dual_step = reduced_costs[entering] / row_alpha[entering];
+        if (direction * dual_step < 0) {
+            // The reduced cost was infeasible within the tolerance.
+            dual_step = 0;
+        }
+        if (dual_step != 0) {
+            for (int var = 0; var < num_vars; ++var) {
+                if (var_status[var] != VarStatus::BASIC) {
+                    reduced_costs[var] -= dual_step * row_alpha[var];
+                }
+            }
+        }
+        reduced_costs[leaving] = -dual_step;
+        reduced_costs[entering] = 0;
+
+        double primal_step = (values[leaving] - target) / pivot;
+        for (int p = 0; p < num_rows; ++p) {
+            if (column_alpha[p] != 0) {
+                values[basic_vars[p]] -= primal_step * column_alpha[p];
+            }
+        }
+        values[entering] += primal_step;
+        values[leaving] = target;
+
+        var_status[leaving] = to_lower ? VarStatus::AT_LOWER : VarStatus::AT_UPPER;
+        var_status[entering] = VarStatus::BASIC;
+        basic_vars[pos] = entering;
+        Eta eta;
+        eta.position = pos;
+        eta.pivot = pivot;
+        for (int p = 0; p < num_rows; ++p) {
+            if (p != pos && abs(column_alpha[p]) > DROP_TOLERANCE) {
+                eta.entries.emplace_back(p, column_alpha[p]);
+            }
+        }
+        etas.push_back(move(eta));
+        ++num_iterations;
+
+        if (etas.size() >= MAX_NUM_ETAS) {
+            if (refactor()) {
+                return PhaseResult::RESTART;
+            }
+            compute_values();
+            compute_reduced_costs();
+        }
+    }
+}
+
+/*
+  Run the dual simplex method for a problem in which every basis can be
+  made dual feasible, i.e., all variables with nonzero costs are bounded.
+*/
+DualSimplexSolverInterface::PhaseResult
+DualSimplexSolverInterface::run_dual_simplex_from_dual_feasible_basis() {
+    PhaseResult result;
+    do {
+        if (!is_factorized) {
+            refactor();
+        }
+        compute_reduced_costs();
+        bool dual_feasible = choose_dual_feasible_bounds();
+        utils::unused_variable(dual_feasible);
+        assert(dual_feasible);
+        compute_values();
+        result = run_dual_simplex();
+    } while (result == PhaseResult::RESTART);
+    return result;
+}
+
+/*
+  Find a dual feasible basis by solving the problem with the bounds [0, 0]
+  for boxed variables, [0, 1] for variables with only a lower bound,
+  [-1, 0] for variables with only an upper bound and [-1, 1] for free
+  variables. Since Ax - s = 0 has no constant terms, the optimal objective
+  value of this problem is 0 if and only if its optimal basis is dual
+  feasible for the original bounds (see Koberstein, The Dual Simplex Method,
+  Techniques for a Fast and Stable Implementation, 2005). Return false if
+  the original problem has no dual feasible basis.
+*/
+bool DualSimplexSolverInterface::run_dual_phase_one() {
+    const double infinity = numeric_limits<double>::infinity();
+    vector<double> auxiliary_lower(get_num_vars());
+    vector<double> auxiliary_upper(get_num_vars());
+    for (int var = 0; var < get_num_vars(); ++var) {
+        bool has_lower = lower[var] > -infinity;
+        bool has_upper = upper[var] < infinity;
+        auxiliary_lower[var] = has_lower ? 0 : -1;
+        auxiliary_upper[var] = has_upper ? 0 : 1;
+    }
+    lower.swap(auxiliary_lower);
+    upper.swap(auxiliary_upper);
+    // The auxiliary problem is feasible because x = 0 satisfies all bounds.
+    run_dual_simplex_from_dual_feasible_basis();
+    lower.swap(auxiliary_lower);
+    upper.swap(auxiliary_upper);
+    compute_reduced_costs();
+    return choose_dual_feasible_bounds();
+}
+
+/*
+  A problem without dual feasible basis is either infeasible or unbounded.
+  We can tell the two cases apart by checking feasibility with a zero
+  objective.
+*/
+DualSimplexSolverInterface::SolveStatus
+DualSimplexSolverInterface::classify_dual_infeasible_lp() {
+    vector<double> zero_cost(num_cols, 0.0);
+    cost.swap(zero_cost);
+    PhaseResult result = run_dual_simplex_from_dual_feasible_basis();
+    cost.swap(zero_cost);
+    return result == PhaseResult::OPTIMAL
+           ? SolveStatus::UNBOUNDED : SolveStatus::INFEASIBLE;
+}
+
+// Check primal and dual feasibility of the current solution from scratch.
+bool DualSimplexSolverInterface::solution_is_optimal() const {
+    const double tolerance = 1e-5;
+    vector<double> activities(num_rows, 0.0);
+    for (int var = 0; var < num_cols; ++var) {
+        for (const Entry &entry : columns[var]) {
+            activities[entry.index] += entry.value * values[var];
+        }
+    }
+    for (int var = 0; var < get_num_vars(); ++var) {
+        double value = var < num_cols ? values[var] : activities[var - num_cols];
+        if (value < lower[var] - tolerance || value > upper[var] + tolerance) {
+            return false;
+        }
+        VarStatus status = var_status[var];
+        if (!is_fixed(var) &&
+            ((status == VarStatus::AT_LOWER && reduced_costs[var] < -tolerance) ||
+             (status == VarStatus::AT_UPPER && reduced_costs[var] > tolerance) ||
+             (status == VarStatus::AT_ZERO && abs(reduced_costs[var]) > tolerance))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DualSimplexSolverInterface::load_problem(const LinearProgram &lp) {
+    const named_vector::NamedVector<LPVariable> &variables = lp.get_variables();
+    const named_vector::NamedVector<LPConstraint> &constraints = lp.get_constraints();
+    num_cols = variables.size();
+    num_rows = constraints.size();
+    num_permanent_rows = num_rows;
+    objective_sign = (lp.get_sense() == LPObjectiveSense::MINIMIZE) ? 1 : -1;
+
+    columns.assign(num_cols, vector<Entry>());
+    cost.clear();
+    lower.clear();
+    upper.clear();
+    for (const LPVariable &var : variables) {
+        if (var.is_integer) {
+            cerr << "The LP solver DUAL_SIMPLEX does not support "
+                 << "integer variables." << endl;
+            utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+        }
+        cost.push_back(objective_sign * var.objective_coefficient);
+        lower.push_back(var.lower_bound);
+        upper.push_back(var.upper_bound);
+    }
+    for (int row = 0; row < num_rows; ++row) {
+        const LPConstraint &constraint = constraints[row];
+        const vector<int> &vars = constraint.get_variables();
+        const vector<double> &coefficients = constraint.get_coefficients();
+        for (size_t i = 0; i < vars.size(); ++i) {
+            columns[vars[i]].emplace_back(row, coefficients[i]);
+        }
+        lower.push_back(constraint.get_lower_bound());
+        upper.push_back(constraint.get_upper_bound());
+    }
+    values.assign(get_num_vars(), 0.0);
+    reduced_costs.assign(get_num_vars(), 0.0);
+    reset_to_slack_basis();
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+void DualSimplexSolverInterface::add_temporary_constraints(
+    const vector<LPConstraint> &constraints) {
+    for (const LPConstraint &constraint : constraints) {
+        int row = num_rows++;
+        const vector<int> &vars = constraint.get_variables();
+        const vector<double> &coefficients = constraint.get_coefficients();
+        for (size_t i = 0; i < vars.size(); ++i) {
+            columns[vars[i]].emplace_back(row, coefficients[i]);
+        }
+        lower.push_back(constraint.get_lower_bound());
+        upper.push_back(constraint.get_upper_bound());
+        var_status.push_back(VarStatus::BASIC);
+        values.push_back(0);
+        reduced_costs.push_back(0);
+    }
+    if (!constraints.empty()) {
+        is_factorized = false;
+        solve_status = SolveStatus::UNSOLVED;
+    }
+}
+
+void DualSimplexSolverInterface::clear_temporary_constraints() {
+    if (!has_temporary_constraints()) {
+        return;
+    }
+    // Temporary entries are stored at the end of each column.
+    for (vector<Entry> &column : columns) {
+        while (!column.empty() && column.back().index >= num_permanent_rows) {
+            column.pop_back();
+        }
+    }
+    num_rows = num_permanent_rows;
+    lower.resize(get_num_vars());
+    upper.resize(get_num_vars());
+    var_status.resize(get_num_vars());
+    values.resize(get_num_vars());
+    reduced_costs.resize(get_num_vars());
+    is_factorized = false;
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+double DualSimplexSolverInterface::get_infinity() const {
+    return numeric_limits<double>::infinity();
+}
+
+void DualSimplexSolverInterface::set_objective_coefficients(
+    const vector<double> &coefficients) {
+    assert(static_cast<int>(coefficients.size()) == num_cols);
+    for (int var = 0; var < num_cols; ++var) {
+        cost[var] = objective_sign * coefficients[var];
+    }
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+void DualSimplexSolverInterface::set_objective_coefficient(int index, double coefficient) {
+    assert(index < num_cols);
+    cost[index] = objective_sign * coefficient;
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+void DualSimplexSolverInterface::set_constraint_lower_bound(int index, double bound) {
+    assert(index < num_rows);
+    lower[num_cols + index] = bound;
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+void DualSimplexSolverInterface::set_constraint_upper_bound(int index, double bound) {
+    assert(index < num_rows);
+    upper[num_cols + index] = bound;
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+void DualSimplexSolverInterface::set_variable_lower_bound(int index, double bound) {
+    assert(index < num_cols);
+    lower[index] = bound;
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+void DualSimplexSolverInterface::set_variable_upper_bound(int index, double bound) {
+    assert(index < num_cols);
+    upper[index] = bound;
+    solve_status = SolveStatus::UNSOLVED;
+}
+
+void DualSimplexSolverInterface::solve() {
+    num_iterations = 0;
+    solve_status = SolveStatus::UNSOLVED;
+    while (solve_status == SolveStatus::UNSOLVED) {
+        if (!is_factorized) {
+            refactor();
+        }
+        compute_reduced_costs();
+        if (!choose_dual_feasible_bounds() && !run_dual_phase_one()) {
+            solve_status = classify_dual_infeasible_lp();
+            break;
+        }
+        compute_values();
+        PhaseResult result = run_dual_simplex();
+        if (result == PhaseResult::OPTIMAL) {
+            solve_status = SolveStatus::OPTIMAL;
+        } else if (result == PhaseResult::INFEASIBLE) {
+            solve_status = SolveStatus::INFEASIBLE;
+        }
+    }
+    assert(solve_status != SolveStatus::OPTIMAL || solution_is_optimal());
+}
+
+int DualSimplexSolverInterface::get_iteration_count() const {
+    return num_iterations;
+}
+
+void DualSimplexSolverInterface::write_lp(const string &filename) const {
+    const double infinity = numeric_limits<double>::infinity();
+    ofstream file(filename);
+    auto write_bound = [&](double bound) {
+            if (bound == infinity) {
+                file << "inf";
+            } else if (bound == -infinity) {
+                file << "-inf";
+            } else {
+                file << bound;
+            }
+        };
+    file.precision(17);
+    file << (objective_sign > 0 ? "Minimize" : "Maximize") << endl << " obj:";
+    for (int var = 0; var < num_cols; ++var) {
+        if (cost[var] != 0) {
+            file << " + " << objective_sign * cost[var] << " x" << var;
+        }
+    }
+    file << endl << "Subject To" << endl;
+    vector<vector<Entry>> rows(num_rows);
+    for (int var = 0; var < num_cols; ++var) {
+        for (const Entry &entry : columns[var]) {
+            rows[entry.index].emplace_back(var, entry.value);
+        }
+    }
+    for (int row = 0; row < num_rows; ++row) {
+        file << " c" << row << ": ";
+        write_bound(lower[num_cols + row]);
+        file << " <=";
+        for (const Entry &entry : rows[row]) {
+            file << " + " << entry.value << " x" << entry.index;
+        }
+        file << " <= ";
+        write_bound(upper[num_cols + row]);
+        file << endl;
+    }
+    file << "Bounds" << endl;
+    for (int var = 0; var < num_cols; ++var) {
+        file << " ";
+        write_bound(lower[var]);
+        file << " <= x" << var << " <= ";
+        write_bound(upper[var]);
+        file << endl;
+    }
+    file << "End" << endl;
+}
+
+void DualSimplexSolverInterface::print_failure_analysis() const {
+    cout << "solved: " << (solve_status != SolveStatus::UNSOLVED) << endl;
+    cout << "proven optimal: " << (solve_status == SolveStatus::OPTIMAL) << endl;
+    cout << "proven primal infeasible: " << (solve_status == SolveStatus::INFEASIBLE) << endl;
+    cout << "proven unbounded: " << (solve_status == SolveStatus::UNBOUNDED) << endl;
+}
+
+bool DualSimplexSolverInterface::is_infeasible() const {
+    assert(solve_status != SolveStatus::UNSOLVED);
+    return solve_status == SolveStatus::INFEASIBLE;
+}
+
+bool DualSimplexSolverInterface::is_unbounded() const {
+    assert(solve_status != SolveStatus::UNSOLVED);
+    return solve_status == SolveStatus::UNBOUNDED;
+}
+
+bool DualSimplexSolverInterface::has_optimal_solution() const {
+    assert(solve_status != SolveStatus::UNSOLVED);
+    return solve_status == SolveStatus::OPTIMAL;
+}
+
+double DualSimplexSolverInterface::get_objective_value() const {
+    assert(has_optimal_solution());
+    double objective_value = 0;
+    for (int var = 0; var < num_cols; ++var) {
+        objective_value += cost[var] * values[var];
+    }
+    return objective_sign * objective_value;
+}
+
+vector<double> DualSimplexSolverInterface::extract_solution() const {
+    assert(has_optimal_solution());
+    return vector<double>(values.begin(), values.begin() + num_cols);
+}
+
+int DualSimplexSolverInterface::get_num_variables() const {
+    return num_cols;
+}
+
+int DualSimplexSolverInterface::get_num_constraints() const {
+    return num_rows;
+}
+
+bool DualSimplexSolverInterface::has_temporary_constraints() const {
+    return num_rows > num_permanent_rows;
+}
+}
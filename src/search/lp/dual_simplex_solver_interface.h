@@ -0,0 +1,179 @@
+#ifndef LP_DUAL_SIMPLEX_SOLVER_INTERFACE_H
+#define LP_DUAL_SIMPLEX_SOLVER_INTERFACE_H
+
+#include "solver_interface.h"
+
+#include <vector>
+
+namespace lp {
+/*
+  Bounded dual simplex method for the small LPs that heuristics solve in
+  every state. It needs no external libraries.
+
+  We add one slack variable per constraint and solve
+
+      minimize c^T x subject to Ax - s = 0 and lower <= (x, s) <= upper.
+
+  The basis is kept between calls to solve(). When a heuristic only changes
+  bounds of constraints or variables, the last optimal basis stays dual
+  feasible and the dual simplex usually needs only a few iterations to
+  restore primal feasibility. If a basis is not dual feasible, for example
+  after changing the objective, we first solve an auxiliary problem with
+  artificial bounds that yields a dual feasible basis (dual phase 1).
+
+  We exploit that most basic variables are slack variables. Their columns
+  are unit vectors, so it suffices to factorize the square submatrix K of A
+  for the basic structural variables and the rows whose slack variables are
+  not basic. We compute a sparse LU factorization of K with Markowitz
+  pivoting. After a pivot, we store the change of the basis as an eta
+  vector (product form of the inverse) and factorize K again every
+  MAX_NUM_ETAS pivots.
+*/
+class DualSimplexSolverInterface : public SolverInterface {
+    enum class VarStatus : char {
+        BASIC, AT_LOWER, AT_UPPER, AT_ZERO
+    };
+
+    enum class SolveStatus {
+        UNSOLVED, OPTIMAL, INFEASIBLE, UNBOUNDED
+    };
+
+    enum class PhaseResult {
+        OPTIMAL, INFEASIBLE, RESTART
+    };
+
+    struct Entry {
+        int index;
+        double value;
+
+        Entry(int index, double value)
+            : index(index), value(value) {
+        }
+    };
+
+    struct Eta {
+        int position;
+        double pivot;
+        std::vector<Entry> entries;
+    };
+
+    /*
+      Step of the LU factorization of K. It subtracts the multiples in lower
+      of the pivot row from the later rows. The entries of the pivot row in
+      the later columns are stored in upper. Entries refer to rows and
+      columns by their steps.
+    */
+    struct FactorPivot {
+        double value;
+        std::vector<Entry> lower;
+        std::vector<Entry> upper;
+    };
+
+    /*
+      Variables 0, ..., num_cols - 1 are the structural variables and
+      variable num_cols + i is the slack variable of row i.
+    */
+    int num_cols;
+    int num_rows;
+    int num_permanent_rows;
+    // Sign that turns the objective into a minimization objective.
+    double objective_sign;
+    std::vector<std::vector<Entry>> columns;
+    std::vector<double> cost;
+    std::vector<double> lower;
+    std::vector<double> upper;
+
+    std::vector<VarStatus> var_status;
+    // The basic variable of each position. There is one position per row.
+    std::vector<int> basic_vars;
+
+    bool is_factorized;
+    /*
+      Basic structural variables and rows that make up the matrix K, in the
+      order in which the LU factorization eliminates them.
+    */
+    std::vector<int> factor_cols;
+    std::vector<int> factor_rows;
+    // Index of each row in factor_rows or -1.
+    std::vector<int> factor_index_of_row;
+    std::vector<FactorPivot> factor_pivots;
+    std::vector<Eta> etas;
+
+    std::vector<double> values;
+    std::vector<double> reduced_costs;
+    SolveStatus solve_status;
+    int num_iterations;
+
+    // Reused memory for the pivoting steps.
+    std::vector<double> row_alpha;
+    std::vector<double> column_alpha;
+    std::vector<double> rho;
+
+    int get_num_vars() const {
+        return num_cols + num_rows;
+    }
+
+    bool is_fixed(int var) const {
+        return lower[var] == upper[var];
+    }
+
+    double get_cost(int var) const {
+        return var < num_cols ? cost[var] : 0.0;
+    }
+
+    double get_nonbasic_value(int var) const;
+    void add_column(int var, std::vector<double> &vec) const;
+    double dot_column(int var, const std::vector<double> &vec) const;
+
+    void reset_to_slack_basis();
+    bool refactor();
+    void factorize(const std::vector<int> &cols, const std::vector<int> &rows);
+    void solve_with_factor(std::vector<double> &vec) const;
+    void solve_with_factor_transposed(std::vector<double> &vec) const;
+    void ftran(std::vector<double> &vec) const;
+    void btran(std::vector<double> &vec) const;
+
+    void compute_values();
+    void compute_reduced_costs();
+    bool choose_dual_feasible_bounds();
+
+    int choose_leaving_position() const;
+    int choose_entering_variable(int direction) const;
+    PhaseResult run_dual_simplex();
+    PhaseResult run_dual_simplex_from_dual_feasible_basis();
+    bool run_dual_phase_one();
+    SolveStatus classify_dual_infeasible_lp();
+    bool solution_is_optimal() const;
+public:
+    DualSimplexSolverInterface();
+
+    virtual void load_problem(const LinearProgram &lp) override;
+    virtual void add_temporary_constraints(const std::vector<LPConstraint> &constraints) override;
+    virtual void clear_temporary_constraints() override;
+    virtual double get_infinity() const override;
+
+    virtual void set_objective_coefficients(const std::vector<double> &coefficients) override;
+    virtual void set_objective_coefficient(int index, double coefficient) override;
+    virtual void set_constraint_lower_bound(int index, double bound) override;
+    virtual void set_constraint_upper_bound(int index, double bound) override;
+    virtual void set_variable_lower_bound(int index, double bound) override;
+    virtual void set_variable_upper_bound(int index, double bound) override;
+
+    virtual void solve() override;
+    virtual int get_iteration_count() const override;
+
+    virtual void write_lp(const std::string &filename) const override;
+    virtual void print_failure_analysis() const override;
+    virtual bool is_infeasible() const override;
+    virtual bool is_unbounded() const override;
+    virtual bool has_optimal_solution() const override;
+    virtual double get_objective_value() const override;
+    virtual std::vector<double> extract_solution() const override;
+
+    virtual int get_num_variables() const override;
+    virtual int get_num_constraints() const override;
+    virtual bool has_temporary_constraints() const override;
+};
+}
+
+#endif
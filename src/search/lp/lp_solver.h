@@ -2,38 +2,19 @@
 #define LP_LP_SOLVER_H
 
 #include "../algorithms/named_vector.h"
-#include "../utils/language.h"
-#include "../utils/system.h"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
 
-/*
-  All methods that use COIN specific classes only do something useful
-  if the planner is compiled with USE_LP. Otherwise, they just print
-  an error message and abort.
-*/
-#ifdef USE_LP
-#define LP_METHOD(X) X;
-#else
-#define LP_METHOD(X) NO_RETURN X { \
-        ABORT("LP method called but the planner was compiled without LP support.\n" \
-              "See http://www.fast-downward.org/LPBuildInstructions\n" \
-              "to install an LP solver and use it in the planner."); \
-}
-#endif
-
-class CoinPackedVectorBase;
-class OsiSolverInterface;
-
 namespace options {
 class OptionParser;
 }
 
 namespace lp {
 enum class LPSolverType {
-    CLP, CPLEX, GUROBI, SOPLEX
+    CLP, CPLEX, GUROBI, SOPLEX, DUAL_SIMPLEX
 };
 
 enum class LPObjectiveSense {
@@ -43,6 +24,7 @@ enum class LPObjectiveSense {
 void add_lp_solver_option_to_parser(options::OptionParser &parser);
 
 class LinearProgram;
+class SolverInterface;
 
 class LPConstraint {
     std::vector<int> variables;
@@ -108,61 +90,38 @@ public:
     const std::string &get_objective_name() const;
 };
 
-#ifdef __GNUG__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#endif
+/*
+  Interface to the LP solvers. The planner always includes our own dual
+  simplex implementation (LPSolverType::DUAL_SIMPLEX). All other solvers
+  are accessed through OSI and only available if the planner is compiled
+  with USE_LP.
+*/
 class LPSolver {
-    bool is_initialized;
-    bool is_mip;
-    bool is_solved;
-    int num_permanent_constraints;
-    bool has_temporary_constraints_;
-#ifdef USE_LP
-    std::unique_ptr<OsiSolverInterface> lp_solver;
-#endif
-
-    /*
-      Temporary data for assigning a new problem. We keep the vectors
-      around to avoid recreating them in every assignment.
-    */
-    std::vector<double> elements;
-    std::vector<int> indices;
-    std::vector<int> starts;
-    std::vector<double> col_lb;
-    std::vector<double> col_ub;
-    std::vector<double> objective;
-    std::vector<double> row_lb;
-    std::vector<double> row_ub;
-    std::vector<CoinPackedVectorBase *> rows;
-    void clear_temporary_data();
+    std::unique_ptr<SolverInterface> pimpl;
+    int num_solves;
+    int64_t num_simplex_iterations;
 public:
-    LP_METHOD(explicit LPSolver(LPSolverType solver_type))
-    /*
-      Note that the destructor does not use LP_METHOD because it should not
-      have the attribute NO_RETURN. It also cannot be set to the default
-      destructor here (~LPSolver() = default;) because OsiSolverInterface
-      is a forward declaration and the incomplete type cannot be destroyed.
-    */
+    explicit LPSolver(LPSolverType solver_type);
     ~LPSolver();
 
-    LP_METHOD(void load_problem(const LinearProgram &lp))
-    LP_METHOD(void add_temporary_constraints(const std::vector<LPConstraint> &constraints))
-    LP_METHOD(void clear_temporary_constraints())
-    LP_METHOD(double get_infinity() const)
+    void load_problem(const LinearProgram &lp);
+    void add_temporary_constraints(const std::vector<LPConstraint> &constraints);
+    void clear_temporary_constraints();
+    double get_infinity() const;
 
-    LP_METHOD(void set_objective_coefficients(const std::vector<double> &coefficients))
-    LP_METHOD(void set_objective_coefficient(int index, double coefficient))
-    LP_METHOD(void set_constraint_lower_bound(int index, double bound))
-    LP_METHOD(void set_constraint_upper_bound(int index, double bound))
-    LP_METHOD(void set_variable_lower_bound(int index, double bound))
-    LP_METHOD(void set_variable_upper_bound(int index, double bound))
+    void set_objective_coefficients(const std::vector<double> &coefficients);
+    void set_objective_coefficient(int index, double coefficient);
+    void set_constraint_lower_bound(int index, double bound);
+    void set_constraint_upper_bound(int index, double bound);
+    void set_variable_lower_bound(int index, double bound);
+    void set_variable_upper_bound(int index, double bound);
 
-    LP_METHOD(void solve())
-    LP_METHOD(void write_lp(const std::string &filename) const)
-    LP_METHOD(void print_failure_analysis() const)
-    LP_METHOD(bool is_infeasible() const)
-    LP_METHOD(bool is_unbounded() const)
+    void solve();
+
+    void write_lp(const std::string &filename) const;
+    void print_failure_analysis() const;
+    bool is_infeasible() const;
+    bool is_unbounded() const;
 
     /*
       Return true if the solving the LP showed that it is bounded feasible and
@@ -171,14 +130,14 @@ public:
       solutions due to numerical difficulties.
       The LP has to be solved with a call to solve() before calling this method.
     */
-    LP_METHOD(bool has_optimal_solution() const)
+    bool has_optimal_solution() const;
 
     /*
       Return the objective value found after solving an LP.
       The LP has to be solved with a call to solve() and has to have an optimal
       solution before calling this method.
     */
-    LP_METHOD(double get_objective_value() const)
+    double get_objective_value() const;
 
     /*
       Return the solution found after solving an LP as a vector with one entry
@@ -186,16 +145,13 @@ public:
       The LP has to be solved with a call to solve() and has to have an optimal
       solution before calling this method.
     */
-    LP_METHOD(std::vector<double> extract_solution() const)
+    std::vector<double> extract_solution() const;
 
-    LP_METHOD(int get_num_variables() const)
-    LP_METHOD(int get_num_constraints() const)
-    LP_METHOD(int has_temporary_constraints() const)
-    LP_METHOD(void print_statistics() const)
+    int get_num_variables() const;
+    int get_num_constraints() const;
+    bool has_temporary_constraints() const;
+    void print_statistics() const;
 };
-#ifdef __GNUG__
-#pragma GCC diagnostic pop
-#endif
 }
 
 #endif
@@ -0,0 +1,49 @@
+#ifndef LP_SOLVER_INTERFACE_H
+#define LP_SOLVER_INTERFACE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lp {
+class LinearProgram;
+class LPConstraint;
+
+/*
+  Backend of LPSolver. See LPSolver for the documentation of the methods.
+*/
+class SolverInterface {
+public:
+    virtual ~SolverInterface() = default;
+
+    virtual void load_problem(const LinearProgram &lp) = 0;
+    virtual void add_temporary_constraints(const std::vector<LPConstraint> &constraints) = 0;
+    virtual void clear_temporary_constraints() = 0;
+    virtual double get_infinity() const = 0;
+
+    virtual void set_objective_coefficients(const std::vector<double> &coefficients) = 0;
+    virtual void set_objective_coefficient(int index, double coefficient) = 0;
+    virtual void set_constraint_lower_bound(int index, double bound) = 0;
+    virtual void set_constraint_upper_bound(int index, double bound) = 0;
+    virtual void set_variable_lower_bound(int index, double bound) = 0;
+    virtual void set_variable_upper_bound(int index, double bound) = 0;
+
+    virtual void solve() = 0;
+    // Return the number of simplex iterations of the last call to solve().
+    virtual int get_iteration_count() const = 0;
+
+    virtual void write_lp(const std::string &filename) const = 0;
+    virtual void print_failure_analysis() const = 0;
+    virtual bool is_infeasible() const = 0;
+    virtual bool is_unbounded() const = 0;
+    virtual bool has_optimal_solution() const = 0;
+    virtual double get_objective_value() const = 0;
+    virtual std::vector<double> extract_solution() const = 0;
+
+    virtual int get_num_variables() const = 0;
+    virtual int get_num_constraints() const = 0;
+    virtual bool has_temporary_constraints() const = 0;
+};
+}
+
+#endif
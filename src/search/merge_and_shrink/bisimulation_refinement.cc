@@ -0,0 +1,355 @@
+#include "bisimulation_refinement.h"
+
+#include "../utils/language.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace merge_and_shrink {
+/*
+  Terminology (following Paige and Tarjan): the partition Q of the states
+  consists of blocks. A coarser partition X consists of compound blocks,
+  each of which is a union of blocks. Q is stable with respect to every
+  compound block. Once every compound block consists of a single block,
+  Q is stable with respect to itself and hence a bisimulation.
+
+  We repeatedly remove a block B with at most half the states from a
+  compound block S and split all blocks with respect to B and S \ B. To do
+  so in time proportional to the number of transitions into B, we maintain
+  a counter for each state x, label l and compound block S that counts the
+  transitions from x with label l into S.
+*/
+class BisimulationRefinement {
+    struct Block {
+        // The states of the block are elements[begin], ..., elements[end - 1].
+        int begin;
+        int end;
+        // Marked states are stored before all unmarked states.
+        int marked_end;
+        int compound_block;
+
+        Block(int begin, int end, int compound_block)
+            : begin(begin), end(end), marked_end(begin),
+              compound_block(compound_block) {
+        }
+
+        int size() const {
+            return end - begin;
+        }
+    };
+
+    const vector<LabeledTransition> &transitions;
+
+    vector<int> elements;
+    vector<int> position;
+    vector<int> state_to_block;
+    vector<Block> blocks;
+    vector<int> touched_blocks;
+
+    vector<vector<int>> compound_blocks;
+    // Compound blocks that consist of more than one block.
+    vector<int> splittable_compound_blocks;
+    vector<bool> is_splittable;
+
+    // IDs of incoming transitions, grouped by target state.
+    vector<int> incoming_begin;
+    vector<int> incoming_transitions;
+
+    // See class comment.
+    vector<int> transition_to_counter;
+    vector<int> counter_values;
+    vector<int> counter_src;
+    // Scratch space indexed by counters.
+    vector<int> num_transitions_into_splitter;
+    vector<int> new_counter;
+
+    // Scratch space for splitting.
+    vector<int> splitter_states;
+    vector<vector<int>> transitions_into_splitter_by_label;
+    vector<int> splitter_labels;
+    vector<int> touched_counters;
+
+    int get_num_states() const {
+        return elements.size();
+    }
+
+    void mark(int state) {
+        int block_id = state_to_block[state];
+        Block &block = blocks[block_id];
+        int pos = position[state];
+        if (pos < block.marked_end)
+            return;
+        if (block.marked_end == block.begin)
+            touched_blocks.push_back(block_id);
+        int other_state = elements[block.marked_end];
+        swap(elements[pos], elements[block.marked_end]);
+        position[state] = block.marked_end;
+        position[other_state] = pos;
+        ++block.marked_end;
+    }
+
+    void add_block_to_compound_block(int block_id, int compound_block_id) {
+        vector<int> &compound_block = compound_blocks[compound_block_id];
+        compound_block.push_back(block_id);
+        if (compound_block.size() == 2 && !is_splittable[compound_block_id]) {
+            is_splittable[compound_block_id] = true;
+            splittable_compound_blocks.push_back(compound_block_id);
+        }
+    }
+
+    // Move the marked states of each touched block to a new block.
+    void split_touched_blocks() {
+        for (int block_id : touched_blocks) {
+            Block &block = blocks[block_id];
+            if (block.marked_end == block.end) {
+                // All states are marked: nothing to split.
+                block.marked_end = block.begin;
+                continue;
+            }
+            int new_block_id = blocks.size();
+            int new_begin = block.begin;
+            int new_end = block.marked_end;
+            int compound_block_id = block.compound_block;
+            block.begin = new_end;
+            // Invalidates the reference "block".
+            blocks.emplace_back(new_begin, new_end, compound_block_id);
+            for (int pos = new_begin; pos < new_end; ++pos) {
+                state_to_block[elements[pos]] = new_block_id;
+            }
+            add_block_to_compound_block(new_block_id, compound_block_id);
+        }
+        touched_blocks.clear();
+    }
+
+    void initialize_blocks(const vector<int> &initial_partition, int num_blocks) {
+        int num_states = initial_partition.size();
+        vector<int> block_begin(num_blocks + 1, 0);
+        for (int block_id : initial_partition) {
+            assert(block_id >= 0 && block_id < num_blocks);
+            ++block_begin[block_id + 1];
+        }
+        for (int block_id = 0; block_id < num_blocks; ++block_id) {
+            block_begin[block_id + 1] += block_begin[block_id];
+        }
+        elements.resize(num_states);
+        position.resize(num_states);
+        state_to_block = initial_partition;
+        vector<int> next_pos(block_begin.begin(), block_begin.end() - 1);
+        for (int state = 0; state < num_states; ++state) {
+            int pos = next_pos[initial_partition[state]]++;
+            elements[pos] = state;
+            position[state] = pos;
+        }
+
+        // Initially, there is a single compound block with all states.
+        compound_blocks.emplace_back();
+        is_splittable.push_back(false);
+        blocks.reserve(num_blocks);
+        for (int block_id = 0; block_id < num_blocks; ++block_id) {
+            blocks.emplace_back(
+                block_begin[block_id], block_begin[block_id + 1], 0);
+            add_block_to_compound_block(block_id, 0);
+        }
+    }
+
+    void initialize_transitions(int num_labels) {
+        int num_states = get_num_states();
+        incoming_begin.assign(num_states + 1, 0);
+        for (const LabeledTransition &transition : transitions) {
+            ++incoming_begin[transition.target + 1];
+        }
+        for (int state = 0; state < num_states; ++state) {
+            incoming_begin[state + 1] += incoming_begin[state];
+        }
+        incoming_transitions.resize(transitions.size());
+        vector<int> next_pos(incoming_begin.begin(), incoming_begin.end() - 1);
+        transition_to_counter.resize(transitions.size());
+        for (size_t id = 0; id < transitions.size(); ++id) {
+            const LabeledTransition &transition = transitions[id];
+            incoming_transitions[next_pos[transition.target]++] = id;
+
+            // All transitions lead into the single compound block.
+            bool same_counter = false;
+            if (id > 0) {
+                const LabeledTransition &prev = transitions[id - 1];
+                assert(prev.label < transition.label ||
+                       (prev.label == transition.label &&
+                        prev.src <= transition.src));
+                same_counter = prev.label == transition.label &&
+                    prev.src == transition.src;
+            }
+            if (!same_counter) {
+                counter_values.push_back(0);
+                counter_src.push_back(transition.src);
+            }
+            transition_to_counter[id] = counter_values.size() - 1;
+            ++counter_values.back();
+        }
+        num_transitions_into_splitter.assign(counter_values.size(), 0);
+        new_counter.assign(counter_values.size(), -1);
+        transitions_into_splitter_by_label.resize(num_labels);
+    }
+
+    /*
+      Make the partition stable with respect to the initial compound block
+      (the set of all states) by separating the states with and without
+      outgoing transitions for each label.
+    */
+    void split_by_outgoing_labels() {
+        size_t id = 0;
+        while (id < transitions.size()) {
+            int label = transitions[id].label;
+            for (; id < transitions.size() && transitions[id].label == label;
+                 ++id) {
+                mark(transitions[id].src);
+            }
+            split_touched_blocks();
+        }
+    }
+
+    /*
+      Split all blocks with respect to the splitter block and the rest of
+      the compound block S that contained it, considering the given
+      transitions with the same label into the splitter block.
+    */
+    void split_by_label(const vector<int> &transition_ids) {
+        assert(touched_counters.empty());
+        // Separate predecessors of the splitter block.
+        for (int id : transition_ids) {
+            int counter = transition_to_counter[id];
+            if (num_transitions_into_splitter[counter]++ == 0) {
+                touched_counters.push_back(counter);
+            }
+            mark(transitions[id].src);
+        }
+        split_touched_blocks();
+
+        // Separate predecessors of the splitter block that are no
+        // predecessors of the rest of S.
+        for (int counter : touched_counters) {
+            if (num_transitions_into_splitter[counter] ==
+                counter_values[counter]) {
+                mark(counter_src[counter]);
+            }
+        }
+        split_touched_blocks();
+
+        // Introduce counters for the transitions into the splitter block.
+        for (int counter : touched_counters) {
+            int num_transitions = num_transitions_into_splitter[counter];
+            if (num_transitions == counter_values[counter]) {
+                // No transitions into the rest of S: reuse the counter.
+                new_counter[counter] = counter;
+            } else {
+                counter_values[counter] -= num_transitions;
+                new_counter[counter] = counter_values.size();
+                counter_values.push_back(num_transitions);
+                counter_src.push_back(counter_src[counter]);
+                num_transitions_into_splitter.push_back(0);
+                new_counter.push_back(-1);
+            }
+        }
+        for (int id : transition_ids) {
+            transition_to_counter[id] = new_counter[transition_to_counter[id]];
+        }
+        for (int counter : touched_counters) {
+            num_transitions_into_splitter[counter] = 0;
+            new_counter[counter] = -1;
+        }
+        touched_counters.clear();
+    }
+
+    void split(int splitter_block_id) {
+        const Block &splitter = blocks[splitter_block_id];
+        // The splitter block itself may be split below.
+        splitter_states.assign(
+            elements.begin() + splitter.begin, elements.begin() + splitter.end);
+        for (int state : splitter_states) {
+            for (int i = incoming_begin[state]; i < incoming_begin[state + 1];
+                 ++i) {
+                int id = incoming_transitions[i];
+                vector<int> &label_transitions =
+                    transitions_into_splitter_by_label[transitions[id].label];
+                if (label_transitions.empty()) {
+                    splitter_labels.push_back(transitions[id].label);
+                }
+                label_transitions.push_back(id);
+            }
+        }
+        for (int label : splitter_labels) {
+            vector<int> &label_transitions =
+                transitions_into_splitter_by_label[label];
+            split_by_label(label_transitions);
+            label_transitions.clear();
+        }
+        splitter_labels.clear();
+    }
+
+public:
+    BisimulationRefinement(
+        int num_labels,
+        const vector<LabeledTransition> &transitions,
+        const vector<int> &initial_partition,
+        int num_blocks)
+        : transitions(transitions) {
+        initialize_blocks(initial_partition, num_blocks);
+        initialize_transitions(num_labels);
+    }
+
+    int refine(int max_num_blocks) {
+        split_by_outgoing_labels();
+        while (!splittable_compound_blocks.empty() &&
+               static_cast<int>(blocks.size()) < max_num_blocks) {
+            int compound_block_id = splittable_compound_blocks.back();
+            vector<int> &compound_block = compound_blocks[compound_block_id];
+            assert(compound_block.size() >= 2);
+
+            // Remove the smaller of the last two blocks from the compound block.
+            int last = compound_block.back();
+            int second_last = compound_block[compound_block.size() - 2];
+            int splitter_block_id;
+            if (blocks[last].size() <= blocks[second_last].size()) {
+                splitter_block_id = last;
+            } else {
+                splitter_block_id = second_last;
+                compound_block[compound_block.size() - 2] = last;
+            }
+            compound_block.pop_back();
+            if (compound_block.size() < 2) {
+                splittable_compound_blocks.pop_back();
+                is_splittable[compound_block_id] = false;
+            }
+
+            // The splitter block forms a new compound block.
+            blocks[splitter_block_id].compound_block = compound_blocks.size();
+            compound_blocks.push_back(vector<int>(1, splitter_block_id));
+            is_splittable.push_back(false);
+
+            split(splitter_block_id);
+        }
+        return blocks.size();
+    }
+
+    const vector<int> &get_state_to_block() const {
+        return state_to_block;
+    }
+};
+
+int compute_coarsest_bisimulation(
+    int num_states,
+    int num_labels,
+    const vector<LabeledTransition> &transitions,
+    vector<int> &state_to_block,
+    int num_blocks,
+    int max_num_blocks) {
+    assert(static_cast<int>(state_to_block.size()) == num_states);
+    utils::unused_variable(num_states);
+    BisimulationRefinement refinement(
+        num_labels, transitions, state_to_block, num_blocks);
+    int num_refined_blocks = refinement.refine(max_num_blocks);
+    state_to_block = refinement.get_state_to_block();
+    return num_refined_blocks;
+}
+}
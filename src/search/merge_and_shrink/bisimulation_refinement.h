@@ -0,0 +1,43 @@
+#ifndef MERGE_AND_SHRINK_BISIMULATION_REFINEMENT_H
+#define MERGE_AND_SHRINK_BISIMULATION_REFINEMENT_H
+
+#include <vector>
+
+namespace merge_and_shrink {
+struct LabeledTransition {
+    int src;
+    int label;
+    int target;
+
+    LabeledTransition(int src, int label, int target)
+        : src(src), label(label), target(target) {
+    }
+};
+
+/*
+  Compute the coarsest bisimulation of a labeled transition system that
+  refines a given initial partition, using the relational coarsest
+  partition algorithm by Paige and Tarjan (SIAM Journal on Computing 1987),
+  generalized to several labels. For n states and m transitions, this
+  takes O(m log n) time (plus O(n + number of labels)).
+
+  Labels must be numbered 0, ..., num_labels - 1 and the transitions must
+  be sorted by label and, for the same label, by source state. There must
+  be no duplicate transitions.
+
+  state_to_block maps each state to its block in 0, ..., num_blocks - 1.
+  On return, it maps each state to its block in the refined partition and
+  the result is the number of blocks of the refined partition. The
+  computation stops once the partition has at least max_num_blocks blocks.
+  In that case, the result is only a partial refinement.
+*/
+extern int compute_coarsest_bisimulation(
+    int num_states,
+    int num_labels,
+    const std::vector<LabeledTransition> &transitions,
+    std::vector<int> &state_to_block,
+    int num_blocks,
+    int max_num_blocks);
+}
+
+#endif
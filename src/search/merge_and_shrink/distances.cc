@@ -3,9 +3,11 @@
 #include "label_equivalence_relation.h"
 #include "transition_system.h"
 
-#include "../algorithms/priority_queues.h"
+#include "../algorithms/monotone_priority_queues.h"
 #include "../utils/logging.h"
+#include "../utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 
@@ -15,7 +17,8 @@ namespace merge_and_shrink {
 const int Distances::DISTANCE_UNKNOWN;
 
 Distances::Distances(const TransitionSystem &transition_system)
-    : transition_system(transition_system) {
+    : transition_system(transition_system),
+      computation_time(0) {
     clear_distances();
 }
 
@@ -47,14 +50,66 @@ bool Distances::is_unit_cost() const {
     return true;
 }
 
+int Distances::get_max_cost() const {
+    int max_cost = 0;
+    for (GroupAndTransitions gat : transition_system) {
+        max_cost = max(max_cost, gat.label_group.get_cost());
+    }
+    return max_cost;
+}
+
+/*
+  Graph of the transition system in compressed sparse row format: the
+  successors of state s are successors[begin[s]], ...,
+  successors[begin[s + 1] - 1] with the given costs. For backward graphs,
+  the successors are the predecessors in the transition system.
+*/
+struct ExplicitGraph {
+    vector<int> begin;
+    vector<int> successors;
+    vector<int> costs;
+};
+
+static void build_graph(
+    const TransitionSystem &transition_system, bool backward,
+    bool with_costs, ExplicitGraph &graph) {
+    int num_states = transition_system.get_size();
+    graph.begin.assign(num_states + 1, 0);
+    for (GroupAndTransitions gat : transition_system) {
+        for (const Transition &transition : gat.transitions) {
+            int state = backward ? transition.target : transition.src;
+            ++graph.begin[state + 1];
+        }
+    }
+    for (int state = 0; state < num_states; ++state) {
+        graph.begin[state + 1] += graph.begin[state];
+    }
+    graph.successors.resize(graph.begin[num_states]);
+    if (with_costs) {
+        graph.costs.resize(graph.begin[num_states]);
+    }
+    vector<int> next_pos(graph.begin.begin(), graph.begin.end() - 1);
+    for (GroupAndTransitions gat : transition_system) {
+        int cost = gat.label_group.get_cost();
+        for (const Transition &transition : gat.transitions) {
+            int state = backward ? transition.target : transition.src;
+            int pos = next_pos[state]++;
+            graph.successors[pos] = backward ? transition.src : transition.target;
+            if (with_costs) {
+                graph.costs[pos] = cost;
+            }
+        }
+    }
+}
+
 static void breadth_first_search(
-    const vector<vector<int>> &graph, deque<int> &queue,
+    const ExplicitGraph &graph, deque<int> &queue,
     vector<int> &distances) {
     while (!queue.empty()) {
         int state = queue.front();
         queue.pop_front();
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            int successor = graph[state][i];
+        for (int i = graph.begin[state]; i < graph.begin[state + 1]; ++i) {
+            int successor = graph.successors[i];
             if (distances[successor] > distances[state] + 1) {
                 distances[successor] = distances[state] + 1;
                 queue.push_back(successor);
@@ -64,13 +119,8 @@ static void breadth_first_search(
 }
 
 void Distances::compute_init_distances_unit_cost() {
-    vector<vector<int>> forward_graph(get_num_states());
-    for (GroupAndTransitions gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(transition.target);
-        }
-    }
+    ExplicitGraph forward_graph;
+    build_graph(transition_system, false, false, forward_graph);
 
     deque<int> queue;
     queue.push_back(transition_system.get_init_state());
@@ -79,13 +129,8 @@ void Distances::compute_init_distances_unit_cost() {
 }
 
 void Distances::compute_goal_distances_unit_cost() {
-    vector<vector<int>> backward_graph(get_num_states());
-    for (GroupAndTransitions gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(transition.src);
-        }
-    }
+    ExplicitGraph backward_graph;
+    build_graph(transition_system, true, false, backward_graph);
 
     deque<int> queue;
     for (int state = 0; state < get_num_states(); ++state) {
@@ -98,8 +143,8 @@ void Distances::compute_goal_distances_unit_cost() {
 }
 
 static void dijkstra_search(
-    const vector<vector<pair<int, int>>> &graph,
-    priority_queues::AdaptiveQueue<int> &queue,
+    const ExplicitGraph &graph,
+    priority_queues::MonotoneQueue<int> &queue,
     vector<int> &distances) {
     while (!queue.empty()) {
         pair<int, int> top_pair = queue.pop();
@@ -109,10 +154,9 @@ static void dijkstra_search(
         assert(state_distance <= distance);
         if (state_distance < distance)
             continue;
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            const pair<int, int> &transition = graph[state][i];
-            int successor = transition.first;
-            int cost = transition.second;
+        for (int i = graph.begin[state]; i < graph.begin[state + 1]; ++i) {
+            int successor = graph.successors[i];
+            int cost = graph.costs[i];
             int successor_cost = state_distance + cost;
             if (distances[successor] > successor_cost) {
                 distances[successor] = successor_cost;
@@ -123,40 +167,20 @@ static void dijkstra_search(
 }
 
 void Distances::compute_init_distances_general_cost() {
-    vector<vector<pair<int, int>>> forward_graph(get_num_states());
-    for (GroupAndTransitions gat : transition_system) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        int cost = label_group.get_cost();
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(
-                make_pair(transition.target, cost));
-        }
-    }
+    ExplicitGraph forward_graph;
+    build_graph(transition_system, false, true, forward_graph);
 
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_goal_distances_general_cost.
-    priority_queues::AdaptiveQueue<int> queue;
+    priority_queues::MonotoneQueue<int> queue(get_max_cost());
     init_distances[transition_system.get_init_state()] = 0;
     queue.push(0, transition_system.get_init_state());
     dijkstra_search(forward_graph, queue, init_distances);
 }
 
 void Distances::compute_goal_distances_general_cost() {
-    vector<vector<pair<int, int>>> backward_graph(get_num_states());
-    for (GroupAndTransitions gat : transition_system) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        int cost = label_group.get_cost();
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(
-                make_pair(transition.src, cost));
-        }
-    }
+    ExplicitGraph backward_graph;
+    build_graph(transition_system, true, true, backward_graph);
 
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_init_distances_general_cost.
-    priority_queues::AdaptiveQueue<int> queue;
+    priority_queues::MonotoneQueue<int> queue(get_max_cost());
     for (int state = 0; state < get_num_states(); ++state) {
         if (transition_system.is_goal_state(state)) {
             goal_distances[state] = 0;
@@ -198,6 +222,7 @@ void Distances::compute_distances(
         assert(init_distances.empty() && goal_distances.empty());
     }
 
+    utils::Timer timer;
     if (verbosity >= utils::Verbosity::VERBOSE) {
         utils::g_log << transition_system.tag();
     }
@@ -250,8 +275,9 @@ void Distances::compute_distances(
             compute_goal_distances_general_cost();
         }
     }
+    computation_time += timer();
     if (verbosity >= utils::Verbosity::VERBOSE) {
-        utils::g_log << " algorithm" << endl;
+        utils::g_log << " algorithm (" << timer << ")" << endl;
     }
 
     if (compute_init_distances) {
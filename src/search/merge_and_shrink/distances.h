@@ -28,10 +28,13 @@ class Distances {
     std::vector<int> goal_distances;
     bool init_distances_computed;
     bool goal_distances_computed;
+    // Time spent on computing distances for this transition system.
+    double computation_time;
 
     void clear_distances();
     int get_num_states() const;
     bool is_unit_cost() const;
+    int get_max_cost() const;
 
     void compute_init_distances_unit_cost();
     void compute_goal_distances_unit_cost();
@@ -49,6 +52,10 @@ public:
         return goal_distances_computed;
     }
 
+    double get_computation_time() const {
+        return computation_time;
+    }
+
     void compute_distances(
         bool compute_init_distances,
         bool compute_goal_distances,
@@ -48,10 +48,12 @@ FactoredTransitionSystem::FactoredTransitionSystem(
       transition_systems(move(transition_systems)),
       mas_representations(move(mas_representations)),
       distances(move(distances)),
+      next_version(0),
       compute_init_distances(compute_init_distances),
       compute_goal_distances(compute_goal_distances),
       num_active_entries(this->transition_systems.size()) {
     for (size_t index = 0; index < this->transition_systems.size(); ++index) {
+        versions.push_back(next_version++);
         if (compute_init_distances || compute_goal_distances) {
             this->distances[index]->compute_distances(
                 compute_init_distances, compute_goal_distances, verbosity);
@@ -60,11 +62,24 @@ FactoredTransitionSystem::FactoredTransitionSystem(
     }
 }
 
+FactoredTransitionSystem::FactoredTransitionSystem(
+    const shared_ptr<Labels> &labels,
+    const bool compute_init_distances,
+    const bool compute_goal_distances)
+    : labels(labels),
+      next_version(0),
+      compute_init_distances(compute_init_distances),
+      compute_goal_distances(compute_goal_distances),
+      num_active_entries(0) {
+}
+
 FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&other)
     : labels(move(other.labels)),
       transition_systems(move(other.transition_systems)),
       mas_representations(move(other.mas_representations)),
       distances(move(other.distances)),
+      versions(move(other.versions)),
+      next_version(move(other.next_version)),
       compute_init_distances(move(other.compute_init_distances)),
       compute_goal_distances(move(other.compute_goal_distances)),
       num_active_entries(move(other.num_active_entries)) {
@@ -123,6 +138,9 @@ void FactoredTransitionSystem::apply_label_mapping(
                 label_mapping, static_cast<int>(i) != combinable_index);
         }
     }
+    if (combinable_index != -1 && transition_systems[combinable_index]) {
+        versions[combinable_index] = next_version++;
+    }
     assert_all_components_valid();
 }
 
@@ -151,6 +169,7 @@ bool FactoredTransitionSystem::apply_abstraction(
     }
     mas_representations[index]->apply_abstraction_to_lookup_table(
         abstraction_mapping);
+    versions[index] = next_version++;
 
     /* If distances need to be recomputed, this already happened in the
        Distances object. */
@@ -180,6 +199,7 @@ int FactoredTransitionSystem::merge(
             move(mas_representations[index2])));
     mas_representations[index1] = nullptr;
     mas_representations[index2] = nullptr;
+    versions.push_back(next_version++);
     const TransitionSystem &new_ts = *transition_systems.back();
     distances.push_back(utils::make_unique_ptr<Distances>(new_ts));
     int new_index = transition_systems.size() - 1;
@@ -193,6 +213,28 @@ int FactoredTransitionSystem::merge(
     return new_index;
 }
 
+FactoredTransitionSystem FactoredTransitionSystem::create_subsystem() const {
+    return FactoredTransitionSystem(
+        labels, compute_init_distances, compute_goal_distances);
+}
+
+int FactoredTransitionSystem::move_factor(
+    int index, FactoredTransitionSystem &other) {
+    assert(labels == other.labels);
+    assert(compute_init_distances == other.compute_init_distances);
+    assert(compute_goal_distances == other.compute_goal_distances);
+    assert(is_component_valid(index));
+    other.transition_systems.push_back(move(transition_systems[index]));
+    other.mas_representations.push_back(move(mas_representations[index]));
+    other.distances.push_back(move(distances[index]));
+    other.versions.push_back(other.next_version++);
+    --num_active_entries;
+    ++other.num_active_entries;
+    int new_index = other.transition_systems.size() - 1;
+    assert(other.is_component_valid(new_index));
+    return new_index;
+}
+
 pair<unique_ptr<MergeAndShrinkRepresentation>, unique_ptr<Distances>>
 FactoredTransitionSystem::extract_factor(int index) {
     assert(is_component_valid(index));
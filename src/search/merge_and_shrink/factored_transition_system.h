@@ -58,11 +58,19 @@ public:
   interface that this class shows to the outside world.
 */
 class FactoredTransitionSystem {
-    std::unique_ptr<Labels> labels;
+    // Shared with subsystems (see create_subsystem).
+    std::shared_ptr<Labels> labels;
     // Entries with nullptr have been merged.
     std::vector<std::unique_ptr<TransitionSystem>> transition_systems;
     std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> mas_representations;
     std::vector<std::unique_ptr<Distances>> distances;
+    /*
+      Every transformation that changes a factor assigns it a new version.
+      This allows users to cache information about factors across
+      iterations (see MergeScoreCache).
+    */
+    std::vector<int> versions;
+    int next_version;
     const bool compute_init_distances;
     const bool compute_goal_distances;
     int num_active_entries;
@@ -81,6 +89,12 @@ class FactoredTransitionSystem {
     bool is_component_valid(int index) const;
 
     void assert_all_components_valid() const;
+
+    // Create an empty factored transition system with the given labels.
+    FactoredTransitionSystem(
+        const std::shared_ptr<Labels> &labels,
+        bool compute_init_distances,
+        bool compute_goal_distances);
 public:
     FactoredTransitionSystem(
         std::unique_ptr<Labels> labels,
@@ -133,6 +147,22 @@ public:
         int index2,
         utils::Verbosity verbosity);
 
+    /*
+      Create an empty factored transition system that shares the labels with
+      this one. Factors can be moved between the two with move_factor.
+      Subsystems allow transforming disjoint sets of factors independently
+      (e.g., in different threads). The shared labels must not be reduced
+      while factors are kept in a subsystem.
+    */
+    FactoredTransitionSystem create_subsystem() const;
+
+    /*
+      Move the factor at the given index to the given factored transition
+      system, which must share the labels with this one. Return the index of
+      the factor in the other factored transition system.
+    */
+    int move_factor(int index, FactoredTransitionSystem &other);
+
     /*
       Extract the factor at the given index, rendering the FTS invalid.
     */
@@ -151,6 +181,17 @@ public:
         return *distances[index];
     }
 
+    /*
+      The version of a factor changes whenever its transition system or its
+      distances change. Applying a label mapping only changes the version
+      of the factor at combinable_index: in all other factors, only locally
+      equivalent labels are combined, which renames labels but preserves
+      the structure of the transition system.
+    */
+    int get_version(int index) const {
+        return versions[index];
+    }
+
     /*
       A factor is solvabe iff the distance of the initial state to some goal
       state is not infinity. Technically, the distance is infinity either if
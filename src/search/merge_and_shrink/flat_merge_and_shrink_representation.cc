@@ -0,0 +1,153 @@
+#include "flat_merge_and_shrink_representation.h"
+
+#include "merge_and_shrink_representation.h"
+#include "types.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+using namespace std;
+
+namespace merge_and_shrink {
+static const int HEADER_SIZE = 2;
+static const int NODE_SIZE = 4;
+
+FlatMergeAndShrinkRepresentation::FlatMergeAndShrinkRepresentation(
+    const MergeAndShrinkRepresentation &representation) {
+    vector<int> nodes;
+    vector<int> tables;
+    representation.append_to_flat_representation(nodes, tables);
+    assert(nodes.size() % NODE_SIZE == 0);
+    int num_nodes = nodes.size() / NODE_SIZE;
+    int tables_offset = HEADER_SIZE + nodes.size();
+    for (int node = 0; node < num_nodes; ++node) {
+        nodes[node * NODE_SIZE + 1] += tables_offset;
+    }
+
+    owned_data.reserve(tables_offset + tables.size());
+    owned_data.push_back(num_nodes);
+    // Placeholder for the maximum stack size.
+    owned_data.push_back(0);
+    owned_data.insert(owned_data.end(), nodes.begin(), nodes.end());
+    owned_data.insert(owned_data.end(), tables.begin(), tables.end());
+
+    int stack_size = 0;
+    int max_stack_size = 0;
+    for (int node = 0; node < num_nodes; ++node) {
+        if (nodes[node * NODE_SIZE] == -1) {
+            --stack_size;
+        } else {
+            ++stack_size;
+        }
+        max_stack_size = max(max_stack_size, stack_size);
+    }
+    assert(stack_size == 1);
+    owned_data[1] = max_stack_size;
+
+    data = owned_data.data();
+    size = owned_data.size();
+    initialize_stack();
+}
+
+FlatMergeAndShrinkRepresentation::FlatMergeAndShrinkRepresentation(
+    const int *data, size_t size)
+    : data(data),
+      size(size) {
+    initialize_stack();
+}
+
+void FlatMergeAndShrinkRepresentation::initialize_stack() {
+    stack.resize(data[1]);
+}
+
+bool FlatMergeAndShrinkRepresentation::is_well_formed(
+    const int *data, size_t size, const vector<int> &domain_sizes) {
+    if (size < static_cast<size_t>(HEADER_SIZE)) {
+        return false;
+    }
+    int num_nodes = data[0];
+    int max_stack_size = data[1];
+    if (num_nodes <= 0 ||
+        static_cast<size_t>(num_nodes) >
+        (size - HEADER_SIZE) / NODE_SIZE) {
+        return false;
+    }
+    /*
+      The entries of a table index the rows (for left children) or columns
+      (for right children) of the table of the parent node. The entries of
+      the root table are goal distances. We use -1 for "no upper bound".
+    */
+    vector<int> entry_bounds(num_nodes, -1);
+    vector<int> stack;
+    for (int node = 0; node < num_nodes; ++node) {
+        const int *record = data + HEADER_SIZE + node * NODE_SIZE;
+        int var = record[0];
+        int64_t table_offset = record[1];
+        int64_t num_rows = record[2];
+        int64_t num_cols = record[3];
+        if (num_rows < 0 || num_cols < 0 ||
+            table_offset < HEADER_SIZE + num_nodes * NODE_SIZE ||
+            table_offset + num_rows * num_cols > static_cast<int64_t>(size)) {
+            return false;
+        }
+        if (var == -1) {
+            if (stack.size() < 2) {
+                return false;
+            }
+            entry_bounds[stack.back()] = num_cols;
+            stack.pop_back();
+            entry_bounds[stack.back()] = num_rows;
+            stack.pop_back();
+        } else if (var < 0 || var >= static_cast<int>(domain_sizes.size()) ||
+                   domain_sizes[var] != num_rows || num_cols != 1) {
+            return false;
+        }
+        stack.push_back(node);
+        if (static_cast<int>(stack.size()) > max_stack_size) {
+            return false;
+        }
+    }
+    if (stack.size() != 1) {
+        return false;
+    }
+
+    for (int node = 0; node < num_nodes; ++node) {
+        const int *record = data + HEADER_SIZE + node * NODE_SIZE;
+        const int *table = data + record[1];
+        const int *table_end = table + static_cast<int64_t>(record[2]) * record[3];
+        int bound = entry_bounds[node];
+        for (const int *entry = table; entry != table_end; ++entry) {
+            if (*entry != PRUNED_STATE &&
+                (*entry < 0 || (bound != -1 && *entry >= bound))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int FlatMergeAndShrinkRepresentation::get_value(const vector<int> &state) const {
+    const int *record = data + HEADER_SIZE;
+    const int *end = record + data[0] * NODE_SIZE;
+    int *top = stack.data();
+    for (; record != end; record += NODE_SIZE) {
+        int var = record[0];
+        const int *table = data + record[1];
+        int value;
+        if (var == -1) {
+            int right_value = *--top;
+            int left_value = *--top;
+            value = table[left_value * record[3] + right_value];
+        } else {
+            value = table[state[var]];
+        }
+        if (value == PRUNED_STATE) {
+            return PRUNED_STATE;
+        }
+        *top++ = value;
+    }
+    assert(top == stack.data() + 1);
+    return stack[0];
+}
+}
@@ -0,0 +1,71 @@
+#ifndef MERGE_AND_SHRINK_FLAT_MERGE_AND_SHRINK_REPRESENTATION_H
+#define MERGE_AND_SHRINK_FLAT_MERGE_AND_SHRINK_REPRESENTATION_H
+
+#include <cstddef>
+#include <vector>
+
+namespace merge_and_shrink {
+class MergeAndShrinkRepresentation;
+
+/*
+  Merge-and-shrink representation stored in a single array of ints, which
+  can be written to and read from disk as is.
+
+  The array starts with a header (number of nodes, maximum number of
+  intermediate values), followed by one record per node of the tree in
+  postorder and finally by the lookup tables of all nodes. A node record
+  consists of the variable (-1 for merge nodes), the position of the
+  lookup table in the array and the number of rows and columns of the
+  lookup table. Leaf nodes have one column, indexed by the value of the
+  variable. Merge nodes have one row for each value of the left child and
+  one column for each value of the right child.
+
+  Lookups evaluate the nodes in postorder on a stack of intermediate
+  values, so they need neither recursion nor virtual calls.
+*/
+class FlatMergeAndShrinkRepresentation {
+    std::vector<int> owned_data;
+    const int *data;
+    std::size_t size;
+    mutable std::vector<int> stack;
+
+    void initialize_stack();
+public:
+    explicit FlatMergeAndShrinkRepresentation(
+        const MergeAndShrinkRepresentation &representation);
+    /*
+      Use the given data without copying it. The data must outlive this
+      object and must satisfy is_well_formed().
+    */
+    FlatMergeAndShrinkRepresentation(const int *data, std::size_t size);
+
+    FlatMergeAndShrinkRepresentation(
+        const FlatMergeAndShrinkRepresentation &) = delete;
+    FlatMergeAndShrinkRepresentation &operator=(
+        const FlatMergeAndShrinkRepresentation &) = delete;
+
+    /*
+      Check that the given data describes a representation over variables
+      with the given domain sizes. This checks the structure of the tree,
+      the positions of the lookup tables and that every table entry is
+      pruned or a valid index into the table of the parent node, so that
+      get_value() never reads outside of the data.
+    */
+    static bool is_well_formed(
+        const int *data, std::size_t size,
+        const std::vector<int> &domain_sizes);
+
+    // See MergeAndShrinkRepresentation::get_value.
+    int get_value(const std::vector<int> &state) const;
+
+    const int *get_data() const {
+        return data;
+    }
+
+    std::size_t get_size() const {
+        return size;
+    }
+};
+}
+
+#endif
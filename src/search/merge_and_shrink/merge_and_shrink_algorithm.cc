@@ -8,6 +8,8 @@
 #include "merge_and_shrink_representation.h"
 #include "merge_strategy.h"
 #include "merge_strategy_factory.h"
+#include "merge_tree.h"
+#include "phase_statistics.h"
 #include "shrink_strategy.h"
 #include "transition_system.h"
 #include "types.h"
@@ -22,9 +24,11 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 #include "../utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -53,6 +57,9 @@ MergeAndShrinkAlgorithm::MergeAndShrinkAlgorithm(const Options &opts) :
     prune_irrelevant_states(opts.get<bool>("prune_irrelevant_states")),
     verbosity(opts.get<utils::Verbosity>("verbosity")),
     main_loop_max_time(opts.get<double>("main_loop_max_time")),
+    main_loop_max_memory(opts.get<int>("main_loop_max_memory")),
+    num_threads(opts.get<int>("num_threads")),
+    trace_file(opts.contains("trace_file") ? opts.get<string>("trace_file") : ""),
     starting_peak_memory(0) {
     assert(max_states_before_merge > 0);
     assert(max_states >= max_states_before_merge);
@@ -98,6 +105,13 @@ void MergeAndShrinkAlgorithm::dump_options() const {
         utils::g_log << endl;
 
         utils::g_log << "Main loop max time in seconds: " << main_loop_max_time << endl;
+        utils::g_log << "Main loop max memory in MiB: ";
+        if (main_loop_max_memory == INF) {
+            utils::g_log << "infinity" << endl;
+        } else {
+            utils::g_log << main_loop_max_memory << endl;
+        }
+        utils::g_log << "Number of threads: " << num_threads << endl;
         utils::g_log << endl;
     }
 }
@@ -139,6 +153,28 @@ void MergeAndShrinkAlgorithm::warn_on_unusual_options() const {
             "drastically reduce the performance of merge-and-shrink!"
                      << endl << dashes << endl;
     }
+
+    if (num_threads > 1 && !can_merge_in_parallel()) {
+        utils::g_log << dashes << endl
+                     << "WARNING! Using several threads is only supported with "
+            "shrinking based on\nbisimulation, without label reduction and "
+            "without a memory budget.\nIgnoring num_threads."
+                     << endl << dashes << endl;
+    }
+}
+
+bool MergeAndShrinkAlgorithm::can_merge_in_parallel() const {
+    /*
+      Merging independent merge trees in parallel yields the same factors
+      as merging them sequentially only if the merges of different trees
+      do not influence each other. Label reduction changes the labels of
+      all factors and the memory budget depends on the memory used by all
+      factors, so we only merge in parallel without them. Shrinking must
+      be deterministic and must not have shared state, which is only the
+      case for bisimulation.
+    */
+    return shrink_strategy->get_name() == "bisimulation" &&
+           !label_reduction && main_loop_max_memory == INF;
 }
 
 bool MergeAndShrinkAlgorithm::ran_out_of_time(
@@ -153,6 +189,195 @@ bool MergeAndShrinkAlgorithm::ran_out_of_time(
     return false;
 }
 
+bool MergeAndShrinkAlgorithm::would_exceed_memory_budget(
+    const FactoredTransitionSystem &fts, int index1, int index2) const {
+    if (main_loop_max_memory == INF) {
+        return false;
+    }
+    const TransitionSystem &ts1 = fts.get_transition_system(index1);
+    const TransitionSystem &ts2 = fts.get_transition_system(index2);
+    /*
+      Roughly estimate the memory needed for the product: its transitions
+      and the graph used for computing its distances, and the distances and
+      goal flags of its states.
+    */
+    size_t num_states = static_cast<size_t>(ts1.get_size()) * ts2.get_size();
+    size_t num_transitions =
+        TransitionSystem::compute_product_num_transitions(ts1, ts2);
+    size_t estimate_in_kb =
+        (num_transitions * (sizeof(Transition) + 2 * sizeof(int)) +
+         num_states * 3 * sizeof(int)) / 1024;
+    size_t budget_in_kb = static_cast<size_t>(main_loop_max_memory) * 1024;
+    size_t peak_memory_in_kb = max(utils::get_peak_memory_in_kb(), 0);
+    if (peak_memory_in_kb + estimate_in_kb > budget_in_kb) {
+        if (verbosity >= utils::Verbosity::NORMAL) {
+            utils::g_log << "Merging would exceed the memory budget (peak "
+                         << "memory: " << peak_memory_in_kb << " KB, estimate "
+                         << "for the product: " << estimate_in_kb << " KB), "
+                         << "stopping computation." << endl;
+            utils::g_log << endl;
+        }
+        return true;
+    }
+    return false;
+}
+
+/*
+  All merges of an independent merge tree, performed on a subsystem of the
+  factored transition system that contains exactly the leaf factors of the
+  tree.
+*/
+struct IndependentMergeJob {
+    unique_ptr<MergeTree> merge_tree;
+    FactoredTransitionSystem fts;
+    int num_merges;
+    int maximum_intermediate_size;
+    bool unsolvable;
+    bool out_of_time;
+
+    IndependentMergeJob(
+        unique_ptr<MergeTree> merge_tree, FactoredTransitionSystem &&fts)
+        : merge_tree(move(merge_tree)),
+          fts(move(fts)),
+          num_merges(this->fts.get_size() - 1),
+          maximum_intermediate_size(0),
+          unsolvable(false),
+          out_of_time(false) {
+    }
+};
+
+bool MergeAndShrinkAlgorithm::merge_independent_trees_in_parallel(
+    FactoredTransitionSystem &fts,
+    MergeStrategy &merge_strategy,
+    const utils::CountdownTimer &timer,
+    int &maximum_intermediate_size) const {
+    /*
+      Give each thread two trees on average to balance the load between
+      trees of different sizes.
+    */
+    vector<unique_ptr<MergeTree>> merge_trees =
+        merge_strategy.extract_independent_merge_trees(2 * num_threads);
+    if (merge_trees.empty()) {
+        if (verbosity >= utils::Verbosity::NORMAL) {
+            utils::g_log << "Merge strategy has no independent merges, "
+                         << "using a single thread." << endl;
+        }
+        return true;
+    }
+
+    // Move the leaf factors of each tree to a subsystem of their own.
+    vector<IndependentMergeJob> jobs;
+    jobs.reserve(merge_trees.size());
+    for (unique_ptr<MergeTree> &merge_tree : merge_trees) {
+        FactoredTransitionSystem sub_fts = fts.create_subsystem();
+        vector<int> new_indices(fts.get_size(), -1);
+        for (int index : merge_tree->get_leaf_indices()) {
+            new_indices[index] = fts.move_factor(index, sub_fts);
+        }
+        merge_tree->remap_leaf_indices(new_indices);
+        jobs.emplace_back(move(merge_tree), move(sub_fts));
+    }
+
+    // Start with the largest jobs.
+    vector<int> job_order(jobs.size());
+    for (size_t job_no = 0; job_no < jobs.size(); ++job_no) {
+        job_order[job_no] = job_no;
+    }
+    stable_sort(job_order.begin(), job_order.end(),
+                [&jobs](int job1, int job2) {
+                    return jobs[job1].num_merges > jobs[job2].num_merges;
+                });
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        utils::g_log << "Merging " << jobs.size() << " independent merge trees "
+                     << "with up to " << num_threads << " threads" << endl;
+    }
+
+    /*
+      The jobs only share the (constant) labels. Since utils::g_log is not
+      thread-safe, the jobs do not produce any output.
+    */
+    utils::process_jobs_in_parallel(
+        jobs.size(), num_threads,
+        [&](int, int pos) {
+            IndependentMergeJob &job = jobs[job_order[pos]];
+            FactoredTransitionSystem &sub_fts = job.fts;
+            for (int i = 0; i < job.num_merges; ++i) {
+                if (timer.is_expired()) {
+                    job.out_of_time = true;
+                    break;
+                }
+                pair<int, int> merge_indices =
+                    job.merge_tree->get_next_merge(sub_fts.get_size());
+                shrink_before_merge_step(
+                    sub_fts,
+                    merge_indices.first,
+                    merge_indices.second,
+                    max_states,
+                    max_states_before_merge,
+                    shrink_threshold_before_merge,
+                    *shrink_strategy,
+                    utils::Verbosity::SILENT);
+                int merged_index = sub_fts.merge(
+                    merge_indices.first, merge_indices.second,
+                    utils::Verbosity::SILENT);
+                job.maximum_intermediate_size = max(
+                    job.maximum_intermediate_size,
+                    sub_fts.get_transition_system(merged_index).get_size());
+                if (prune_unreachable_states || prune_irrelevant_states) {
+                    prune_step(
+                        sub_fts,
+                        merged_index,
+                        prune_unreachable_states,
+                        prune_irrelevant_states,
+                        utils::Verbosity::SILENT);
+                }
+                if (!sub_fts.is_factor_solvable(merged_index)) {
+                    job.unsolvable = true;
+                    break;
+                }
+            }
+        });
+
+    // Move the remaining factors back and report the results.
+    bool unsolvable = false;
+    bool out_of_time = false;
+    for (size_t job_no = 0; job_no < jobs.size(); ++job_no) {
+        IndependentMergeJob &job = jobs[job_no];
+        unsolvable = unsolvable || job.unsolvable;
+        out_of_time = out_of_time || job.out_of_time;
+        maximum_intermediate_size = max(
+            maximum_intermediate_size, job.maximum_intermediate_size);
+        int result_index = -1;
+        for (int index = 0; index < job.fts.get_size(); ++index) {
+            if (job.fts.is_active(index)) {
+                result_index = job.fts.move_factor(index, fts);
+            }
+        }
+        if (!job.unsolvable && !job.out_of_time) {
+            assert(job.merge_tree->done());
+            merge_strategy.set_independent_merge_result(job_no, result_index);
+        }
+    }
+    if (unsolvable) {
+        if (verbosity >= utils::Verbosity::NORMAL) {
+            utils::g_log << "Abstract problem is unsolvable, stopping "
+                "computation. " << endl << endl;
+        }
+        return false;
+    }
+    if (out_of_time) {
+        ran_out_of_time(timer);
+        return false;
+    }
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        utils::g_log << "M&S algorithm main loop timer: "
+                     << timer.get_elapsed_time()
+                     << " (after merging independent merge trees)" << endl;
+        utils::g_log << endl;
+    }
+    return true;
+}
+
 void MergeAndShrinkAlgorithm::main_loop(
     FactoredTransitionSystem &fts,
     const TaskProxy &task_proxy) {
@@ -177,19 +402,41 @@ void MergeAndShrinkAlgorithm::main_loop(
     if (label_reduction) {
         label_reduction->initialize(task_proxy);
     }
+    // Time spent on computing the merge strategy and selecting merges.
+    utils::Timer merge_selection_timer;
     unique_ptr<MergeStrategy> merge_strategy =
         merge_strategy_factory->compute_merge_strategy(task_proxy, fts);
     merge_strategy_factory = nullptr;
+    merge_selection_timer.stop();
 
     auto log_main_loop_progress = [&timer](const string &msg) {
             utils::g_log << "M&S algorithm main loop timer: "
                          << timer.get_elapsed_time()
                          << " (" << msg << ")" << endl;
         };
+    auto get_num_transitions = [&fts](int index) {
+            return fts.get_transition_system(index).compute_total_transitions();
+        };
+    auto get_distances_time = [&fts](int index) {
+            return fts.get_distances(index).get_computation_time();
+        };
+    PhaseStatistics phase_statistics(trace_file, main_loop_max_memory != INF);
+
+    bool use_threads = num_threads > 1 && can_merge_in_parallel();
+    bool continue_merging = true;
+    if (use_threads) {
+        phase_statistics.start_phase();
+        continue_merging = merge_independent_trees_in_parallel(
+            fts, *merge_strategy, timer, maximum_intermediate_size);
+        phase_statistics.end_phase(Phase::INDEPENDENT_MERGING, 0, 0);
+    }
+
     int iteration_counter = 0;
-    while (fts.get_num_active_entries() > 1) {
+    while (continue_merging && fts.get_num_active_entries() > 1) {
         // Choose next transition systems to merge
+        merge_selection_timer.resume();
         pair<int, int> merge_indices = merge_strategy->get_next();
+        merge_selection_timer.stop();
         if (ran_out_of_time(timer)) {
             break;
         }
@@ -208,7 +455,12 @@ void MergeAndShrinkAlgorithm::main_loop(
 
         // Label reduction (before shrinking)
         if (label_reduction && label_reduction->reduce_before_shrinking()) {
+            phase_statistics.start_phase();
             bool reduced = label_reduction->reduce(merge_indices, fts, verbosity);
+            phase_statistics.end_phase(
+                Phase::LABEL_REDUCTION, iteration_counter,
+                max(get_num_transitions(merge_index1),
+                    get_num_transitions(merge_index2)));
             if (verbosity >= utils::Verbosity::NORMAL && reduced) {
                 log_main_loop_progress("after label reduction");
             }
@@ -219,6 +471,9 @@ void MergeAndShrinkAlgorithm::main_loop(
         }
 
         // Shrinking
+        double distances_time_before_shrinking =
+            get_distances_time(merge_index1) + get_distances_time(merge_index2);
+        phase_statistics.start_phase();
         bool shrunk = shrink_before_merge_step(
             fts,
             merge_index1,
@@ -228,6 +483,12 @@ void MergeAndShrinkAlgorithm::main_loop(
             shrink_threshold_before_merge,
             *shrink_strategy,
             verbosity);
+        phase_statistics.end_phase(
+            Phase::SHRINKING, iteration_counter,
+            max(get_num_transitions(merge_index1),
+                get_num_transitions(merge_index2)),
+            get_distances_time(merge_index1) + get_distances_time(merge_index2) -
+            distances_time_before_shrinking);
         if (verbosity >= utils::Verbosity::NORMAL && shrunk) {
             log_main_loop_progress("after shrinking");
         }
@@ -238,7 +499,12 @@ void MergeAndShrinkAlgorithm::main_loop(
 
         // Label reduction (before merging)
         if (label_reduction && label_reduction->reduce_before_merging()) {
+            phase_statistics.start_phase();
             bool reduced = label_reduction->reduce(merge_indices, fts, verbosity);
+            phase_statistics.end_phase(
+                Phase::LABEL_REDUCTION, iteration_counter,
+                max(get_num_transitions(merge_index1),
+                    get_num_transitions(merge_index2)));
             if (verbosity >= utils::Verbosity::NORMAL && reduced) {
                 log_main_loop_progress("after label reduction");
             }
@@ -248,8 +514,16 @@ void MergeAndShrinkAlgorithm::main_loop(
             break;
         }
 
+        if (would_exceed_memory_budget(fts, merge_index1, merge_index2)) {
+            break;
+        }
+
         // Merging
+        phase_statistics.start_phase();
         int merged_index = fts.merge(merge_index1, merge_index2, verbosity);
+        phase_statistics.end_phase(
+            Phase::MERGING, iteration_counter, get_num_transitions(merged_index),
+            get_distances_time(merged_index));
         int abs_size = fts.get_transition_system(merged_index).get_size();
         if (abs_size > maximum_intermediate_size) {
             maximum_intermediate_size = abs_size;
@@ -268,12 +542,20 @@ void MergeAndShrinkAlgorithm::main_loop(
 
         // Pruning
         if (prune_unreachable_states || prune_irrelevant_states) {
+            double distances_time_before_pruning =
+                get_distances_time(merged_index);
+            phase_statistics.start_phase();
             bool pruned = prune_step(
                 fts,
                 merged_index,
                 prune_unreachable_states,
                 prune_irrelevant_states,
                 verbosity);
+            phase_statistics.end_phase(
+                Phase::PRUNING, iteration_counter,
+                get_num_transitions(merged_index),
+                get_distances_time(merged_index) -
+                distances_time_before_pruning);
             if (verbosity >= utils::Verbosity::NORMAL && pruned) {
                 if (verbosity >= utils::Verbosity::VERBOSE) {
                     fts.statistics(merged_index);
@@ -313,6 +595,10 @@ void MergeAndShrinkAlgorithm::main_loop(
 
     utils::g_log << "End of merge-and-shrink algorithm, statistics:" << endl;
     utils::g_log << "Main loop runtime: " << timer.get_elapsed_time() << endl;
+    utils::g_log << "Merge selection time: " << merge_selection_timer << endl;
+    if (verbosity >= utils::Verbosity::NORMAL) {
+        phase_statistics.dump();
+    }
     utils::g_log << "Maximum intermediate abstraction size: "
                  << maximum_intermediate_size << endl;
     shrink_strategy = nullptr;
@@ -451,6 +737,42 @@ void add_merge_and_shrink_algorithm_options_to_parser(OptionParser &parser) {
         "transformation is runtime-intense.",
         "infinity",
         Bounds("0.0", "infinity"));
+
+    parser.add_option<int>(
+        "main_loop_max_memory",
+        "A limit in MiB on the peak memory of the planner during the main "
+        "loop of the algorithm. Before each merge, the memory required for "
+        "the product is estimated. If the limit would be exceeded, the "
+        "algorithm terminates, returning a factored transition system with "
+        "all factors computed so far. Note that the limit refers to the "
+        "peak memory reported by the operating system (the peak address "
+        "space on Linux) and that it is only checked before merging.",
+        "infinity",
+        Bounds("0", "infinity"));
+
+    parser.add_option<string>(
+        "trace_file",
+        "If given, write a trace of the main loop to this file in CSV "
+        "format. It contains one line per phase (label reduction, "
+        "shrinking, merging, distances, pruning) of each iteration with "
+        "the time spent in the phase, the maximum number of transitions "
+        "of the affected factors after it, the resident set size and its "
+        "change during the phase, and the peak memory.",
+        options::OptionParser::NONE);
+
+    parser.add_option<int>(
+        "num_threads",
+        "Number of threads for merging independent parts of the merge "
+        "strategy in parallel. This requires a merge strategy that knows "
+        "such parts in advance, i.e., a precomputed merge tree or the SCC "
+        "merge strategy with a merge tree, and shrinking based on "
+        "bisimulation, no label reduction and no memory budget, so that "
+        "the result is the same as with a single thread. "
+        "Note that time limits refer to the CPU time summed over all "
+        "threads and that each thread reserves additional address space, "
+        "which counts towards address-space based memory limits.",
+        "1",
+        Bounds("1", "infinity"));
 }
 
 void add_transition_system_size_limit_options_to_parser(OptionParser &parser) {
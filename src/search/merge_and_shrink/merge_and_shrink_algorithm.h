@@ -2,6 +2,7 @@
 #define MERGE_AND_SHRINK_MERGE_AND_SHRINK_ALGORITHM_H
 
 #include <memory>
+#include <string>
 
 class TaskProxy;
 
@@ -18,6 +19,7 @@ enum class Verbosity;
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
 class LabelReduction;
+class MergeStrategy;
 class MergeStrategyFactory;
 class ShrinkStrategy;
 
@@ -43,6 +45,11 @@ class MergeAndShrinkAlgorithm {
 
     const utils::Verbosity verbosity;
     const double main_loop_max_time;
+    // Memory budget for the main loop in MiB.
+    const int main_loop_max_memory;
+    const int num_threads;
+    // Empty if no trace should be written.
+    const std::string trace_file;
 
     long starting_peak_memory;
 
@@ -50,7 +57,15 @@ class MergeAndShrinkAlgorithm {
     void dump_options() const;
     void warn_on_unusual_options() const;
     bool ran_out_of_time(const utils::CountdownTimer &timer) const;
+    bool would_exceed_memory_budget(
+        const FactoredTransitionSystem &fts, int index1, int index2) const;
+    bool can_merge_in_parallel() const;
     void statistics(int maximum_intermediate_size) const;
+    bool merge_independent_trees_in_parallel(
+        FactoredTransitionSystem &fts,
+        MergeStrategy &merge_strategy,
+        const utils::CountdownTimer &timer,
+        int &maximum_intermediate_size) const;
     void main_loop(
         FactoredTransitionSystem &fts,
         const TaskProxy &task_proxy);
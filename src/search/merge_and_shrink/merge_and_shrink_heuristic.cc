@@ -2,6 +2,7 @@
 
 #include "distances.h"
 #include "factored_transition_system.h"
+#include "flat_merge_and_shrink_representation.h"
 #include "merge_and_shrink_algorithm.h"
 #include "merge_and_shrink_representation.h"
 #include "transition_system.h"
@@ -12,8 +13,11 @@
 
 #include "../task_utils/task_properties.h"
 
+#include "../utils/cache_file.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/memory.h"
+#include "../utils/memory_mapped_file.h"
 #include "../utils/system.h"
 
 #include <cassert>
@@ -24,16 +28,36 @@ using namespace std;
 using utils::ExitCode;
 
 namespace merge_and_shrink {
+/*
+  The payload of a cache file is a sequence of ints in native byte order:
+  the number of representations, followed by the size and the data of each
+  representation (see FlatMergeAndShrinkRepresentation).
+*/
+static const int CACHE_FILE_MAGIC = 0x4d41534d;
+static const int CACHE_FILE_VERSION = 2;
+
 MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const options::Options &opts)
     : Heuristic(opts),
-      verbosity(opts.get<utils::Verbosity>("verbosity")) {
+      verbosity(opts.get<utils::Verbosity>("verbosity")),
+      cache_file(utils::parse_cache_file_from_options(
+                     opts, "merge-and-shrink",
+                     task_properties::compute_task_fingerprint(task_proxy),
+                     CACHE_FILE_MAGIC, CACHE_FILE_VERSION)) {
     utils::g_log << "Initializing merge-and-shrink heuristic..." << endl;
-    MergeAndShrinkAlgorithm algorithm(opts);
-    FactoredTransitionSystem fts = algorithm.build_factored_transition_system(task_proxy);
-    extract_factors(fts);
+    if (!cache_file || !read_cache_file()) {
+        MergeAndShrinkAlgorithm algorithm(opts);
+        FactoredTransitionSystem fts = algorithm.build_factored_transition_system(task_proxy);
+        extract_factors(fts);
+        if (cache_file) {
+            write_cache_file();
+        }
+    }
     utils::g_log << "Done initializing merge-and-shrink heuristic." << endl << endl;
 }
 
+MergeAndShrinkHeuristic::~MergeAndShrinkHeuristic() {
+}
+
 void MergeAndShrinkHeuristic::extract_factor(
     FactoredTransitionSystem &fts, int index) {
     /*
@@ -51,7 +75,9 @@ void MergeAndShrinkHeuristic::extract_factor(
     }
     assert(distances->are_goal_distances_computed());
     mas_representation->set_distances(*distances);
-    mas_representations.push_back(move(mas_representation));
+    mas_representations.push_back(
+        utils::make_unique_ptr<FlatMergeAndShrinkRepresentation>(
+            *mas_representation));
 }
 
 bool MergeAndShrinkHeuristic::extract_unsolvable_factor(FactoredTransitionSystem &fts) {
@@ -113,11 +139,76 @@ void MergeAndShrinkHeuristic::extract_factors(FactoredTransitionSystem &fts) {
     }
 }
 
+bool MergeAndShrinkHeuristic::read_cache_file() {
+    assert(mas_representations.empty());
+    vector<int> domain_sizes;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        domain_sizes.push_back(var.get_domain_size());
+    }
+    auto read_representations = [&](const char *payload, size_t num_bytes) {
+            if (num_bytes % sizeof(int) != 0) {
+                return false;
+            }
+            const int *data = reinterpret_cast<const int *>(payload);
+            size_t size = num_bytes / sizeof(int);
+            if (size == 0 || data[0] < 0) {
+                return false;
+            }
+            int num_representations = data[0];
+            size_t pos = 1;
+            for (int i = 0; i < num_representations; ++i) {
+                if (pos == size) {
+                    return false;
+                }
+                size_t representation_size = data[pos++];
+                if (representation_size > size - pos ||
+                    !FlatMergeAndShrinkRepresentation::is_well_formed(
+                        data + pos, representation_size, domain_sizes)) {
+                    return false;
+                }
+                mas_representations.push_back(
+                    utils::make_unique_ptr<FlatMergeAndShrinkRepresentation>(
+                        data + pos, representation_size));
+                pos += representation_size;
+            }
+            return pos == size;
+        };
+    cache = cache_file->read(read_representations);
+    if (!cache) {
+        mas_representations.clear();
+        return false;
+    }
+    utils::g_log << "Read " << mas_representations.size()
+                 << " merge-and-shrink representations from cache file "
+                 << cache_file->get_filename() << "." << endl;
+    return true;
+}
+
+void MergeAndShrinkHeuristic::write_cache_file() const {
+    auto write_representations = [&](ostream &file) {
+            int num_representations = mas_representations.size();
+            file.write(reinterpret_cast<const char *>(&num_representations),
+                       sizeof(int));
+            for (const unique_ptr<FlatMergeAndShrinkRepresentation> &mas_representation : mas_representations) {
+                int size = mas_representation->get_size();
+                file.write(reinterpret_cast<const char *>(&size), sizeof(int));
+                file.write(reinterpret_cast<const char *>(mas_representation->get_data()),
+                           size * sizeof(int));
+            }
+        };
+    if (cache_file->write(write_representations)) {
+        utils::g_log << "Wrote merge-and-shrink representations to cache file "
+                     << cache_file->get_filename() << "." << endl;
+    }
+}
+
 int MergeAndShrinkHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
     int heuristic = 0;
-    for (const unique_ptr<MergeAndShrinkRepresentation> &mas_representation : mas_representations) {
-        int cost = mas_representation->get_value(state);
+    for (const unique_ptr<FlatMergeAndShrinkRepresentation> &mas_representation : mas_representations) {
+        int cost = mas_representation->get_value(values);
         if (cost == PRUNED_STATE || cost == INF) {
             // If state is unreachable or irrelevant, we encountered a dead end.
             return DEAD_END;
@@ -220,8 +311,19 @@ static shared_ptr<Heuristic> _parse(options::OptionParser &parser) {
         "total_order])),label_reduction=exact(before_shrinking=true,"
         "before_merging=false),max_states=50k,threshold_before_merge=1)\n}}}\n");
 
+    parser.document_note(
+        "Note",
+        "With the option cache_dir, the heuristic is read from a cache file "
+        "in the given directory if it was computed before for the same "
+        "(possibly cost-transformed) task and the same options, which is "
+        "checked with a fingerprint of the task and a hash of the options. "
+        "Otherwise, it is computed and written to a new cache file. "
+        "On Unix systems, the file is mapped into memory, so concurrent "
+        "planner runs share a single copy of the heuristic.");
+
     Heuristic::add_options_to_parser(parser);
     add_merge_and_shrink_algorithm_options_to_parser(parser);
+    utils::add_cache_dir_option_to_parser(parser);
     options::Options opts = parser.parse();
     if (parser.help_mode()) {
         return nullptr;
@@ -6,27 +6,36 @@
 #include <memory>
 
 namespace utils {
+class CacheFile;
+class MemoryMappedFile;
 enum class Verbosity;
 }
 
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
-class MergeAndShrinkRepresentation;
+class FlatMergeAndShrinkRepresentation;
 
 class MergeAndShrinkHeuristic : public Heuristic {
     const utils::Verbosity verbosity;
+    // nullptr if no cache file is used.
+    const std::unique_ptr<utils::CacheFile> cache_file;
 
     // The final merge-and-shrink representations, storing goal distances.
-    std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> mas_representations;
+    std::vector<std::unique_ptr<FlatMergeAndShrinkRepresentation>> mas_representations;
+    // Holds the data of the representations if they are read from the cache.
+    std::unique_ptr<utils::MemoryMappedFile> cache;
 
     void extract_factor(FactoredTransitionSystem &fts, int index);
     bool extract_unsolvable_factor(FactoredTransitionSystem &fts);
     void extract_nontrivial_factors(FactoredTransitionSystem &fts);
     void extract_factors(FactoredTransitionSystem &fts);
+    bool read_cache_file();
+    void write_cache_file() const;
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit MergeAndShrinkHeuristic(const options::Options &opts);
+    virtual ~MergeAndShrinkHeuristic() override;
 };
 }
 
@@ -71,6 +71,15 @@ bool MergeAndShrinkRepresentationLeaf::is_total() const {
     return true;
 }
 
+void MergeAndShrinkRepresentationLeaf::append_to_flat_representation(
+    vector<int> &nodes, vector<int> &tables) const {
+    nodes.push_back(var_id);
+    nodes.push_back(tables.size());
+    nodes.push_back(lookup_table.size());
+    nodes.push_back(1);
+    tables.insert(tables.end(), lookup_table.begin(), lookup_table.end());
+}
+
 void MergeAndShrinkRepresentationLeaf::dump() const {
     utils::g_log << "lookup table (leaf): ";
     for (const auto &value : lookup_table) {
@@ -144,6 +153,21 @@ bool MergeAndShrinkRepresentationMerge::is_total() const {
     return left_child->is_total() && right_child->is_total();
 }
 
+void MergeAndShrinkRepresentationMerge::append_to_flat_representation(
+    vector<int> &nodes, vector<int> &tables) const {
+    left_child->append_to_flat_representation(nodes, tables);
+    right_child->append_to_flat_representation(nodes, tables);
+    int num_cols = lookup_table.empty() ? 0 : lookup_table[0].size();
+    nodes.push_back(-1);
+    nodes.push_back(tables.size());
+    nodes.push_back(lookup_table.size());
+    nodes.push_back(num_cols);
+    for (const vector<int> &row : lookup_table) {
+        assert(static_cast<int>(row.size()) == num_cols);
+        tables.insert(tables.end(), row.begin(), row.end());
+    }
+}
+
 void MergeAndShrinkRepresentationMerge::dump() const {
     utils::g_log << "lookup table (merge): " << endl;
     for (const auto &row : lookup_table) {
@@ -32,6 +32,13 @@ public:
     /* Return true iff the represented function is total, i.e., does not map
        to PRUNED_STATE. */
     virtual bool is_total() const = 0;
+    /*
+      Append the node records and lookup tables of this representation in
+      the format of FlatMergeAndShrinkRepresentation. Table positions are
+      relative to the start of the tables.
+    */
+    virtual void append_to_flat_representation(
+        std::vector<int> &nodes, std::vector<int> &tables) const = 0;
     virtual void dump() const = 0;
 };
 
@@ -49,6 +56,8 @@ public:
         const std::vector<int> &abstraction_mapping) override;
     virtual int get_value(const State &state) const override;
     virtual bool is_total() const override;
+    virtual void append_to_flat_representation(
+        std::vector<int> &nodes, std::vector<int> &tables) const override;
     virtual void dump() const override;
 };
 
@@ -68,6 +77,8 @@ public:
         const std::vector<int> &abstraction_mapping) override;
     virtual int get_value(const State &state) const override;
     virtual bool is_total() const override;
+    virtual void append_to_flat_representation(
+        std::vector<int> &nodes, std::vector<int> &tables) const override;
     virtual void dump() const override;
 };
 }
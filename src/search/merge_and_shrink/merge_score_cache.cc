@@ -0,0 +1,71 @@
+#include "merge_score_cache.h"
+
+#include "factored_transition_system.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace merge_and_shrink {
+bool MergeScoreCache::is_valid(
+    const FactoredTransitionSystem &fts,
+    const pair<int, int> &merge_candidate,
+    const Entry &entry) const {
+    int index1 = merge_candidate.first;
+    int index2 = merge_candidate.second;
+    return fts.is_active(index1) && fts.is_active(index2) &&
+           fts.get_version(index1) == entry.version1 &&
+           fts.get_version(index2) == entry.version2;
+}
+
+void MergeScoreCache::remove_invalid_entries(
+    const FactoredTransitionSystem &fts) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (is_valid(fts, it->first, it->second)) {
+            ++it;
+        } else {
+            it = entries.erase(it);
+        }
+    }
+}
+
+vector<int> MergeScoreCache::lookup_scores(
+    const FactoredTransitionSystem &fts,
+    const vector<pair<int, int>> &merge_candidates,
+    vector<double> &scores) {
+    /*
+      Entries of merged or transformed factors are never valid again. Remove
+      them once they make up at least half of the cache, so that the cost of
+      cleaning up is amortized over the lookups.
+    */
+    if (entries.size() > 2 * merge_candidates.size()) {
+        remove_invalid_entries(fts);
+    }
+
+    scores.resize(merge_candidates.size());
+    vector<int> uncached_positions;
+    for (size_t i = 0; i < merge_candidates.size(); ++i) {
+        auto it = entries.find(merge_candidates[i]);
+        if (it != entries.end() &&
+            is_valid(fts, merge_candidates[i], it->second)) {
+            scores[i] = it->second.score;
+        } else {
+            uncached_positions.push_back(i);
+        }
+    }
+    return uncached_positions;
+}
+
+void MergeScoreCache::store_score(
+    const FactoredTransitionSystem &fts,
+    const pair<int, int> &merge_candidate,
+    double score) {
+    int index1 = merge_candidate.first;
+    int index2 = merge_candidate.second;
+    assert(fts.is_active(index1) && fts.is_active(index2));
+    Entry &entry = entries[merge_candidate];
+    entry.version1 = fts.get_version(index1);
+    entry.version2 = fts.get_version(index2);
+    entry.score = score;
+}
+}
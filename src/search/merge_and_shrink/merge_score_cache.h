@@ -0,0 +1,51 @@
+#ifndef MERGE_AND_SHRINK_MERGE_SCORE_CACHE_H
+#define MERGE_AND_SHRINK_MERGE_SCORE_CACHE_H
+
+#include "../utils/hash.h"
+
+#include <utility>
+#include <vector>
+
+namespace merge_and_shrink {
+class FactoredTransitionSystem;
+
+/*
+  Cache for the scores of merge candidates of scoring functions whose score
+  for a candidate only depends on the two factors of the candidate. Most
+  factors are not touched in a merge-and-shrink iteration, so most scores
+  can be reused in the next iteration. A cached score is valid as long as
+  both factors keep the version with which it was computed.
+*/
+class MergeScoreCache {
+    struct Entry {
+        int version1;
+        int version2;
+        double score;
+    };
+
+    utils::HashMap<std::pair<int, int>, Entry> entries;
+
+    bool is_valid(
+        const FactoredTransitionSystem &fts,
+        const std::pair<int, int> &merge_candidate,
+        const Entry &entry) const;
+    void remove_invalid_entries(const FactoredTransitionSystem &fts);
+public:
+    /*
+      Set the scores of all merge candidates with a valid cached score and
+      return the positions of the remaining merge candidates. The scores of
+      these must be computed and stored with store_score.
+    */
+    std::vector<int> lookup_scores(
+        const FactoredTransitionSystem &fts,
+        const std::vector<std::pair<int, int>> &merge_candidates,
+        std::vector<double> &scores);
+
+    void store_score(
+        const FactoredTransitionSystem &fts,
+        const std::pair<int, int> &merge_candidate,
+        double score);
+};
+}
+
+#endif
@@ -27,7 +27,7 @@ vector<int> MergeScoringFunctionDFP::compute_label_ranks(
 
     for (GroupAndTransitions gat : ts) {
         const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
+        TransitionRange transitions = gat.transitions;
         // Relevant labels with no transitions have a rank of infinity.
         int label_rank = INF;
         bool group_relevant = false;
@@ -68,10 +68,12 @@ vector<double> MergeScoringFunctionDFP::compute_scores(
 
     vector<vector<int>> transition_system_label_ranks(num_ts);
     vector<double> scores;
-    scores.reserve(merge_candidates.size());
+    vector<int> uncached_positions =
+        score_cache.lookup_scores(fts, merge_candidates, scores);
 
     // Go over all pairs of transition systems and compute their weight.
-    for (pair<int, int> merge_candidate : merge_candidates) {
+    for (int pos : uncached_positions) {
+        pair<int, int> merge_candidate = merge_candidates[pos];
         int ts_index1 = merge_candidate.first;
         int ts_index2 = merge_candidate.second;
 
@@ -94,7 +96,8 @@ vector<double> MergeScoringFunctionDFP::compute_scores(
                 pair_weight = min(pair_weight, max_label_rank);
             }
         }
-        scores.push_back(pair_weight);
+        scores[pos] = pair_weight;
+        score_cache.store_score(fts, merge_candidate, pair_weight);
     }
     return scores;
 }
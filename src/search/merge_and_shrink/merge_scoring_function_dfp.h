@@ -1,11 +1,15 @@
 #ifndef MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_DFP_H
 #define MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_DFP_H
 
+#include "merge_score_cache.h"
 #include "merge_scoring_function.h"
 
 namespace merge_and_shrink {
 class TransitionSystem;
 class MergeScoringFunctionDFP : public MergeScoringFunction {
+    // The score of a candidate only depends on its two factors.
+    MergeScoreCache score_cache;
+
     std::vector<int> compute_label_ranks(
         const FactoredTransitionSystem &fts, int index) const;
 protected:
@@ -13,25 +13,32 @@ namespace merge_and_shrink {
 vector<double> MergeScoringFunctionGoalRelevance::compute_scores(
     const FactoredTransitionSystem &fts,
     const vector<pair<int, int>> &merge_candidates) {
-    int num_ts = fts.get_size();
-    vector<bool> goal_relevant(num_ts, false);
-    for (int ts_index : fts) {
-        const TransitionSystem &ts = fts.get_transition_system(ts_index);
-        if (is_goal_relevant(ts)) {
-            goal_relevant[ts_index] = true;
-        }
-    }
-
     vector<double> scores;
-    scores.reserve(merge_candidates.size());
-    for (pair<int, int> merge_candidate : merge_candidates) {
+    vector<int> uncached_positions =
+        score_cache.lookup_scores(fts, merge_candidates, scores);
+
+    // Only compute goal relevance for factors of uncached candidates.
+    enum class Relevance {UNKNOWN, RELEVANT, IRRELEVANT};
+    vector<Relevance> goal_relevance(fts.get_size(), Relevance::UNKNOWN);
+    auto is_relevant = [&](int ts_index) {
+            if (goal_relevance[ts_index] == Relevance::UNKNOWN) {
+                const TransitionSystem &ts = fts.get_transition_system(ts_index);
+                goal_relevance[ts_index] = is_goal_relevant(ts) ?
+                    Relevance::RELEVANT : Relevance::IRRELEVANT;
+            }
+            return goal_relevance[ts_index] == Relevance::RELEVANT;
+        };
+
+    for (int pos : uncached_positions) {
+        pair<int, int> merge_candidate = merge_candidates[pos];
         int ts_index1 = merge_candidate.first;
         int ts_index2 = merge_candidate.second;
         int score = INF;
-        if (goal_relevant[ts_index1] || goal_relevant[ts_index2]) {
+        if (is_relevant(ts_index1) || is_relevant(ts_index2)) {
             score = 0;
         }
-        scores.push_back(score);
+        scores[pos] = score;
+        score_cache.store_score(fts, merge_candidate, score);
     }
     return scores;
 }
@@ -1,10 +1,14 @@
 #ifndef MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_GOAL_RELEVANCE_H
 #define MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_GOAL_RELEVANCE_H
 
+#include "merge_score_cache.h"
 #include "merge_scoring_function.h"
 
 namespace merge_and_shrink {
 class MergeScoringFunctionGoalRelevance : public MergeScoringFunction {
+    // The score of a candidate only depends on its two factors.
+    MergeScoreCache score_cache;
+
 protected:
     virtual std::string name() const override;
 public:
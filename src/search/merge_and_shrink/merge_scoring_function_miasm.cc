@@ -13,6 +13,9 @@
 
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
+
+#include <algorithm>
 
 using namespace std;
 
@@ -22,49 +25,79 @@ MergeScoringFunctionMIASM::MergeScoringFunctionMIASM(
     : shrink_strategy(options.get<shared_ptr<ShrinkStrategy>>("shrink_strategy")),
       max_states(options.get<int>("max_states")),
       max_states_before_merge(options.get<int>("max_states_before_merge")),
-      shrink_threshold_before_merge(options.get<int>("threshold_before_merge")) {
+      shrink_threshold_before_merge(options.get<int>("threshold_before_merge")),
+      num_threads(options.get<int>("num_threads")) {
+}
+
+double MergeScoringFunctionMIASM::compute_score(
+    const FactoredTransitionSystem &fts,
+    const pair<int, int> &merge_candidate) const {
+    int index1 = merge_candidate.first;
+    int index2 = merge_candidate.second;
+    unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
+        fts,
+        index1,
+        index2,
+        *shrink_strategy,
+        max_states,
+        max_states_before_merge,
+        shrink_threshold_before_merge);
+
+    // Compute distances for the product and count the alive states.
+    unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
+    const bool compute_init_distances = true;
+    const bool compute_goal_distances = true;
+    const utils::Verbosity verbosity = utils::Verbosity::SILENT;
+    distances->compute_distances(compute_init_distances, compute_goal_distances, verbosity);
+    int num_states = product->get_size();
+    int alive_states_count = 0;
+    for (int state = 0; state < num_states; ++state) {
+        if (distances->get_init_distance(state) != INF &&
+            distances->get_goal_distance(state) != INF) {
+            ++alive_states_count;
+        }
+    }
+
+    /*
+      Compute the score as the ratio of alive states of the product
+      compared to the number of states of the full product.
+    */
+    assert(num_states);
+    return static_cast<double>(alive_states_count) /
+           static_cast<double>(num_states);
+}
+
+bool MergeScoringFunctionMIASM::use_threads() const {
+    /*
+      Computing products concurrently requires a shrink strategy that is
+      deterministic and has no shared state. This is only the case for
+      bisimulation (see MergeAndShrinkAlgorithm).
+    */
+    return num_threads > 1 && shrink_strategy->get_name() == "bisimulation";
 }
 
 vector<double> MergeScoringFunctionMIASM::compute_scores(
     const FactoredTransitionSystem &fts,
     const vector<pair<int, int>> &merge_candidates) {
     vector<double> scores;
-    scores.reserve(merge_candidates.size());
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int index1 = merge_candidate.first;
-        int index2 = merge_candidate.second;
-        unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
-            fts,
-            index1,
-            index2,
-            *shrink_strategy,
-            max_states,
-            max_states_before_merge,
-            shrink_threshold_before_merge);
-
-        // Compute distances for the product and count the alive states.
-        unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
-        const bool compute_init_distances = true;
-        const bool compute_goal_distances = true;
-        const utils::Verbosity verbosity = utils::Verbosity::SILENT;
-        distances->compute_distances(compute_init_distances, compute_goal_distances, verbosity);
-        int num_states = product->get_size();
-        int alive_states_count = 0;
-        for (int state = 0; state < num_states; ++state) {
-            if (distances->get_init_distance(state) != INF &&
-                distances->get_goal_distance(state) != INF) {
-                ++alive_states_count;
-            }
-        }
+    vector<int> uncached_positions =
+        score_cache.lookup_scores(fts, merge_candidates, scores);
+    int num_uncached = uncached_positions.size();
+
+    /*
+      The products are computed on copies of the factors and only read the
+      (constant) factored transition system. Since utils::g_log is not
+      thread-safe, computing the products does not produce any output.
+    */
+    utils::process_jobs_in_parallel(
+        num_uncached, use_threads() ? num_threads : 1,
+        [&](int, int i) {
+            int pos = uncached_positions[i];
+            scores[pos] = compute_score(fts, merge_candidates[pos]);
+        });
 
-        /*
-          Compute the score as the ratio of alive states of the product
-          compared to the number of states of the full product.
-        */
-        assert(num_states);
-        double score = static_cast<double>(alive_states_count) /
-            static_cast<double>(num_states);
-        scores.push_back(score);
+    for (int pos : uncached_positions) {
+        score_cache.store_score(fts, merge_candidates[pos], scores[pos]);
     }
     return scores;
 }
@@ -73,6 +106,14 @@ string MergeScoringFunctionMIASM::name() const {
     return "miasm";
 }
 
+void MergeScoringFunctionMIASM::dump_function_specific_options() const {
+    utils::g_log << "Number of threads: " << num_threads << endl;
+    if (num_threads > 1 && !use_threads()) {
+        utils::g_log << "Using several threads is only supported with "
+            "shrinking based on bisimulation. Ignoring num_threads." << endl;
+    }
+}
+
 static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
     parser.document_synopsis(
         "MIASM",
@@ -126,6 +167,12 @@ static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
         "We recommend setting this to match the shrink strategy configuration "
         "given to {{{merge_and_shrink}}}, see note below.");
     add_transition_system_size_limit_options_to_parser(parser);
+    parser.add_option<int>(
+        "num_threads",
+        "Number of threads used to compute the products of the merge "
+        "candidates. Only supported with shrinking based on bisimulation.",
+        "1",
+        options::Bounds("1", "infinity"));
 
     options::Options options = parser.parse();
     if (parser.help_mode()) {
@@ -1,6 +1,7 @@
 #ifndef MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_MIASM_H
 #define MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_MIASM_H
 
+#include "merge_score_cache.h"
 #include "merge_scoring_function.h"
 
 #include <memory>
@@ -16,8 +17,17 @@ class MergeScoringFunctionMIASM : public MergeScoringFunction {
     const int max_states;
     const int max_states_before_merge;
     const int shrink_threshold_before_merge;
+    const int num_threads;
+    // The score of a candidate only depends on its two factors.
+    MergeScoreCache score_cache;
+
+    double compute_score(
+        const FactoredTransitionSystem &fts,
+        const std::pair<int, int> &merge_candidate) const;
+    bool use_threads() const;
 protected:
     virtual std::string name() const override;
+    virtual void dump_function_specific_options() const override;
 public:
     explicit MergeScoringFunctionMIASM(const options::Options &options);
     virtual ~MergeScoringFunctionMIASM() override = default;
@@ -14,6 +14,7 @@
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -32,29 +33,24 @@ vector<double> MergeScoringFunctionTotalOrder::compute_scores(
     const FactoredTransitionSystem &,
     const vector<pair<int, int>> &merge_candidates) {
     assert(initialized);
+    /*
+      The merge candidate order consists of all pairs (order[i], order[j])
+      with i < j of the transition system order, sorted lexicographically
+      by (i, j). We use the index of a candidate in this order as its score,
+      which we compute directly from the positions of its transition
+      systems instead of searching the order.
+    */
+    size_t num_ts = transition_system_positions.size();
     vector<double> scores;
     scores.reserve(merge_candidates.size());
-    for (size_t candidate_index = 0; candidate_index < merge_candidates.size();
-         ++candidate_index) {
-        pair<int, int> merge_candidate = merge_candidates[candidate_index];
-        int ts_index1 = merge_candidate.first;
-        int ts_index2 = merge_candidate.second;
-        for (size_t merge_candidate_order_index = 0;
-             merge_candidate_order_index < merge_candidate_order.size();
-             ++merge_candidate_order_index) {
-            pair<int, int> other_candidate =
-                merge_candidate_order[merge_candidate_order_index];
-            if ((other_candidate.first == ts_index1 &&
-                 other_candidate.second == ts_index2) ||
-                (other_candidate.second == ts_index1 &&
-                 other_candidate.first == ts_index2)) {
-                // use the index in the merge candidate order as score
-                scores.push_back(merge_candidate_order_index);
-                break;
-            }
-        }
-        // We must have inserted a score for the current candidate.
-        assert(scores.size() == candidate_index + 1);
+    for (pair<int, int> merge_candidate : merge_candidates) {
+        size_t pos1 = transition_system_positions[merge_candidate.first];
+        size_t pos2 = transition_system_positions[merge_candidate.second];
+        assert(pos1 != pos2);
+        size_t i = min(pos1, pos2);
+        size_t j = max(pos1, pos2);
+        size_t num_candidates_before_row_i = i * num_ts - i * (i + 1) / 2;
+        scores.push_back(num_candidates_before_row_i + (j - i - 1));
     }
     return scores;
 }
@@ -106,13 +102,9 @@ void MergeScoringFunctionTotalOrder::initialize(const TaskProxy &task_proxy) {
                                        atomic_tso.end());
     }
 
-    merge_candidate_order.reserve(max_transition_system_count *
-                                  max_transition_system_count / 2);
-    for (size_t i = 0; i < transition_system_order.size(); ++i) {
-        for (size_t j = i + 1; j < transition_system_order.size(); ++j) {
-            merge_candidate_order.emplace_back(
-                transition_system_order[i], transition_system_order[j]);
-        }
+    transition_system_positions.resize(transition_system_order.size());
+    for (size_t pos = 0; pos < transition_system_order.size(); ++pos) {
+        transition_system_positions[transition_system_order[pos]] = pos;
     }
 }
 
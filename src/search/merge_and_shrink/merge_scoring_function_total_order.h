@@ -31,7 +31,8 @@ class MergeScoringFunctionTotalOrder : public MergeScoringFunction {
     bool atomic_before_product;
     int random_seed; // only for dump options
     std::shared_ptr<utils::RandomNumberGenerator> rng;
-    std::vector<std::pair<int, int>> merge_candidate_order;
+    // Position of each transition system in the transition system order.
+    std::vector<int> transition_system_positions;
 protected:
     virtual std::string name() const override;
     virtual void dump_function_specific_options() const override;
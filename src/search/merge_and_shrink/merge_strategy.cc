@@ -1,5 +1,9 @@
 #include "merge_strategy.h"
 
+#include "merge_tree.h"
+
+#include "../utils/system.h"
+
 using namespace std;
 
 namespace merge_and_shrink {
@@ -7,4 +11,13 @@ MergeStrategy::MergeStrategy(
     const FactoredTransitionSystem &fts)
     : fts(fts) {
 }
+
+vector<unique_ptr<MergeTree>> MergeStrategy::extract_independent_merge_trees(
+    int) {
+    return vector<unique_ptr<MergeTree>>();
+}
+
+void MergeStrategy::set_independent_merge_result(int, int) {
+    ABORT("Merge strategy does not support independent merges.");
+}
 }
@@ -1,10 +1,13 @@
 #ifndef MERGE_AND_SHRINK_MERGE_STRATEGY_H
 #define MERGE_AND_SHRINK_MERGE_STRATEGY_H
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
+class MergeTree;
 
 /*
   A merge strategy dictates the order in which transition systems of the
@@ -45,6 +48,22 @@ public:
     explicit MergeStrategy(const FactoredTransitionSystem &fts);
     virtual ~MergeStrategy() = default;
     virtual std::pair<int, int> get_next() = 0;
+
+    /*
+      Return at most max_num_trees merge trees over disjoint sets of factors
+      whose merges do not depend on each other or on any other merge. The
+      merge strategy will not ask for these merges anymore. Instead, the
+      caller must perform all merges of each tree and then report the index
+      of the resulting factor with set_independent_merge_result(tree_no,
+      index) before calling get_next() again. The leaves of the trees refer
+      to the factors of the factored transition system.
+
+      The default implementation does not support independent merges and
+      returns no trees.
+    */
+    virtual std::vector<std::unique_ptr<MergeTree>>
+    extract_independent_merge_trees(int max_num_trees);
+    virtual void set_independent_merge_result(int tree_no, int ts_index);
 };
 }
 
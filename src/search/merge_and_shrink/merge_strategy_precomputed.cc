@@ -21,4 +21,15 @@ pair<int, int> MergeStrategyPrecomputed::get_next() {
     assert(fts.is_active(next_merge.second));
     return next_merge;
 }
+
+vector<unique_ptr<MergeTree>>
+MergeStrategyPrecomputed::extract_independent_merge_trees(int max_num_trees) {
+    return merge_tree->detach_independent_subtrees(max_num_trees);
+}
+
+void MergeStrategyPrecomputed::set_independent_merge_result(
+    int tree_no, int ts_index) {
+    assert(fts.is_active(ts_index));
+    merge_tree->set_detached_subtree_index(tree_no, ts_index);
+}
 }
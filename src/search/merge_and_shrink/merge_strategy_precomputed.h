@@ -15,6 +15,9 @@ public:
         std::unique_ptr<MergeTree> merge_tree);
     virtual ~MergeStrategyPrecomputed() override = default;
     virtual std::pair<int, int> get_next() override;
+    virtual std::vector<std::unique_ptr<MergeTree>>
+    extract_independent_merge_trees(int max_num_trees) override;
+    virtual void set_independent_merge_result(int tree_no, int ts_index) override;
 };
 }
 
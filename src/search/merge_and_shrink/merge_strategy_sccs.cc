@@ -6,6 +6,10 @@
 #include "merge_tree_factory.h"
 #include "transition_system.h"
 
+#include "../task_proxy.h"
+
+#include "../utils/collections.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -83,4 +87,45 @@ pair<int, int> MergeStrategySCCs::get_next() {
     }
     return next_pair;
 }
+
+vector<unique_ptr<MergeTree>> MergeStrategySCCs::extract_independent_merge_trees(
+    int max_num_trees) {
+    /*
+      The SCCs are disjoint, so each of them can be merged independently if
+      we know the merge order within the SCC in advance, i.e., if we use a
+      merge tree. Merging the SCCs themselves can only start afterwards.
+      We only hand out SCCs before the first merge and only if all of them
+      fit into the given number of trees.
+    */
+    vector<unique_ptr<MergeTree>> merge_trees;
+    int num_sccs = non_singleton_cg_sccs.size();
+    if (!merge_tree_factory || !current_ts_indices.empty() ||
+        num_sccs < 2 || num_sccs > max_num_trees) {
+        return merge_trees;
+    }
+    int num_vars = task_proxy.get_variables().size();
+    assert(positions_of_independent_sccs.empty());
+    int anticipated_index = num_vars - 1;
+    for (const vector<int> &scc : non_singleton_cg_sccs) {
+        assert(scc.size() > 1);
+        anticipated_index += scc.size() - 1;
+        vector<int>::iterator it = find(
+            indices_of_merged_sccs.begin(), indices_of_merged_sccs.end(),
+            anticipated_index);
+        assert(it != indices_of_merged_sccs.end());
+        positions_of_independent_sccs.push_back(
+            it - indices_of_merged_sccs.begin());
+        merge_trees.push_back(
+            merge_tree_factory->compute_merge_tree(task_proxy, fts, scc));
+    }
+    non_singleton_cg_sccs.clear();
+    return merge_trees;
+}
+
+void MergeStrategySCCs::set_independent_merge_result(
+    int tree_no, int ts_index) {
+    assert(utils::in_bounds(tree_no, positions_of_independent_sccs));
+    assert(fts.is_active(ts_index));
+    indices_of_merged_sccs[positions_of_independent_sccs[tree_no]] = ts_index;
+}
 }
@@ -18,6 +18,11 @@ class MergeStrategySCCs : public MergeStrategy {
     std::shared_ptr<MergeSelector> merge_selector;
     std::vector<std::vector<int>> non_singleton_cg_sccs;
     std::vector<int> indices_of_merged_sccs;
+    /*
+      Positions in indices_of_merged_sccs of the SCCs handed out by
+      extract_independent_merge_trees.
+    */
+    std::vector<int> positions_of_independent_sccs;
 
     // Active "merge strategies" while merging a set of indices
     std::unique_ptr<MergeTree> current_merge_tree;
@@ -32,6 +37,9 @@ public:
         std::vector<int> indices_of_merged_sccs);
     virtual ~MergeStrategySCCs() override;
     virtual std::pair<int, int> get_next() override;
+    virtual std::vector<std::unique_ptr<MergeTree>>
+    extract_independent_merge_trees(int max_num_trees) override;
+    virtual void set_independent_merge_result(int tree_no, int ts_index) override;
 };
 }
 
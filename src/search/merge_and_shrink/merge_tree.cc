@@ -1,6 +1,8 @@
 #include "merge_tree.h"
 
+#include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/system.h"
 
@@ -117,6 +119,25 @@ int MergeTreeNode::compute_num_internal_nodes() const {
     }
 }
 
+void MergeTreeNode::collect_leaf_indices(vector<int> &leaf_indices) const {
+    if (is_leaf()) {
+        leaf_indices.push_back(ts_index);
+    } else {
+        left_child->collect_leaf_indices(leaf_indices);
+        right_child->collect_leaf_indices(leaf_indices);
+    }
+}
+
+void MergeTreeNode::remap_leaf_indices(const vector<int> &new_indices) {
+    if (is_leaf()) {
+        assert(utils::in_bounds(ts_index, new_indices));
+        ts_index = new_indices[ts_index];
+    } else {
+        left_child->remap_leaf_indices(new_indices);
+        right_child->remap_leaf_indices(new_indices);
+    }
+}
+
 void MergeTreeNode::inorder(int offset, int current_indentation) const {
     if (right_child) {
         right_child->inorder(offset, current_indentation + offset);
@@ -147,6 +168,87 @@ pair<int, int> MergeTree::get_next_merge(int new_index) {
     return next_merge->erase_children_and_set_index(new_index);
 }
 
+vector<unique_ptr<MergeTree>> MergeTree::detach_independent_subtrees(
+    int max_num_subtrees) {
+    assert(detached_subtree_leaves.empty());
+    vector<MergeTreeNode *> subtrees;
+    if (!root->is_leaf()) {
+        subtrees.push_back(root);
+    }
+    while (static_cast<int>(subtrees.size()) < max_num_subtrees) {
+        // Split the largest subtree that has at least one non-leaf child.
+        int best_pos = -1;
+        int best_size = 0;
+        for (size_t pos = 0; pos < subtrees.size(); ++pos) {
+            MergeTreeNode *node = subtrees[pos];
+            if (node->has_two_leaf_children()) {
+                continue;
+            }
+            int size = node->compute_num_internal_nodes();
+            if (size > best_size) {
+                best_pos = pos;
+                best_size = size;
+            }
+        }
+        if (best_pos == -1) {
+            break;
+        }
+        MergeTreeNode *node = subtrees[best_pos];
+        subtrees.erase(subtrees.begin() + best_pos);
+        if (!node->left_child->is_leaf()) {
+            subtrees.push_back(node->left_child);
+        }
+        if (!node->right_child->is_leaf()) {
+            subtrees.push_back(node->right_child);
+        }
+    }
+
+    vector<unique_ptr<MergeTree>> detached_subtrees;
+    if (subtrees.size() < 2) {
+        return detached_subtrees;
+    }
+    for (MergeTreeNode *node : subtrees) {
+        // Since there are at least two subtrees, the root is never detached.
+        MergeTreeNode *parent = node->parent;
+        assert(parent);
+        MergeTreeNode *leaf = new MergeTreeNode(UNINITIALIZED);
+        leaf->parent = parent;
+        if (parent->left_child == node) {
+            parent->left_child = leaf;
+        } else {
+            assert(parent->right_child == node);
+            parent->right_child = leaf;
+        }
+        node->parent = nullptr;
+        detached_subtree_leaves.push_back(leaf);
+        detached_subtrees.push_back(
+            utils::make_unique_ptr<MergeTree>(node, rng, update_option));
+    }
+    return detached_subtrees;
+}
+
+void MergeTree::set_detached_subtree_index(int subtree_no, int ts_index) {
+    assert(utils::in_bounds(subtree_no, detached_subtree_leaves));
+    MergeTreeNode *leaf = detached_subtree_leaves[subtree_no];
+    assert(leaf && leaf->is_leaf() && leaf->ts_index == UNINITIALIZED);
+    leaf->ts_index = ts_index;
+    /*
+      The leaf will be deleted when it is merged, so we must not keep the
+      pointer around.
+    */
+    detached_subtree_leaves[subtree_no] = nullptr;
+}
+
+vector<int> MergeTree::get_leaf_indices() const {
+    vector<int> leaf_indices;
+    root->collect_leaf_indices(leaf_indices);
+    return leaf_indices;
+}
+
+void MergeTree::remap_leaf_indices(const vector<int> &new_indices) {
+    root->remap_leaf_indices(new_indices);
+}
+
 pair<MergeTreeNode *, MergeTreeNode *> MergeTree::get_parents_of_ts_indices(
     const pair<int, int> &ts_indices, int new_index) {
     int ts_index1 = ts_indices.first;
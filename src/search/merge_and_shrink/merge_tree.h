@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace utils {
 class RandomNumberGenerator;
@@ -34,6 +35,8 @@ struct MergeTreeNode {
     // Find the parent node for the given index.
     MergeTreeNode *get_parent_of_ts_index(int index);
     int compute_num_internal_nodes() const;
+    void collect_leaf_indices(std::vector<int> &leaf_indices) const;
+    void remap_leaf_indices(const std::vector<int> &new_indices);
     void inorder(int offset, int current_indentation) const;
 
     bool is_leaf() const {
@@ -76,11 +79,17 @@ enum class UpdateOption {
   functionality, using the user specified choice update_option to choose one
   of two possible leaf nodes representing the indices of the given merge as the
   future node representing the merge.
+
+  Disjoint subtrees of a merge tree can be merged independently of each
+  other. The method detach_independent_subtrees supports this by moving such
+  subtrees to merge trees of their own.
 */
 class MergeTree {
     MergeTreeNode *root;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
     UpdateOption update_option;
+    // Leaves that replace the subtrees returned by detach_independent_subtrees.
+    std::vector<MergeTreeNode *> detached_subtree_leaves;
     /*
       Find the two parents (can be the same) of the given indices. The first
       one will correspond to a merge that would have been merged earlier in
@@ -102,6 +111,27 @@ public:
     */
     void update(std::pair<int, int> merge, int new_index);
 
+    /*
+      Detach at most max_num_subtrees disjoint subtrees from the tree and
+      return them as merge trees of their own. We repeatedly split the
+      largest subtree into its children, starting from the root. If this
+      does not lead to at least two subtrees, nothing is detached and the
+      result is empty.
+
+      Each detached subtree is replaced by a leaf in this tree. Once the
+      subtree with number i has been merged into a single transition system,
+      its index must be set with set_detached_subtree_index(i, index) before
+      asking this tree for the next merge.
+    */
+    std::vector<std::unique_ptr<MergeTree>> detach_independent_subtrees(
+        int max_num_subtrees);
+    void set_detached_subtree_index(int subtree_no, int ts_index);
+
+    // Return the indices of all leaves from left to right.
+    std::vector<int> get_leaf_indices() const;
+    // Replace every leaf index i by new_indices[i].
+    void remap_leaf_indices(const std::vector<int> &new_indices);
+
     bool done() const {
         return root->is_leaf();
     }
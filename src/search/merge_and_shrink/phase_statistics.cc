@@ -0,0 +1,107 @@
+#include "phase_statistics.h"
+
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace merge_and_shrink {
+static const char *get_phase_name(Phase phase) {
+    switch (phase) {
+    case Phase::LABEL_REDUCTION:
+        return "label_reduction";
+    case Phase::SHRINKING:
+        return "shrinking";
+    case Phase::MERGING:
+        return "merging";
+    case Phase::DISTANCES:
+        return "distances";
+    case Phase::PRUNING:
+        return "pruning";
+    case Phase::INDEPENDENT_MERGING:
+        return "independent_merging";
+    }
+    return "unknown";
+}
+
+PhaseStatistics::PhaseStatistics(const string &trace_file, bool track_memory)
+    : phase_data(static_cast<int>(Phase::INDEPENDENT_MERGING) + 1),
+      track_memory(track_memory || !trace_file.empty()),
+      phase_timer(false),
+      phase_start_rss_in_kb(0) {
+    if (!trace_file.empty()) {
+        trace = utils::make_unique_ptr<ofstream>(trace_file);
+        if (!*trace) {
+            cerr << "Could not open trace file " << trace_file << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        *trace << "iteration,phase,time,transitions,rss_kb,rss_delta_kb,"
+            "peak_memory_kb" << endl;
+    }
+}
+
+void PhaseStatistics::add_measurement(
+    Phase phase, int iteration, double time, int num_transitions,
+    int rss_in_kb, int rss_delta_in_kb) {
+    PhaseData &data = phase_data[static_cast<int>(phase)];
+    ++data.count;
+    data.time += time;
+    data.max_num_transitions = max(data.max_num_transitions, num_transitions);
+    data.rss_delta_in_kb += rss_delta_in_kb;
+    if (trace) {
+        *trace << iteration << "," << get_phase_name(phase) << ","
+               << time << "," << num_transitions << ","
+               << rss_in_kb << "," << rss_delta_in_kb << ","
+               << utils::get_peak_memory_in_kb() << "\n";
+    }
+}
+
+void PhaseStatistics::start_phase() {
+    if (track_memory) {
+        phase_start_rss_in_kb = utils::get_current_memory_in_kb();
+    }
+    phase_timer.reset();
+    phase_timer.resume();
+}
+
+void PhaseStatistics::end_phase(
+    Phase phase, int iteration, int num_transitions, double distances_time) {
+    double time = phase_timer.stop();
+    int rss_in_kb = track_memory ? utils::get_current_memory_in_kb() : 0;
+    int rss_delta_in_kb = rss_in_kb - phase_start_rss_in_kb;
+    if (distances_time > 0) {
+        distances_time = min(distances_time, time);
+        time -= distances_time;
+        add_measurement(
+            Phase::DISTANCES, iteration, distances_time, num_transitions,
+            rss_in_kb, 0);
+    }
+    add_measurement(
+        phase, iteration, time, num_transitions, rss_in_kb, rss_delta_in_kb);
+}
+
+void PhaseStatistics::dump() const {
+    utils::g_log << "Main loop phases (count, time, max transitions"
+                 << (track_memory ? ", RSS delta" : "") << "):" << endl;
+    for (size_t i = 0; i < phase_data.size(); ++i) {
+        const PhaseData &data = phase_data[i];
+        if (data.count == 0) {
+            continue;
+        }
+        utils::g_log << "  " << get_phase_name(static_cast<Phase>(i)) << ": "
+                     << data.count << ", " << data.time << "s, "
+                     << data.max_num_transitions;
+        if (track_memory) {
+            utils::g_log << ", " << data.rss_delta_in_kb << " KB";
+        }
+        utils::g_log << endl;
+    }
+    if (trace) {
+        trace->flush();
+    }
+}
+}
@@ -0,0 +1,69 @@
+#ifndef MERGE_AND_SHRINK_PHASE_STATISTICS_H
+#define MERGE_AND_SHRINK_PHASE_STATISTICS_H
+
+#include "../utils/timer.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace merge_and_shrink {
+enum class Phase {
+    LABEL_REDUCTION,
+    SHRINKING,
+    MERGING,
+    DISTANCES,
+    PRUNING,
+    INDEPENDENT_MERGING
+};
+
+/*
+  Statistics about the phases of the merge-and-shrink main loop: for each
+  phase, we collect the time spent in it, the maximum number of transitions
+  of a factor after it and the change of the resident set size (RSS).
+
+  Optionally, the measurements are also written to a trace file in CSV
+  format with one line per phase and iteration. Reading the RSS requires a
+  system call, so we only measure it if requested or if we write a trace.
+*/
+class PhaseStatistics {
+    struct PhaseData {
+        int count;
+        double time;
+        int max_num_transitions;
+        int rss_delta_in_kb;
+
+        PhaseData()
+            : count(0), time(0), max_num_transitions(0), rss_delta_in_kb(0) {
+        }
+    };
+
+    std::vector<PhaseData> phase_data;
+    std::unique_ptr<std::ofstream> trace;
+    const bool track_memory;
+    utils::Timer phase_timer;
+    int phase_start_rss_in_kb;
+
+    void add_measurement(
+        Phase phase, int iteration, double time, int num_transitions,
+        int rss_in_kb, int rss_delta_in_kb);
+public:
+    // If trace_file is empty, no trace is written.
+    PhaseStatistics(const std::string &trace_file, bool track_memory);
+
+    void start_phase();
+
+    /*
+      Finish the phase started last. The given part of its time was spent
+      on computing distances and is attributed to the distances phase.
+    */
+    void end_phase(
+        Phase phase, int iteration, int num_transitions,
+        double distances_time = 0);
+
+    void dump() const;
+};
+}
+
+#endif
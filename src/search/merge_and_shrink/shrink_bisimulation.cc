@@ -1,5 +1,6 @@
 #include "shrink_bisimulation.h"
 
+#include "bisimulation_refinement.h"
 #include "distances.h"
 #include "factored_transition_system.h"
 #include "label_equivalence_relation.h"
@@ -15,84 +16,27 @@
 
 #include <algorithm>
 #include <cassert>
-#include <limits>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <unordered_map>
 
 using namespace std;
 
 namespace merge_and_shrink {
-/* A successor signature characterizes the behaviour of an abstract
-   state in so far as bisimulation cares about it. States with
-   identical successor signature are not distinguished by
-   bisimulation.
-
-   Each entry in the vector is a pair of (label group ID, equivalence class of
-   successor). The bisimulation algorithm requires that the vector is
-   sorted and uniquified. */
-using SuccessorSignature = vector<pair<int, int>>;
-
-/*
-  As we use SENTINEL numeric_limits<int>::max() as a sentinel signature and
-  irrelevant states have a distance of INF = numeric_limits<int>::max(), we
-  use INF - 1 as the distance value for all irrelevant states. This guarantees
-  that also irrelevant states are always ordered before the sentinel.
-*/
-const int SENTINEL = numeric_limits<int>::max();
-const int IRRELEVANT = SENTINEL - 1;
-
 /*
-  The following class encodes all we need to know about a state for
-  bisimulation: its h value, which equivalence class ("group") it currently
-  belongs to, its successor signature (see above), and what the original
-  state is.
+  Bisimulation considers states in the order of their h values, with goal
+  states first: the result is -1 for goal states and the h value for
+  non-goal states (INF for irrelevant states).
 */
-
-struct Signature {
-    int h_and_goal; // -1 for goal states; h value for non-goal states
-    int group;
-    SuccessorSignature succ_signature;
-    int state;
-
-    Signature(int h, bool is_goal, int group_,
-              const SuccessorSignature &succ_signature_,
-              int state_)
-        : group(group_), succ_signature(succ_signature_), state(state_) {
-        if (is_goal) {
-            assert(h == 0);
-            h_and_goal = -1;
-        } else {
-            h_and_goal = h;
-        }
-    }
-
-    bool operator<(const Signature &other) const {
-        if (h_and_goal != other.h_and_goal)
-            return h_and_goal < other.h_and_goal;
-        if (group != other.group)
-            return group < other.group;
-        if (succ_signature != other.succ_signature)
-            return succ_signature < other.succ_signature;
-        return state < other.state;
-    }
-
-    void dump() const {
-        utils::g_log << "Signature(h_and_goal = " << h_and_goal
-                     << ", group = " << group
-                     << ", state = " << state
-                     << ", succ_sig = [";
-        for (size_t i = 0; i < succ_signature.size(); ++i) {
-            if (i)
-                utils::g_log << ", ";
-            utils::g_log << "(" << succ_signature[i].first
-                         << "," << succ_signature[i].second
-                         << ")";
-        }
-        utils::g_log << "])" << endl;
+static int get_h_and_goal(
+    const TransitionSystem &ts, const Distances &distances, int state) {
+    if (ts.is_goal_state(state)) {
+        assert(distances.get_goal_distance(state) == 0);
+        return -1;
     }
-};
-
+    return distances.get_goal_distance(state);
+}
 
 ShrinkBisimulation::ShrinkBisimulation(const Options &opts)
     : greedy(opts.get<bool>("greedy")),
@@ -118,9 +62,6 @@ int ShrinkBisimulation::initialize_groups(
     int num_groups = 1; // Group 0 is for goal states.
     for (int state = 0; state < ts.get_size(); ++state) {
         int h = distances.get_goal_distance(state);
-        if (h == INF) {
-            h = IRRELEVANT;
-        }
         if (ts.is_goal_state(state)) {
             assert(h == 0);
             state_to_group[state] = 0;
@@ -137,29 +78,27 @@ int ShrinkBisimulation::initialize_groups(
     return num_groups;
 }
 
-void ShrinkBisimulation::compute_signatures(
-    const TransitionSystem &ts,
-    const Distances &distances,
-    vector<Signature> &signatures,
-    const vector<int> &state_to_group) const {
-    assert(signatures.empty());
-
-    // Step 1: Compute bare state signatures (without transition information).
-    signatures.push_back(Signature(-2, false, -1, SuccessorSignature(), -1));
-    for (int state = 0; state < ts.get_size(); ++state) {
-        int h = distances.get_goal_distance(state);
-        if (h == INF) {
-            h = IRRELEVANT;
-        }
-        Signature signature(h, ts.is_goal_state(state),
-                            state_to_group[state], SuccessorSignature(),
-                            state);
-        signatures.push_back(signature);
+/*
+  In greedy bisimulation, we only consider transitions that lie on an
+  optimal path between relevant states.
+*/
+static bool is_greedy_transition(
+    const Distances &distances, int cost, const Transition &transition) {
+    int src_h = distances.get_goal_distance(transition.src);
+    int target_h = distances.get_goal_distance(transition.target);
+    if (src_h == INF || target_h == INF) {
+        // We skip transitions connected to an irrelevant state.
+        return false;
     }
-    signatures.push_back(Signature(SENTINEL, false, -1, SuccessorSignature(), -1));
+    assert(target_h + cost >= src_h);
+    return target_h + cost == src_h;
+}
 
-    // Step 2: Add transition information.
-    int label_group_counter = 0;
+static vector<LabeledTransition> compute_transitions(
+    const TransitionSystem &ts,
+    const Distances &distances,
+    bool greedy,
+    int &num_label_groups) {
     /*
       Note that the final result of the bisimulation may depend on the
       order in which transitions are considered below.
@@ -184,122 +123,167 @@ void ShrinkBisimulation::compute_signatures(
                                                 threshold=1),
             label_reduction=exact(before_shrinking=true,before_merging=false)))
     */
+    vector<LabeledTransition> transitions;
+    int label_group_counter = 0;
     for (GroupAndTransitions gat : ts) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            assert(signatures[transition.src + 1].state == transition.src);
-            bool skip_transition = false;
-            if (greedy) {
-                int src_h = distances.get_goal_distance(transition.src);
-                int target_h = distances.get_goal_distance(transition.target);
-                if (src_h == INF || target_h == INF) {
-                    // We skip transitions connected to an irrelevant state.
-                    skip_transition = true;
-                } else {
-                    int cost = label_group.get_cost();
-                    assert(target_h + cost >= src_h);
-                    skip_transition = (target_h + cost != src_h);
-                }
-            }
-            if (!skip_transition) {
-                int target_group = state_to_group[transition.target];
-                assert(target_group != -1 && target_group != SENTINEL);
-                signatures[transition.src + 1].succ_signature.push_back(
-                    make_pair(label_group_counter, target_group));
+        int cost = gat.label_group.get_cost();
+        for (const Transition &transition : gat.transitions) {
+            if (!greedy || is_greedy_transition(distances, cost, transition)) {
+                transitions.emplace_back(
+                    transition.src, label_group_counter, transition.target);
             }
         }
         ++label_group_counter;
     }
-
-    /* Step 3: Canonicalize the representation. The resulting
-       signatures must satisfy the following properties:
-
-       1. Signature::operator< defines a total order with the correct
-          sentinels at the start and end. The signatures vector is
-          sorted according to that order.
-       2. Goal states come before non-goal states, and low-h states come
-          before high-h states.
-       3. States that currently fall into the same group form contiguous
-          subsequences.
-       4. Two signatures compare equal according to Signature::operator<
-          iff we don't want to distinguish their states in the current
-          bisimulation round.
-     */
-
-    for (size_t i = 0; i < signatures.size(); ++i) {
-        SuccessorSignature &succ_sig = signatures[i].succ_signature;
-        ::sort(succ_sig.begin(), succ_sig.end());
-        succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
-                       succ_sig.end());
-    }
-
-    ::sort(signatures.begin(), signatures.end());
+    num_label_groups = label_group_counter;
+    return transitions;
 }
 
-StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
+/*
+  Refine the groups in rounds. In each round, we compute the successor
+  signature of each state: the sorted set of pairs (label group ID, group
+  of successor). We then consider the h values in increasing order and
+  split the groups with the respective h value such that the states in
+  each new group have the same signature, unless this would exceed the
+  size limit. States with the same signature are not distinguished by
+  bisimulation.
+
+  The signature of a state only changes if the group of one of its
+  successors changes. Therefore, we only recompute the signatures of the
+  states in groups that contain a predecessor of a state that changed its
+  group in the previous round ("dirty" groups). All other groups cannot be
+  split.
+*/
+int ShrinkBisimulation::refine_groups_by_signatures(
     const TransitionSystem &ts,
     const Distances &distances,
-    int target_size) const {
-    assert(distances.are_goal_distances_computed());
+    const vector<LabeledTransition> &transitions,
+    int target_size,
+    int num_groups,
+    vector<int> &state_to_group) const {
     int num_states = ts.get_size();
 
-    vector<int> state_to_group(num_states);
-    vector<Signature> signatures;
-    signatures.reserve(num_states + 2);
+    vector<int> group_h_and_goal(num_groups);
+    vector<vector<int>> group_states(num_groups);
+    for (int state = 0; state < num_states; ++state) {
+        int group = state_to_group[state];
+        group_states[group].push_back(state);
+        group_h_and_goal[group] = get_h_and_goal(ts, distances, state);
+    }
 
-    int num_groups = initialize_groups(ts, distances, state_to_group);
-    // utils::g_log << "number of initial groups: " << num_groups << endl;
+    // Successors (label group ID, target) and predecessors of each state.
+    vector<int> succ_begin(num_states + 1, 0);
+    vector<int> pred_begin(num_states + 1, 0);
+    for (const LabeledTransition &transition : transitions) {
+        ++succ_begin[transition.src + 1];
+        ++pred_begin[transition.target + 1];
+    }
+    for (int state = 0; state < num_states; ++state) {
+        succ_begin[state + 1] += succ_begin[state];
+        pred_begin[state + 1] += pred_begin[state];
+    }
+    vector<pair<int, int>> successors(transitions.size());
+    vector<int> predecessors(transitions.size());
+    {
+        vector<int> next_succ(succ_begin.begin(), succ_begin.end() - 1);
+        vector<int> next_pred(pred_begin.begin(), pred_begin.end() - 1);
+        for (const LabeledTransition &transition : transitions) {
+            successors[next_succ[transition.src]++] =
+                make_pair(transition.label, transition.target);
+            predecessors[next_pred[transition.target]++] = transition.src;
+        }
+    }
 
-    // TODO: We currently violate this; see issue250
-    // assert(num_groups <= target_size);
+    // Initially, all groups are dirty.
+    vector<int> dirty_groups(num_groups);
+    iota(dirty_groups.begin(), dirty_groups.end(), 0);
+    vector<bool> is_dirty(num_groups, true);
 
-    bool stable = false;
+    /*
+      The signature of the state with index i in the current round
+      consists of signatures[signature_begin[i]], ...,
+      signatures[signature_begin[i + 1] - 1].
+    */
+    vector<int> state_to_signature(num_states, -1);
+    vector<int> signature_begin;
+    vector<pair<int, int>> signatures;
+    auto signature_less = [&](int state1, int state2) {
+            int index1 = state_to_signature[state1];
+            int index2 = state_to_signature[state2];
+            auto begin1 = signatures.begin() + signature_begin[index1];
+            auto end1 = signatures.begin() + signature_begin[index1 + 1];
+            auto begin2 = signatures.begin() + signature_begin[index2];
+            auto end2 = signatures.begin() + signature_begin[index2 + 1];
+            return lexicographical_compare(begin1, end1, begin2, end2);
+        };
+    auto signature_equal = [&](int state1, int state2) {
+            return !signature_less(state1, state2) &&
+                   !signature_less(state2, state1);
+        };
+
+    vector<int> changed_states;
+    vector<int> num_new_subgroups(num_groups);
     bool stop_requested = false;
-    while (!stable && !stop_requested && num_groups < target_size) {
-        stable = true;
-
+    while (!dirty_groups.empty() && !stop_requested &&
+           num_groups < target_size) {
+        sort(dirty_groups.begin(), dirty_groups.end(),
+             [&group_h_and_goal](int group1, int group2) {
+                 return make_pair(group_h_and_goal[group1], group1) <
+                 make_pair(group_h_and_goal[group2], group2);
+             });
+
+        // Compute the signatures of all states in dirty groups.
+        signature_begin.clear();
         signatures.clear();
-        compute_signatures(ts, distances, signatures, state_to_group);
-
-        // Verify size of signatures and presence of sentinels.
-        assert(static_cast<int>(signatures.size()) == num_states + 2);
-        assert(signatures[0].h_and_goal == -2);
-        assert(signatures[num_states + 1].h_and_goal == SENTINEL);
-
-        int sig_start = 1; // Skip over initial sentinel.
-        while (true) {
-            int h_and_goal = signatures[sig_start].h_and_goal;
-            if (h_and_goal == SENTINEL) {
-                // We have hit the end sentinel.
-                assert(sig_start + 1 == static_cast<int>(signatures.size()));
-                break;
+        for (int group : dirty_groups) {
+            for (int state : group_states[group]) {
+                state_to_signature[state] = signature_begin.size();
+                signature_begin.push_back(signatures.size());
+                for (int i = succ_begin[state]; i < succ_begin[state + 1]; ++i) {
+                    const pair<int, int> &succ = successors[i];
+                    signatures.emplace_back(
+                        succ.first, state_to_group[succ.second]);
+                }
+                auto begin = signatures.begin() + signature_begin.back();
+                sort(begin, signatures.end());
+                signatures.erase(unique(begin, signatures.end()),
+                                 signatures.end());
+            }
+        }
+        signature_begin.push_back(signatures.size());
+
+        // Sort the states of each dirty group by signature and state.
+        for (int group : dirty_groups) {
+            vector<int> &states = group_states[group];
+            sort(states.begin(), states.end(),
+                 [&](int state1, int state2) {
+                     if (signature_less(state1, state2))
+                         return true;
+                     if (signature_less(state2, state1))
+                         return false;
+                     return state1 < state2;
+                 });
+            int num_subgroups = 1;
+            for (size_t i = 1; i < states.size(); ++i) {
+                if (!signature_equal(states[i - 1], states[i]))
+                    ++num_subgroups;
             }
+            num_new_subgroups[group] = num_subgroups;
+        }
 
-            // Compute the number of groups needed after splitting.
+        // Split the groups of each h value.
+        size_t layer_start = 0;
+        while (layer_start < dirty_groups.size()) {
+            int h_and_goal = group_h_and_goal[dirty_groups[layer_start]];
+            size_t layer_end = layer_start;
             int num_old_groups = 0;
             int num_new_groups = 0;
-            int sig_end;
-            for (sig_end = sig_start; true; ++sig_end) {
-                if (signatures[sig_end].h_and_goal != h_and_goal) {
-                    break;
-                }
-
-                const Signature &prev_sig = signatures[sig_end - 1];
-                const Signature &curr_sig = signatures[sig_end];
-
-                if (sig_end == sig_start) {
-                    assert(prev_sig.group != curr_sig.group);
-                }
-
-                if (prev_sig.group != curr_sig.group) {
-                    ++num_old_groups;
-                    ++num_new_groups;
-                } else if (prev_sig.succ_signature != curr_sig.succ_signature) {
-                    ++num_new_groups;
-                }
+            for (; layer_end < dirty_groups.size() &&
+                 group_h_and_goal[dirty_groups[layer_end]] == h_and_goal;
+                 ++layer_end) {
+                ++num_old_groups;
+                num_new_groups += num_new_subgroups[dirty_groups[layer_end]];
             }
-            assert(sig_end > sig_start);
 
             if (at_limit == AtLimit::RETURN &&
                 num_groups - num_old_groups + num_new_groups > target_size) {
@@ -311,38 +295,99 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
                 break;
             } else if (num_new_groups != num_old_groups) {
                 // Split into new groups.
-                stable = false;
-
-                int new_group_no = -1;
-                for (int i = sig_start; i < sig_end; ++i) {
-                    const Signature &prev_sig = signatures[i - 1];
-                    const Signature &curr_sig = signatures[i];
-
-                    if (prev_sig.group != curr_sig.group) {
-                        // Start first group of a block; keep old group no.
-                        new_group_no = curr_sig.group;
-                    } else if (prev_sig.succ_signature
-                               != curr_sig.succ_signature) {
-                        new_group_no = num_groups++;
-                        assert(num_groups <= target_size);
+                for (size_t i = layer_start; i < layer_end; ++i) {
+                    int group = dirty_groups[i];
+                    vector<int> states;
+                    states.swap(group_states[group]);
+                    // Start first group of a block; keep old group no.
+                    int new_group_no = group;
+                    for (size_t j = 0; j < states.size(); ++j) {
+                        int state = states[j];
+                        if (j > 0 && !signature_equal(states[j - 1], state)) {
+                            new_group_no = num_groups++;
+                            assert(num_groups <= target_size);
+                        }
+                        if (state_to_group[state] != new_group_no) {
+                            state_to_group[state] = new_group_no;
+                            changed_states.push_back(state);
+                        }
+                        if (num_groups == target_size)
+                            break;
+                    }
+                    group_states.resize(num_groups);
+                    group_h_and_goal.resize(num_groups, h_and_goal);
+                    is_dirty.resize(num_groups, false);
+                    num_new_subgroups.resize(num_groups);
+                    for (int state : states) {
+                        group_states[state_to_group[state]].push_back(state);
                     }
-
-                    assert(new_group_no != -1);
-                    state_to_group[curr_sig.state] = new_group_no;
                     if (num_groups == target_size)
                         break;
                 }
                 if (num_groups == target_size)
                     break;
             }
-            sig_start = sig_end;
+            layer_start = layer_end;
         }
+
+        // Collect the dirty groups for the next round.
+        for (int group : dirty_groups) {
+            is_dirty[group] = false;
+        }
+        dirty_groups.clear();
+        for (int state : changed_states) {
+            for (int i = pred_begin[state]; i < pred_begin[state + 1]; ++i) {
+                int group = state_to_group[predecessors[i]];
+                if (!is_dirty[group]) {
+                    is_dirty[group] = true;
+                    dirty_groups.push_back(group);
+                }
+            }
+        }
+        changed_states.clear();
     }
+    return num_groups;
+}
 
-    /* Reduce memory pressure before generating the equivalence
-       relation since this is one of the code parts relevant to peak
-       memory. */
-    utils::release_vector_memory(signatures);
+StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
+    const TransitionSystem &ts,
+    const Distances &distances,
+    int target_size) const {
+    assert(distances.are_goal_distances_computed());
+    int num_states = ts.get_size();
+
+    vector<int> state_to_group(num_states);
+    int num_groups = initialize_groups(ts, distances, state_to_group);
+    // utils::g_log << "number of initial groups: " << num_groups << endl;
+
+    // TODO: We currently violate this; see issue250
+    // assert(num_groups <= target_size);
+
+    if (num_groups < target_size) {
+        /*
+          Without a size limit, refining the groups by signatures until
+          they are stable yields the coarsest bisimulation that refines the
+          initial groups. Partition refinement computes it faster. If the
+          coarsest bisimulation does not fit into the size limit, the
+          partition refinement stops early and we use signatures to obtain
+          the result that respects the limit.
+        */
+        int num_label_groups;
+        vector<LabeledTransition> transitions = compute_transitions(
+            ts, distances, greedy, num_label_groups);
+        vector<int> refined_state_to_group = state_to_group;
+        int num_refined_groups = compute_coarsest_bisimulation(
+            num_states, num_label_groups, transitions, refined_state_to_group,
+            num_groups, target_size);
+        if (num_refined_groups < target_size) {
+            state_to_group = move(refined_state_to_group);
+            num_groups = num_refined_groups;
+        } else {
+            num_groups = refine_groups_by_signatures(
+                ts, distances, transitions, target_size, num_groups,
+                state_to_group);
+        }
+    }
 
     // Generate final result.
     StateEquivalenceRelation equivalence_relation;
@@ -8,7 +8,7 @@ class Options;
 }
 
 namespace merge_and_shrink {
-struct Signature;
+struct LabeledTransition;
 
 enum class AtLimit {
     RETURN,
@@ -30,11 +30,13 @@ class ShrinkBisimulation : public ShrinkStrategy {
         const Distances &distances,
         std::vector<int> &state_to_group) const;
 
-    void compute_signatures(
+    int refine_groups_by_signatures(
         const TransitionSystem &ts,
         const Distances &distances,
-        std::vector<Signature> &signatures,
-        const std::vector<int> &state_to_group) const;
+        const std::vector<LabeledTransition> &transitions,
+        int target_size,
+        int num_groups,
+        std::vector<int> &state_to_group) const;
 protected:
     virtual void dump_strategy_specific_options() const override;
     virtual std::string name() const override;
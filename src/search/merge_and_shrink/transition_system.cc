@@ -4,7 +4,6 @@
 #include "label_equivalence_relation.h"
 #include "labels.h"
 
-#include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 #include "../utils/system.h"
@@ -13,7 +12,6 @@
 #include <cassert>
 #include <iostream>
 #include <iterator>
-#include <set>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -28,18 +26,69 @@ ostream &operator<<(ostream &os, const Transition &trans) {
     return os;
 }
 
-// Sorts the given set of transitions and removes duplicates.
-static void normalize_given_transitions(vector<Transition> &transitions) {
-    sort(transitions.begin(), transitions.end());
-    transitions.erase(unique(transitions.begin(), transitions.end()), transitions.end());
+/*
+  Sort the transitions in the range [begin, end) and move duplicates to the
+  end of the range. Return the end of the resulting range without
+  duplicates.
+*/
+static vector<Transition>::iterator normalize_given_transitions(
+    vector<Transition>::iterator begin, vector<Transition>::iterator end) {
+    // Order-preserving abstractions (e.g., pruning) keep transitions sorted.
+    if (!is_sorted(begin, end)) {
+        sort(begin, end);
+    }
+    return unique(begin, end);
+}
+
+/*
+  Append the product of the given sorted transitions to new_transitions in
+  sorted order. The product of transitions s1->t1 and s2->t2 is
+  (s1 * multiplier + s2)->(t1 * multiplier + t2), so the products are
+  sorted by s1, s2, t1 and t2. We generate them in this order by combining
+  the transitions of each source state s1 with those of each source state
+  s2.
+*/
+static void append_product_transitions(
+    TransitionRange transitions1, TransitionRange transitions2,
+    int multiplier, vector<Transition> &new_transitions) {
+    const Transition *block1_begin = transitions1.begin();
+    while (block1_begin != transitions1.end()) {
+        int src1 = block1_begin->src;
+        const Transition *block1_end = block1_begin;
+        while (block1_end != transitions1.end() && block1_end->src == src1) {
+            ++block1_end;
+        }
+        const Transition *block2_begin = transitions2.begin();
+        while (block2_begin != transitions2.end()) {
+            int src2 = block2_begin->src;
+            const Transition *block2_end = block2_begin;
+            while (block2_end != transitions2.end() && block2_end->src == src2) {
+                ++block2_end;
+            }
+            int src = src1 * multiplier + src2;
+            for (const Transition *transition1 = block1_begin;
+                 transition1 != block1_end; ++transition1) {
+                int target1 = transition1->target * multiplier;
+                for (const Transition *transition2 = block2_begin;
+                     transition2 != block2_end; ++transition2) {
+                    new_transitions.emplace_back(
+                        src, target1 + transition2->target);
+                }
+            }
+            block2_begin = block2_end;
+        }
+        block1_begin = block1_end;
+    }
 }
 
 TSConstIterator::TSConstIterator(
     const LabelEquivalenceRelation &label_equivalence_relation,
-    const vector<vector<Transition>> &transitions_by_group_id,
+    const vector<Transition> &transitions,
+    const vector<int> &group_offsets,
     bool end)
     : label_equivalence_relation(label_equivalence_relation),
-      transitions_by_group_id(transitions_by_group_id),
+      transitions(transitions),
+      group_offsets(group_offsets),
       current_group_id((end ? label_equivalence_relation.get_size() : 0)) {
     next_valid_index();
 }
@@ -59,7 +108,9 @@ void TSConstIterator::operator++() {
 GroupAndTransitions TSConstIterator::operator*() const {
     return GroupAndTransitions(
         label_equivalence_relation.get_group(current_group_id),
-        transitions_by_group_id[current_group_id]);
+        TransitionRange(
+            transitions.data() + group_offsets[current_group_id],
+            transitions.data() + group_offsets[current_group_id + 1]));
 }
 
 
@@ -89,7 +140,39 @@ TransitionSystem::TransitionSystem(
     : num_variables(num_variables),
       incorporated_variables(move(incorporated_variables)),
       label_equivalence_relation(move(label_equivalence_relation)),
-      transitions_by_group_id(move(transitions_by_group_id)),
+      num_states(num_states),
+      goal_states(move(goal_states)),
+      init_state(init_state) {
+    size_t num_transitions = 0;
+    for (const vector<Transition> &group_transitions : transitions_by_group_id) {
+        num_transitions += group_transitions.size();
+    }
+    transitions.reserve(num_transitions);
+    group_offsets.reserve(transitions_by_group_id.size() + 1);
+    group_offsets.push_back(0);
+    for (const vector<Transition> &group_transitions : transitions_by_group_id) {
+        transitions.insert(transitions.end(), group_transitions.begin(),
+                           group_transitions.end());
+        group_offsets.push_back(transitions.size());
+    }
+    assert(are_transitions_sorted_unique());
+    assert(in_sync_with_label_equivalence_relation());
+}
+
+TransitionSystem::TransitionSystem(
+    int num_variables,
+    vector<int> &&incorporated_variables,
+    unique_ptr<LabelEquivalenceRelation> &&label_equivalence_relation,
+    vector<Transition> &&transitions,
+    vector<int> &&group_offsets,
+    int num_states,
+    vector<bool> &&goal_states,
+    int init_state)
+    : num_variables(num_variables),
+      incorporated_variables(move(incorporated_variables)),
+      label_equivalence_relation(move(label_equivalence_relation)),
+      transitions(move(transitions)),
+      group_offsets(move(group_offsets)),
       num_states(num_states),
       goal_states(move(goal_states)),
       init_state(init_state) {
@@ -103,7 +186,8 @@ TransitionSystem::TransitionSystem(const TransitionSystem &other)
       label_equivalence_relation(
           utils::make_unique_ptr<LabelEquivalenceRelation>(
               *other.label_equivalence_relation)),
-      transitions_by_group_id(other.transitions_by_group_id),
+      transitions(other.transitions),
+      group_offsets(other.group_offsets),
       num_states(other.num_states),
       goal_states(other.goal_states),
       init_state(other.init_state) {
@@ -112,6 +196,29 @@ TransitionSystem::TransitionSystem(const TransitionSystem &other)
 TransitionSystem::~TransitionSystem() {
 }
 
+size_t TransitionSystem::compute_product_num_transitions(
+    const TransitionSystem &ts1,
+    const TransitionSystem &ts2) {
+    // See merge() for how the label groups of the product are formed.
+    size_t num_transitions = 0;
+    unordered_set<int> groups2;
+    for (GroupAndTransitions gat : ts1) {
+        size_t num_transitions1 = gat.transitions.size();
+        if (num_transitions1 == 0) {
+            continue;
+        }
+        groups2.clear();
+        for (int label_no : gat.label_group) {
+            groups2.insert(ts2.label_equivalence_relation->get_group_id(label_no));
+        }
+        for (int group2_id : groups2) {
+            num_transitions += num_transitions1 *
+                ts2.get_transitions_for_group_id(group2_id).size();
+        }
+    }
+    return num_transitions;
+}
+
 unique_ptr<TransitionSystem> TransitionSystem::merge(
     const Labels &labels,
     const TransitionSystem &ts1,
@@ -132,8 +239,6 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         ts2.incorporated_variables.begin(), ts2.incorporated_variables.end(),
         back_inserter(incorporated_variables));
     vector<vector<int>> label_groups;
-    vector<vector<Transition>> transitions_by_group_id;
-    transitions_by_group_id.reserve(labels.get_max_size());
 
     int ts1_size = ts1.get_size();
     int ts2_size = ts2.get_size();
@@ -160,12 +265,25 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
       (B) they are both dead in T (e.g., this includes the case where
           l is dead in T1 only and l' is dead in T2 only, so they are not
           locally equivalent in either of the components).
+
+      We first compute the new groups together with the pairs of component
+      groups whose product forms their transitions. This allows us to
+      allocate the transitions of all groups at once.
     */
-    int multiplier = ts2_size;
+    struct ProductGroup {
+        TransitionRange transitions1;
+        TransitionRange transitions2;
+        ProductGroup(TransitionRange transitions1, TransitionRange transitions2)
+            : transitions1(transitions1), transitions2(transitions2) {
+        }
+    };
+    vector<ProductGroup> product_groups;
+    vector<Transition> transitions;
+    size_t num_transitions = 0;
     vector<int> dead_labels;
     for (GroupAndTransitions gat : ts1) {
         const LabelGroup &group1 = gat.label_group;
-        const vector<Transition> &transitions1 = gat.transitions;
+        TransitionRange transitions1 = gat.transitions;
 
         // Distribute the labels of this group among the "buckets"
         // corresponding to the groups of ts2.
@@ -177,41 +295,41 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         // Now buckets contains all equivalence classes that are
         // refinements of group1.
 
-        // Now create the new groups together with their transitions.
+        // Now create the new groups.
         for (auto &bucket : buckets) {
-            const vector<Transition> &transitions2 =
+            TransitionRange transitions2 =
                 ts2.get_transitions_for_group_id(bucket.first);
 
-            // Create the new transitions for this bucket
-            vector<Transition> new_transitions;
-            if (!transitions1.empty() && !transitions2.empty()
-                && transitions1.size() > new_transitions.max_size() / transitions2.size())
-                utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
-            new_transitions.reserve(transitions1.size() * transitions2.size());
-            for (const Transition &transition1 : transitions1) {
-                int src1 = transition1.src;
-                int target1 = transition1.target;
-                for (const Transition &transition2 : transitions2) {
-                    int src2 = transition2.src;
-                    int target2 = transition2.target;
-                    int src = src1 * multiplier + src2;
-                    int target = target1 * multiplier + target2;
-                    new_transitions.push_back(Transition(src, target));
-                }
-            }
-
             // Create a new group if the transitions are not empty
             vector<int> &new_labels = bucket.second;
-            if (new_transitions.empty()) {
+            if (transitions1.empty() || transitions2.empty()) {
                 dead_labels.insert(dead_labels.end(), new_labels.begin(), new_labels.end());
             } else {
-                sort(new_transitions.begin(), new_transitions.end());
+                size_t group_size = transitions1.size();
+                if (group_size > (transitions.max_size() - num_transitions) /
+                    transitions2.size()) {
+                    utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+                }
+                num_transitions += group_size * transitions2.size();
                 label_groups.push_back(move(new_labels));
-                transitions_by_group_id.push_back(move(new_transitions));
+                product_groups.emplace_back(transitions1, transitions2);
             }
         }
     }
 
+    // Create the transitions of the new groups.
+    int multiplier = ts2_size;
+    transitions.reserve(num_transitions);
+    vector<int> group_offsets;
+    group_offsets.reserve(product_groups.size() + 2);
+    group_offsets.push_back(0);
+    for (const ProductGroup &product_group : product_groups) {
+        append_product_transitions(
+            product_group.transitions1, product_group.transitions2,
+            multiplier, transitions);
+        group_offsets.push_back(transitions.size());
+    }
+
     /*
       We collect all dead labels separately, because the bucket refining
       does not work in cases where there are at least two dead labels l1
@@ -222,10 +340,10 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
     if (!dead_labels.empty()) {
         label_groups.push_back(move(dead_labels));
         // Dead labels have empty transitions
-        transitions_by_group_id.emplace_back();
+        group_offsets.push_back(transitions.size());
     }
 
-    assert(transitions_by_group_id.size() == label_groups.size());
+    assert(group_offsets.size() == label_groups.size() + 1);
 
     unique_ptr<LabelEquivalenceRelation> label_equivalence_relation =
         utils::make_unique_ptr<LabelEquivalenceRelation>(labels, label_groups);
@@ -234,7 +352,8 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         num_variables,
         move(incorporated_variables),
         move(label_equivalence_relation),
-        move(transitions_by_group_id),
+        move(transitions),
+        move(group_offsets),
         num_states,
         move(goal_states),
         init_state
@@ -249,20 +368,56 @@ void TransitionSystem::compute_locally_equivalent_labels() {
     for (int group_id1 = 0; group_id1 < label_equivalence_relation->get_size();
          ++group_id1) {
         if (!label_equivalence_relation->is_empty_group(group_id1)) {
-            const vector<Transition> &transitions1 = transitions_by_group_id[group_id1];
+            TransitionRange transitions1 = get_transitions_for_group_id(group_id1);
             for (int group_id2 = group_id1 + 1;
                  group_id2 < label_equivalence_relation->get_size(); ++group_id2) {
                 if (!label_equivalence_relation->is_empty_group(group_id2)) {
-                    vector<Transition> &transitions2 = transitions_by_group_id[group_id2];
-                    if (transitions1 == transitions2) {
+                    TransitionRange transitions2 = get_transitions_for_group_id(group_id2);
+                    if (transitions1.size() == transitions2.size() &&
+                        equal(transitions1.begin(), transitions1.end(),
+                              transitions2.begin())) {
                         label_equivalence_relation->move_group_into_group(
                             group_id2, group_id1);
-                        utils::release_vector_memory(transitions2);
                     }
                 }
             }
         }
     }
+    remove_transitions_of_empty_groups();
+}
+
+void TransitionSystem::remove_transitions_of_empty_groups() {
+    /*
+      Move the transitions of all non-empty groups to the front. This works
+      in place because the transitions only move towards the front.
+    */
+    int num_groups = group_offsets.size() - 1;
+    int new_end = 0;
+    for (int group_id = 0; group_id < num_groups; ++group_id) {
+        int begin = group_offsets[group_id];
+        int end = group_offsets[group_id + 1];
+        group_offsets[group_id] = new_end;
+        if (!label_equivalence_relation->is_empty_group(group_id)) {
+            if (new_end != begin) {
+                copy(transitions.begin() + begin, transitions.begin() + end,
+                     transitions.begin() + new_end);
+            }
+            new_end += end - begin;
+        }
+    }
+    group_offsets[num_groups] = new_end;
+    transitions.erase(transitions.begin() + new_end, transitions.end());
+}
+
+void TransitionSystem::release_unused_transition_memory() {
+    /*
+      Shrinking can remove most transitions of a product. We give back the
+      memory so that it is available for the next merge, but avoid
+      reallocating after small changes.
+    */
+    if (transitions.capacity() > 2 * transitions.size()) {
+        transitions.shrink_to_fit();
+    }
 }
 
 void TransitionSystem::apply_abstraction(
@@ -294,33 +449,34 @@ void TransitionSystem::apply_abstraction(
     }
     goal_states = move(new_goal_states);
 
-    // Update all transitions.
-    for (vector<Transition> &transitions : transitions_by_group_id) {
-        if (!transitions.empty()) {
-            vector<Transition> new_transitions;
-            /*
-              We reserve more memory than necessary here, but this is better
-              than potentially resizing the vector several times when inserting
-              transitions one after the other. See issue604-v6.
-
-              An alternative could be to not use a new vector, but to modify
-              the existing transitions inplace, and to remove all empty
-              positions in the end. This would be more ugly, though.
-            */
-            new_transitions.reserve(transitions.size());
-            for (size_t i = 0; i < transitions.size(); ++i) {
-                const Transition &transition = transitions[i];
-                int src = abstraction_mapping[transition.src];
-                int target = abstraction_mapping[transition.target];
-                if (src != PRUNED_STATE && target != PRUNED_STATE)
-                    new_transitions.push_back(Transition(src, target));
+    /*
+      Update all transitions in place. The transitions of every group only
+      move towards the front, so we can write the updated transitions of
+      each group directly behind those of the previous group.
+    */
+    int num_groups = group_offsets.size() - 1;
+    vector<Transition>::iterator new_end = transitions.begin();
+    for (int group_id = 0; group_id < num_groups; ++group_id) {
+        vector<Transition>::iterator begin = transitions.begin() + group_offsets[group_id];
+        vector<Transition>::iterator end = transitions.begin() + group_offsets[group_id + 1];
+        vector<Transition>::iterator group_begin = new_end;
+        for (vector<Transition>::iterator it = begin; it != end; ++it) {
+            int src = abstraction_mapping[it->src];
+            int target = abstraction_mapping[it->target];
+            if (src != PRUNED_STATE && target != PRUNED_STATE) {
+                new_end->src = src;
+                new_end->target = target;
+                ++new_end;
             }
-            normalize_given_transitions(new_transitions);
-            transitions = move(new_transitions);
         }
+        new_end = normalize_given_transitions(group_begin, new_end);
+        group_offsets[group_id] = group_begin - transitions.begin();
     }
+    group_offsets[num_groups] = new_end - transitions.begin();
+    transitions.erase(new_end, transitions.end());
 
     compute_locally_equivalent_labels();
+    release_unused_transition_memory();
 
     num_states = new_num_states;
     init_state = abstraction_mapping[init_state];
@@ -372,26 +528,33 @@ void TransitionSystem::apply_label_reduction(
           updating label_equivalence_relation, because after updating it,
           we cannot find out the group ID of reduced labels anymore.
         */
-        vector<vector<Transition>> new_transitions;
-        new_transitions.reserve(label_mapping.size());
+        vector<Transition> new_transitions;
+        vector<int> new_group_sizes;
+        new_group_sizes.reserve(label_mapping.size());
         unordered_set<int> affected_group_ids;
         for (const pair<int, vector<int>> &mapping: label_mapping) {
             const vector<int> &old_label_nos = mapping.second;
             assert(old_label_nos.size() >= 2);
             unordered_set<int> seen_group_ids;
-            set<Transition> new_label_transitions;
+            size_t group_begin = new_transitions.size();
             for (int old_label_no : old_label_nos) {
                 int group_id = label_equivalence_relation->get_group_id(old_label_no);
                 if (seen_group_ids.insert(group_id).second) {
                     affected_group_ids.insert(group_id);
-                    const vector<Transition> &transitions = transitions_by_group_id[group_id];
-                    new_label_transitions.insert(transitions.begin(), transitions.end());
+                    TransitionRange group_transitions =
+                        get_transitions_for_group_id(group_id);
+                    new_transitions.insert(
+                        new_transitions.end(), group_transitions.begin(),
+                        group_transitions.end());
                 }
             }
-            new_transitions.emplace_back(
-                new_label_transitions.begin(), new_label_transitions.end());
+            new_transitions.erase(
+                normalize_given_transitions(
+                    new_transitions.begin() + group_begin, new_transitions.end()),
+                new_transitions.end());
+            new_group_sizes.push_back(new_transitions.size() - group_begin);
         }
-        assert(label_mapping.size() == new_transitions.size());
+        assert(label_mapping.size() == new_group_sizes.size());
 
         /*
            Apply all label mappings to label_equivalence_relation. This needs
@@ -402,30 +565,27 @@ void TransitionSystem::apply_label_reduction(
         */
         label_equivalence_relation->apply_label_mapping(label_mapping, &affected_group_ids);
 
+        // Make room for the new transitions.
+        remove_transitions_of_empty_groups();
+
         /*
           Go over the transitions of new labels and add them at the correct
           position.
 
           NOTE: it is important that this happens in increasing order of label
-          numbers to ensure that transitions_by_group_id are synchronized with
+          numbers to ensure that group_offsets are synchronized with
           label groups of label_equivalence_relation.
         */
+        transitions.insert(
+            transitions.end(), new_transitions.begin(), new_transitions.end());
         for (size_t i = 0; i < label_mapping.size(); ++i) {
-            vector<Transition> &transitions = new_transitions[i];
             assert(label_equivalence_relation->get_group_id(label_mapping[i].first)
-                   == static_cast<int>(transitions_by_group_id.size()));
-            transitions_by_group_id.push_back(move(transitions));
-        }
-
-        // Go over all affected group IDs and remove their transitions if the
-        // group is empty.
-        for (int group_id : affected_group_ids) {
-            if (label_equivalence_relation->is_empty_group(group_id)) {
-                utils::release_vector_memory(transitions_by_group_id[group_id]);
-            }
+                   == static_cast<int>(group_offsets.size()) - 1);
+            group_offsets.push_back(group_offsets.back() + new_group_sizes[i]);
         }
 
         compute_locally_equivalent_labels();
+        release_unused_transition_memory();
     }
 
     assert(are_transitions_sorted_unique());
@@ -440,15 +600,19 @@ string TransitionSystem::tag() const {
 
 bool TransitionSystem::are_transitions_sorted_unique() const {
     for (GroupAndTransitions gat : *this) {
-        if (!utils::is_sorted_unique(gat.transitions))
+        if (adjacent_find(gat.transitions.begin(), gat.transitions.end(),
+                          [](const Transition &t1, const Transition &t2) {
+                              return t1 >= t2;
+                          }) != gat.transitions.end())
             return false;
     }
     return true;
 }
 
 bool TransitionSystem::in_sync_with_label_equivalence_relation() const {
-    return label_equivalence_relation->get_size() ==
-           static_cast<int>(transitions_by_group_id.size());
+    return label_equivalence_relation->get_size() + 1 ==
+           static_cast<int>(group_offsets.size()) &&
+           group_offsets.back() == static_cast<int>(transitions.size());
 }
 
 bool TransitionSystem::is_solvable(const Distances &distances) const {
@@ -497,8 +661,7 @@ void TransitionSystem::dump_dot_graph() const {
     }
     for (GroupAndTransitions gat : *this) {
         const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
+        for (const Transition &transition : gat.transitions) {
             int src = transition.src;
             int target = transition.target;
             utils::g_log << "    node" << src << " -> node" << target << " [label = ";
@@ -528,8 +691,8 @@ void TransitionSystem::dump_labels_and_transitions() const {
         }
         utils::g_log << endl;
         utils::g_log << "transitions: ";
-        const vector<Transition> &transitions = gat.transitions;
-        for (size_t i = 0; i < transitions.size(); ++i) {
+        TransitionRange transitions = gat.transitions;
+        for (int i = 0; i < transitions.size(); ++i) {
             int src = transitions[i].src;
             int target = transitions[i].target;
             if (i != 0)
@@ -41,11 +41,44 @@ struct Transition {
     }
 };
 
+/*
+  Read-only view of the transitions of a label group, which are stored
+  consecutively in the transitions of the transition system.
+*/
+class TransitionRange {
+    const Transition *begin_;
+    const Transition *end_;
+public:
+    TransitionRange(const Transition *begin, const Transition *end)
+        : begin_(begin), end_(end) {
+    }
+
+    const Transition *begin() const {
+        return begin_;
+    }
+
+    const Transition *end() const {
+        return end_;
+    }
+
+    const Transition &operator[](int index) const {
+        return begin_[index];
+    }
+
+    int size() const {
+        return end_ - begin_;
+    }
+
+    bool empty() const {
+        return begin_ == end_;
+    }
+};
+
 struct GroupAndTransitions {
     const LabelGroup &label_group;
-    const std::vector<Transition> &transitions;
+    TransitionRange transitions;
     GroupAndTransitions(const LabelGroup &label_group,
-                        const std::vector<Transition> &transitions)
+                        TransitionRange transitions)
         : label_group(label_group),
           transitions(transitions) {
     }
@@ -59,14 +92,16 @@ class TSConstIterator {
       easily exchanged.
     */
     const LabelEquivalenceRelation &label_equivalence_relation;
-    const std::vector<std::vector<Transition>> &transitions_by_group_id;
+    const std::vector<Transition> &transitions;
+    const std::vector<int> &group_offsets;
     // current_group_id is the actual iterator
     int current_group_id;
 
     void next_valid_index();
 public:
     TSConstIterator(const LabelEquivalenceRelation &label_equivalence_relation,
-                    const std::vector<std::vector<Transition>> &transitions_by_group_id,
+                    const std::vector<Transition> &transitions,
+                    const std::vector<int> &group_offsets,
                     bool end);
     void operator++();
     GroupAndTransitions operator*() const;
@@ -104,17 +139,19 @@ private:
     std::unique_ptr<LabelEquivalenceRelation> label_equivalence_relation;
 
     /*
-      The transitions of a label group are indexed via its ID. The ID of a
-      group does not change, and hence its transitions are never moved.
-
-      We tested different alternatives to store the transitions, but they all
-      performed worse: storing a vector transitions in the label group increases
-      memory usage and runtime; storing the transitions more compactly and
-      incrementally increasing the size of transitions_of_groups whenever a
-      new label group is added also increases runtime. See also issue492 and
-      issue521.
+      The transitions of all label groups are stored in a single vector
+      (compressed sparse row format): the transitions of the group with ID
+      i are transitions[group_offsets[i]], ...,
+      transitions[group_offsets[i + 1] - 1]. The ID of a group does not
+      change. Empty groups have no transitions.
+
+      Storing a separate vector for every group ID (see issue492 and
+      issue521 for earlier experiments) needs many small allocations when
+      merging, shrinking and reducing labels. With a single vector, the
+      product is allocated at once and shrinking works in place.
     */
-    std::vector<std::vector<Transition>> transitions_by_group_id;
+    std::vector<Transition> transitions;
+    std::vector<int> group_offsets;
 
     int num_states;
     std::vector<bool> goal_states;
@@ -126,12 +163,17 @@ private:
     */
     void compute_locally_equivalent_labels();
 
-    const std::vector<Transition> &get_transitions_for_group_id(int group_id) const {
-        return transitions_by_group_id[group_id];
+    // Remove the transitions of empty label groups from transitions.
+    void remove_transitions_of_empty_groups();
+    void release_unused_transition_memory();
+
+    TransitionRange get_transitions_for_group_id(int group_id) const {
+        return TransitionRange(
+            transitions.data() + group_offsets[group_id],
+            transitions.data() + group_offsets[group_id + 1]);
     }
 
     // Statistics and output
-    int compute_total_transitions() const;
     std::string get_description() const;
 public:
     TransitionSystem(
@@ -142,6 +184,16 @@ public:
         int num_states,
         std::vector<bool> &&goal_states,
         int init_state);
+    // See the comment on transitions for the meaning of group_offsets.
+    TransitionSystem(
+        int num_variables,
+        std::vector<int> &&incorporated_variables,
+        std::unique_ptr<LabelEquivalenceRelation> &&label_equivalence_relation,
+        std::vector<Transition> &&transitions,
+        std::vector<int> &&group_offsets,
+        int num_states,
+        std::vector<bool> &&goal_states,
+        int init_state);
     TransitionSystem(const TransitionSystem &other);
     ~TransitionSystem();
     /*
@@ -156,6 +208,11 @@ public:
         const TransitionSystem &ts2,
         utils::Verbosity verbosity);
 
+    // Compute the number of transitions of the merge of ts1 and ts2.
+    static size_t compute_product_num_transitions(
+        const TransitionSystem &ts1,
+        const TransitionSystem &ts2);
+
     /*
       Applies the given state equivalence relation to the transition system.
       abstraction_mapping is a mapping from old states to new states, and it
@@ -179,13 +236,15 @@ public:
 
     TSConstIterator begin() const {
         return TSConstIterator(*label_equivalence_relation,
-                               transitions_by_group_id,
+                               transitions,
+                               group_offsets,
                                false);
     }
 
     TSConstIterator end() const {
         return TSConstIterator(*label_equivalence_relation,
-                               transitions_by_group_id,
+                               transitions,
+                               group_offsets,
                                true);
     }
 
@@ -209,6 +268,7 @@ public:
     void dump_dot_graph() const;
     void dump_labels_and_transitions() const;
     void statistics() const;
+    int compute_total_transitions() const;
 
     int get_size() const {
         return num_states;
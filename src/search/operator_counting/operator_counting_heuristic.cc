@@ -32,6 +32,7 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
 }
 
 OperatorCountingHeuristic::~OperatorCountingHeuristic() {
+    lp_solver.print_statistics();
 }
 
 int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -76,6 +76,7 @@ void StateEquationConstraints::initialize_constraints(
     task_properties::verify_no_conditional_effects(task_proxy);
     build_propositions(task_proxy);
     add_constraints(constraints, infinity);
+    last_lp_solver = nullptr;
 
     // Initialize goal state.
     VariablesProxy variables = task_proxy.get_variables();
@@ -85,28 +86,49 @@ void StateEquationConstraints::initialize_constraints(
     }
 }
 
+void StateEquationConstraints::update_lower_bound(
+    int var, int value, int state_value, lp::LPSolver &lp_solver) const {
+    const Proposition &prop = propositions[var][value];
+    if (prop.constraint_index >= 0) {
+        double lower_bound = 0;
+        /* If we consider the current value of var, there must be an
+           additional consumer. */
+        if (state_value == value) {
+            --lower_bound;
+        }
+        /* If we consider the goal value of var, there must be an
+           additional producer. */
+        if (goal_state[var] == value) {
+            ++lower_bound;
+        }
+        lp_solver.set_constraint_lower_bound(
+            prop.constraint_index, lower_bound);
+    }
+}
+
 bool StateEquationConstraints::update_constraints(const State &state,
                                                   lp::LPSolver &lp_solver) {
     // Compute the bounds for the rows in the LP.
-    for (size_t var = 0; var < propositions.size(); ++var) {
-        int num_values = propositions[var].size();
-        for (int value = 0; value < num_values; ++value) {
-            const Proposition &prop = propositions[var][value];
-            // Set row bounds.
-            if (prop.constraint_index >= 0) {
-                double lower_bound = 0;
-                /* If we consider the current value of var, there must be an
-                   additional consumer. */
-                if (state[var].get_value() == value) {
-                    --lower_bound;
-                }
-                /* If we consider the goal value of var, there must be an
-                   additional producer. */
-                if (goal_state[var] == value) {
-                    ++lower_bound;
-                }
-                lp_solver.set_constraint_lower_bound(
-                    prop.constraint_index, lower_bound);
+    int num_variables = propositions.size();
+    if (&lp_solver != last_lp_solver) {
+        last_lp_solver = &lp_solver;
+        last_state_values.resize(num_variables);
+        for (int var = 0; var < num_variables; ++var) {
+            int state_value = state[var].get_value();
+            int num_values = propositions[var].size();
+            for (int value = 0; value < num_values; ++value) {
+                update_lower_bound(var, value, state_value, lp_solver);
+            }
+            last_state_values[var] = state_value;
+        }
+    } else {
+        for (int var = 0; var < num_variables; ++var) {
+            int state_value = state[var].get_value();
+            int last_value = last_state_values[var];
+            if (state_value != last_value) {
+                update_lower_bound(var, last_value, state_value, lp_solver);
+                update_lower_bound(var, state_value, state_value, lp_solver);
+                last_state_values[var] = state_value;
             }
         }
     }
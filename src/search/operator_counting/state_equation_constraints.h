@@ -29,9 +29,20 @@ class StateEquationConstraints : public ConstraintGenerator {
     std::vector<std::vector<Proposition>> propositions;
     // Map goal variables to their goal value and other variables to max int.
     std::vector<int> goal_state;
+    /*
+      Values of the state for which we last updated the constraints of
+      last_lp_solver. The bounds of a constraint only change if the truth
+      value of its fact changes, so we only update constraints for changed
+      variables. The generator may be shared by several heuristics, so we
+      update all constraints whenever the LP solver changes.
+    */
+    std::vector<int> last_state_values;
+    const lp::LPSolver *last_lp_solver = nullptr;
 
     void build_propositions(const TaskProxy &task_proxy);
     void add_constraints(named_vector::NamedVector<lp::LPConstraint> &constraints, double infinity);
+    void update_lower_bound(
+        int var, int value, int state_value, lp::LPSolver &lp_solver) const;
 public:
     virtual void initialize_constraints(const std::shared_ptr<AbstractTask> &task,
                                         named_vector::NamedVector<lp::LPConstraint> &constraints,
@@ -140,6 +140,7 @@ OptionParser::OptionParser(const ParseTree &parse_tree, Registry &registry,
       dry_run_(dry_run),
       help_mode_(help_mode),
       next_unparsed_argument(first_child_of_root(this->parse_tree)) {
+    opts.set_plugin_name(get_root_value());
 }
 
 OptionParser::OptionParser(const string &config, Registry &registry,
@@ -223,4 +224,19 @@ const Predefinitions &OptionParser::get_predefinitions() const {
 const string &OptionParser::get_root_value() const {
     return parse_tree.begin()->value;
 }
+
+string OptionParser::get_resolved_config() const {
+    if (!resolved_config.empty()) {
+        return resolved_config;
+    } else if (valid_keys.empty()) {
+        // The argument has no options, so its value is resolved already.
+        return get_root_value();
+    } else {
+        return opts.get_resolved_config();
+    }
+}
+
+void OptionParser::set_resolved_config(const string &config) {
+    resolved_config = config;
+}
 }
@@ -36,6 +36,8 @@ class OptionParser {
 
     ParseTree::sibling_iterator next_unparsed_argument;
     std::vector<std::string> valid_keys;
+    // Set for arguments that are not parsed with add_option().
+    std::string resolved_config;
 
     std::string get_unparsed_config() const;
 
@@ -106,6 +108,13 @@ public:
     const Predefinitions &get_predefinitions() const;
     const std::string &get_root_value() const;
 
+    /*
+      Return the configuration parsed by this parser with default values
+      filled in and predefined objects replaced by their definitions.
+    */
+    std::string get_resolved_config() const;
+    void set_resolved_config(const std::string &config);
+
     bool dry_run() const;
     bool help_mode() const;
 
@@ -245,8 +254,11 @@ template<typename T>
 inline std::shared_ptr<T> TokenParser<std::shared_ptr<T>>::parse(OptionParser &parser) {
     bool predefined;
     std::shared_ptr<T> result = lookup_in_predefinitions<T>(parser, predefined);
-    if (predefined)
+    if (predefined) {
+        parser.set_resolved_config(
+            parser.get_predefinitions().get_resolved_config(parser.get_root_value()));
         return result;
+    }
     return lookup_in_registry<T>(parser);
 }
 
@@ -262,6 +274,7 @@ inline std::vector<T> TokenParser<std::vector<T>>::parse(OptionParser &parser) {
         parser.error("expected list");
     }
     std::vector<T> results;
+    std::string resolved_config = "[";
     for (auto tree_it = first_child_of_root(*parser.get_parse_tree());
          tree_it != end_of_roots_children(*parser.get_parse_tree());
          ++tree_it) {
@@ -269,7 +282,11 @@ inline std::vector<T> TokenParser<std::vector<T>>::parse(OptionParser &parser) {
                                parser.get_registry(), parser.get_predefinitions(),
                                parser.dry_run());
         results.push_back(TokenParser<T>::parse(subparser));
+        if (results.size() > 1)
+            resolved_config += ", ";
+        resolved_config += subparser.get_resolved_config();
     }
+    parser.set_resolved_config(resolved_config + "]");
     return results;
 }
 
@@ -345,6 +362,7 @@ void OptionParser::add_option(
     T result = TokenParser<T>::parse(*subparser);
     check_bounds<T>(key, result, bounds);
     opts.set<T>(key, result);
+    opts.set_resolved_config(key, subparser->get_resolved_config());
     /* If we have not reached the keyword parameters yet and have not used the
        default value, increment the argument position pointer. */
     if (!use_default && arg->key.empty()) {
@@ -401,6 +419,7 @@ void OptionParser::add_enum_option(
             error("invalid enum argument " + value + " for option " + key);
         }
         opts.set<T>(key, static_cast<T>(choice));
+        opts.set_resolved_config(key, names[choice]);
     } else {
         // ... otherwise map the string to its position in the enumeration vector.
         auto it = find_if(names.begin(), names.end(),
@@ -418,6 +437,7 @@ void OptionParser::add_enum_option(
             error("invalid enum argument " + value + " for option " + key);
         }
         opts.set<T>(key, static_cast<T>(it - names.begin()));
+        opts.set_resolved_config(key, *it);
     }
 }
 
@@ -446,7 +466,8 @@ void predefine_plugin(const std::string &arg, Registry &registry,
     utils::strip(value);
 
     OptionParser parser(value, registry, predefinitions, dry_run);
-    predefinitions.predefine(key, parser.start_parsing<std::shared_ptr<T>>());
+    std::shared_ptr<T> object = parser.start_parsing<std::shared_ptr<T>>();
+    predefinitions.predefine(key, object, parser.get_resolved_config());
 }
 }
 
@@ -19,4 +19,26 @@ const string &Options::get_unparsed_config() const {
 void Options::set_unparsed_config(const string &config) {
     unparsed_config = config;
 }
+
+void Options::set_plugin_name(const string &name) {
+    plugin_name = name;
+}
+
+void Options::set_resolved_config(const string &key, const string &config) {
+    resolved_configs[key] = config;
+}
+
+string Options::get_resolved_config(const string &ignored_key) const {
+    string config = plugin_name + "(";
+    bool first = true;
+    for (const auto &key_and_config : resolved_configs) {
+        if (key_and_config.first == ignored_key)
+            continue;
+        if (!first)
+            config += ", ";
+        config += key_and_config.first + " = " + key_and_config.second;
+        first = false;
+    }
+    return config + ")";
+}
 }
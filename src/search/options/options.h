@@ -7,6 +7,7 @@
 
 #include "../utils/system.h"
 
+#include <map>
 #include <string>
 #include <typeinfo>
 #include <unordered_map>
@@ -16,6 +17,13 @@ namespace options {
 class Options {
     std::unordered_map<std::string, Any> storage;
     std::string unparsed_config;
+    std::string plugin_name;
+    /*
+      Configuration of each option with default values filled in and
+      predefined objects replaced by their definitions (see
+      OptionParser::get_resolved_config()).
+    */
+    std::map<std::string, std::string> resolved_configs;
     const bool help_mode;
 
 public:
@@ -70,6 +78,16 @@ public:
     bool contains(const std::string &key) const;
     const std::string &get_unparsed_config() const;
     void set_unparsed_config(const std::string &config);
+
+    void set_plugin_name(const std::string &name);
+    void set_resolved_config(const std::string &key, const std::string &config);
+    /*
+      Return the configuration of the plugin with all options resolved,
+      except for the given key. Two configurations have the same resolved
+      configuration iff they have the same options, no matter if they use
+      predefinitions or default values.
+    */
+    std::string get_resolved_config(const std::string &ignored_key = "") const;
 };
 }
 
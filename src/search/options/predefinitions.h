@@ -15,15 +15,19 @@
 namespace options {
 class Predefinitions {
     std::unordered_map<std::string, std::pair<std::type_index, Any>> predefined;
+    // Resolved configuration of each predefined object.
+    std::unordered_map<std::string, std::string> resolved_configs;
 public:
     Predefinitions() = default;
 
     template<typename T>
-    void predefine(const std::string &key, T object) {
+    void predefine(const std::string &key, T object,
+                   const std::string &resolved_config) {
         if (predefined.count(key)) {
             throw OptionParserError(key + " is already used in a predefinition.");
         }
         predefined.emplace(key, std::make_pair(std::type_index(typeid(T)), object));
+        resolved_configs.emplace(key, resolved_config);
     }
 
     bool contains(const std::string &key) const {
@@ -45,6 +49,10 @@ public:
     T get(const std::string &key, const T &default_value) const {
         return (!contains(key)) ? default_value : get<T>(key);
     }
+
+    const std::string &get_resolved_config(const std::string &key) const {
+        return resolved_configs.at(key);
+    }
 };
 }
 
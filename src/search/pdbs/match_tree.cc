@@ -9,6 +9,8 @@
 using namespace std;
 
 namespace pdbs {
+static const int NO_NODE = 0;
+
 struct MatchTree::Node {
     static const int LEAF_NODE = -1;
     Node();
@@ -129,87 +131,147 @@ void MatchTree::insert_recursive(
 }
 
 void MatchTree::insert(int op_id, const vector<FactPair> &regression_preconditions) {
+    assert(nodes.empty());
     insert_recursive(op_id, regression_preconditions, 0, &root);
 }
 
-void MatchTree::get_applicable_operator_ids_recursive(
-    Node *node, const size_t state_index, vector<int> &operator_ids) const {
-    /*
-      Note: different from the code that builds the match tree, we do
-      the test if node == 0 *before* calling traverse rather than *at
-      the start* of traverse since this turned out to be faster in
-      some informal experiments.
-     */
-
-    operator_ids.insert(operator_ids.end(),
-                        node->applicable_operator_ids.begin(),
-                        node->applicable_operator_ids.end());
-
+int MatchTree::compile_recursive(const Node *node) {
+    int offset = nodes.size();
+    nodes.push_back(node->var_id);
+    nodes.push_back(node->applicable_operator_ids.size());
+    nodes.insert(nodes.end(),
+                 node->applicable_operator_ids.begin(),
+                 node->applicable_operator_ids.end());
     if (node->is_leaf_node())
-        return;
+        return offset;
 
-    int temp = state_index / hash_multipliers[node->var_id];
-    int val = temp % node->var_domain_size;
+    nodes.push_back(node->var_domain_size);
+    int star_successor_pos = nodes.size();
+    nodes.push_back(NO_NODE);
+    int successors_pos = nodes.size();
+    nodes.resize(nodes.size() + node->var_domain_size, NO_NODE);
 
-    if (node->successors[val]) {
-        // Follow the correct successor edge, if it exists.
-        get_applicable_operator_ids_recursive(
-            node->successors[val], state_index, operator_ids);
+    /*
+      Children are laid out in the order in which they are visited by
+      get_applicable_operator_ids, i.e., value successors before the star
+      successor. Note that we must not keep references into nodes across the
+      recursive calls because they may reallocate the vector.
+    */
+    for (int val = 0; val < node->var_domain_size; ++val) {
+        if (node->successors[val]) {
+            int child = compile_recursive(node->successors[val]);
+            nodes[successors_pos + val] = child;
+        }
     }
     if (node->star_successor) {
-        // Always follow the star edge, if it exists.
-        get_applicable_operator_ids_recursive(
-            node->star_successor, state_index, operator_ids);
+        int child = compile_recursive(node->star_successor);
+        nodes[star_successor_pos] = child;
     }
+    return offset;
 }
 
-void MatchTree::get_applicable_operator_ids(
-    size_t state_index, vector<int> &operator_ids) const {
-    if (root)
-        get_applicable_operator_ids_recursive(root, state_index, operator_ids);
+void MatchTree::finalize() {
+    assert(nodes.empty());
+    if (root) {
+        compile_recursive(root);
+        nodes.shrink_to_fit();
+        delete root;
+        root = nullptr;
+    }
+    open_nodes.reserve(pattern.size() + 1);
 }
 
-void MatchTree::dump_recursive(Node *node) const {
-    if (!node) {
-        // Node is the root node.
-        utils::g_log << "Empty MatchTree" << endl;
+void MatchTree::get_applicable_operator_ids(
+    size_t state_index, vector<int> &operator_ids) const {
+    assert(!root);
+    if (nodes.empty())
         return;
+
+    /*
+      We descend along the value successors and postpone the star successors
+      on a stack. This visits the nodes in the same order as a recursive
+      depth-first traversal that follows the value successor before the star
+      successor.
+    */
+    assert(open_nodes.empty());
+    open_nodes.push_back(0);
+    const int *data = nodes.data();
+    while (!open_nodes.empty()) {
+        int node = open_nodes.back();
+        open_nodes.pop_back();
+        while (true) {
+            const int *node_data = data + node;
+            int var_id = node_data[0];
+            int num_operators = node_data[1];
+            const int *operators_begin = node_data + 2;
+            operator_ids.insert(operator_ids.end(),
+                                operators_begin,
+                                operators_begin + num_operators);
+
+            if (var_id == Node::LEAF_NODE)
+                break;
+
+            const int *edges = operators_begin + num_operators;
+            int var_domain_size = edges[0];
+            int star_successor = edges[1];
+            int val = (state_index / hash_multipliers[var_id]) % var_domain_size;
+            int successor = edges[2 + val];
+            if (star_successor != NO_NODE) {
+                // Always follow the star edge, if it exists.
+                open_nodes.push_back(star_successor);
+            }
+            if (successor == NO_NODE)
+                break;
+            // Follow the correct successor edge, if it exists.
+            node = successor;
+        }
     }
+}
+
+void MatchTree::dump_recursive(int node) const {
     utils::g_log << endl;
-    utils::g_log << "node->var_id = " << node->var_id << endl;
+    int var_id = nodes[node];
+    int num_operators = nodes[node + 1];
+    utils::g_log << "node->var_id = " << var_id << endl;
     utils::g_log << "Number of applicable operators at this node: "
-                 << node->applicable_operator_ids.size() << endl;
-    for (int op_id : node->applicable_operator_ids) {
-        utils::g_log << "AbstractOperator #" << op_id << endl;
+                 << num_operators << endl;
+    for (int i = 0; i < num_operators; ++i) {
+        utils::g_log << "AbstractOperator #" << nodes[node + 2 + i] << endl;
     }
-    if (node->is_leaf_node()) {
+    if (var_id == Node::LEAF_NODE) {
         utils::g_log << "leaf node." << endl;
-        assert(!node->successors);
-        assert(!node->star_successor);
-    } else {
-        for (int val = 0; val < node->var_domain_size; ++val) {
-            if (node->successors[val]) {
-                utils::g_log << "recursive call for child with value " << val << endl;
-                dump_recursive(node->successors[val]);
-                utils::g_log << "back from recursive call (for successors[" << val
-                             << "]) to node with var_id = " << node->var_id
-                             << endl;
-            } else {
-                utils::g_log << "no child for value " << val << endl;
-            }
-        }
-        if (node->star_successor) {
-            utils::g_log << "recursive call for star_successor" << endl;
-            dump_recursive(node->star_successor);
-            utils::g_log << "back from recursive call (for star_successor) "
-                         << "to node with var_id = " << node->var_id << endl;
+        return;
+    }
+    int edges = node + 2 + num_operators;
+    int var_domain_size = nodes[edges];
+    int star_successor = nodes[edges + 1];
+    for (int val = 0; val < var_domain_size; ++val) {
+        int successor = nodes[edges + 2 + val];
+        if (successor != NO_NODE) {
+            utils::g_log << "recursive call for child with value " << val << endl;
+            dump_recursive(successor);
+            utils::g_log << "back from recursive call (for successors[" << val
+                         << "]) to node with var_id = " << var_id
+                         << endl;
         } else {
-            utils::g_log << "no star_successor" << endl;
+            utils::g_log << "no child for value " << val << endl;
         }
     }
+    if (star_successor != NO_NODE) {
+        utils::g_log << "recursive call for star_successor" << endl;
+        dump_recursive(star_successor);
+        utils::g_log << "back from recursive call (for star_successor) "
+                     << "to node with var_id = " << var_id << endl;
+    } else {
+        utils::g_log << "no star_successor" << endl;
+    }
 }
 
 void MatchTree::dump() const {
-    dump_recursive(root);
+    if (nodes.empty()) {
+        utils::g_log << "Empty MatchTree" << endl;
+        return;
+    }
+    dump_recursive(0);
 }
 }
@@ -12,6 +12,24 @@ namespace pdbs {
 /*
   Successor Generator for abstract operators.
 
+  The tree is built in two phases. First, all abstract operators are
+  inserted with insert(), which grows a pointer-based tree. Then, finalize()
+  compiles this tree into a single contiguous array in depth-first order and
+  releases the pointer-based tree. Only the compiled tree can be queried.
+
+  In the compiled tree, each node occupies a consecutive block of integers:
+
+    var_id, number of operators k, operator IDs (k entries),
+
+  followed, for inner nodes only, by
+
+    var_domain_size d, offset of star successor, offsets of successors
+    for values 0, ..., d - 1 (d entries).
+
+  Leaf nodes have var_id == LEAF_NODE. Since the root is stored at offset 0
+  and is never the successor of another node, offset 0 (NO_NODE) marks a
+  missing successor.
+
   NOTE: MatchTree keeps a reference to the task proxy passed to the constructor.
   Therefore, users of the class must ensure that the task lives at least as long
   as the match tree.
@@ -23,14 +41,22 @@ class MatchTree {
     // See PatternDatabase for documentation on pattern and hash_multipliers.
     Pattern pattern;
     std::vector<size_t> hash_multipliers;
+    // Pointer-based tree used during construction.
     Node *root;
+    // Compiled tree (see above).
+    std::vector<int> nodes;
+    /*
+      Offsets of star successors that still have to be visited during
+      traversal. Kept as a member to avoid reallocating it for every query.
+    */
+    mutable std::vector<int> open_nodes;
+
     void insert_recursive(int op_id,
                           const std::vector<FactPair> &regression_preconditions,
                           int pre_index,
                           Node **edge_from_parent);
-    void get_applicable_operator_ids_recursive(
-        Node *node, size_t state_index, std::vector<int> &operator_ids) const;
-    void dump_recursive(Node *node) const;
+    int compile_recursive(const Node *node);
+    void dump_recursive(int node) const;
 public:
     // Initialize an empty match tree.
     MatchTree(const TaskProxy &task_proxy,
@@ -38,9 +64,15 @@ public:
               const std::vector<size_t> &hash_multipliers);
     ~MatchTree();
     /* Insert an abstract operator into the match tree, creating or
-       enlarging it. */
+       enlarging it. Must not be called after finalize(). */
     void insert(int op_id, const std::vector<FactPair> &regression_preconditions);
 
+    /*
+      Compile the inserted operators into the flat representation used for
+      queries. Must be called exactly once after all insertions.
+    */
+    void finalize();
+
     /*
       Extracts all IDs of applicable abstract operators for the abstract state
       given by state_index (the index is converted back to variable/values
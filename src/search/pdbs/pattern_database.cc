@@ -2,7 +2,7 @@
 
 #include "match_tree.h"
 
-#include "../algorithms/priority_queues.h"
+#include "../algorithms/monotone_priority_queues.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
@@ -214,6 +214,7 @@ void PatternDatabase::create_pdb(
         const AbstractOperator &op = operators[op_id];
         match_tree.insert(op_id, op.get_regression_preconditions());
     }
+    match_tree.finalize();
 
     // compute abstract goal var-val pairs
     vector<FactPair> abstract_goals;
@@ -225,9 +226,14 @@ void PatternDatabase::create_pdb(
         }
     }
 
+    int max_cost = 0;
+    for (const AbstractOperator &op : operators) {
+        max_cost = max(max_cost, op.get_cost());
+    }
+
     distances.reserve(num_states);
     // first implicit entry: priority, second entry: index for an abstract state
-    priority_queues::AdaptiveQueue<size_t> pq;
+    priority_queues::MonotoneQueue<size_t> pq(max_cost);
 
     // initialize queue
     for (size_t state_index = 0; state_index < num_states; ++state_index) {
@@ -240,6 +246,7 @@ void PatternDatabase::create_pdb(
     }
 
     // Dijkstra loop
+    vector<int> applicable_operator_ids;
     while (!pq.empty()) {
         pair<int, size_t> node = pq.pop();
         int distance = node.first;
@@ -249,7 +256,7 @@ void PatternDatabase::create_pdb(
         }
 
         // regress abstract_state
-        vector<int> applicable_operator_ids;
+        applicable_operator_ids.clear();
         match_tree.get_applicable_operator_ids(state_index, applicable_operator_ids);
         for (int op_id : applicable_operator_ids) {
             const AbstractOperator &op = operators[op_id];
@@ -8,6 +8,7 @@
 #include "../plugin.h"
 
 #include "../utils/logging.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -18,7 +19,8 @@ using namespace std;
 
 namespace potentials {
 DiversePotentialHeuristics::DiversePotentialHeuristics(const Options &opts)
-    : optimizer(opts),
+    : num_threads(opts.get<int>("num_threads")),
+      optimizers(create_optimizers(opts, num_threads)),
       max_num_heuristics(opts.get<int>("max_num_heuristics")),
       num_samples(opts.get<int>("num_samples")),
       rng(utils::parse_rng_from_options(opts)) {
@@ -28,21 +30,35 @@ SamplesToFunctionsMap
 DiversePotentialHeuristics::filter_samples_and_compute_functions(
     const vector<State> &samples) {
     utils::Timer filtering_timer;
-    utils::HashSet<State> dead_ends;
-    int num_duplicates = 0;
-    int num_dead_ends = 0;
-    SamplesToFunctionsMap samples_to_functions;
+    utils::HashSet<State> unique_samples_set;
+    vector<State> unique_samples;
     for (const State &sample : samples) {
         // Skipping duplicates is not necessary, but saves LP evaluations.
-        if (samples_to_functions.count(sample) || dead_ends.count(sample)) {
-            ++num_duplicates;
-            continue;
+        if (unique_samples_set.insert(sample).second) {
+            unique_samples.push_back(sample);
         }
-        optimizer.optimize_for_state(sample);
-        if (optimizer.has_optimal_solution()) {
-            samples_to_functions[sample] = optimizer.get_potential_function();
+    }
+    int num_unique_samples = unique_samples.size();
+    int num_duplicates = samples.size() - num_unique_samples;
+
+    // Dead ends get no function.
+    vector<unique_ptr<PotentialFunction>> functions(num_unique_samples);
+    utils::process_jobs_in_parallel(
+        num_unique_samples, num_threads,
+        [&](int thread_id, int job) {
+            PotentialOptimizer &optimizer = *optimizers[thread_id];
+            optimizer.optimize_for_state(unique_samples[job]);
+            if (optimizer.has_optimal_solution()) {
+                functions[job] = optimizer.get_potential_function();
+            }
+        });
+
+    int num_dead_ends = 0;
+    SamplesToFunctionsMap samples_to_functions;
+    for (int i = 0; i < num_unique_samples; ++i) {
+        if (functions[i]) {
+            samples_to_functions[unique_samples[i]] = move(functions[i]);
         } else {
-            dead_ends.insert(sample);
             ++num_dead_ends;
         }
     }
@@ -81,6 +97,7 @@ DiversePotentialHeuristics::find_function_and_remove_covered_samples(
         const State &state = sample_and_function.first;
         uncovered_samples.push_back(state);
     }
+    PotentialOptimizer &optimizer = *optimizers[0];
     optimizer.optimize_for_samples(uncovered_samples);
     unique_ptr<PotentialFunction> function = optimizer.get_potential_function();
     size_t last_num_samples = samples_to_functions.size();
@@ -118,7 +135,7 @@ DiversePotentialHeuristics::find_functions() {
 
     // Sample states.
     vector<State> samples = sample_without_dead_end_detection(
-        optimizer, num_samples, *rng);
+        *optimizers[0], num_samples, *rng, num_threads);
 
     // Filter dead end samples.
     SamplesToFunctionsMap samples_to_functions =
@@ -148,13 +165,18 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "infinity",
         Bounds("0", "infinity"));
     prepare_parser_for_admissible_potentials(parser);
+    prepare_parser_for_multiple_potential_functions(parser);
     utils::add_rng_options(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
         return nullptr;
 
-    DiversePotentialHeuristics factory(opts);
-    return make_shared<PotentialMaxHeuristic>(opts, factory.find_functions());
+    return make_shared<PotentialMaxHeuristic>(
+        opts, get_cached_potential_functions(
+            opts, [&]() {
+                DiversePotentialHeuristics factory(opts);
+                return factory.find_functions();
+            }));
 }
 
 static Plugin<Evaluator> _plugin(
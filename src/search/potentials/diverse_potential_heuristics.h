@@ -19,7 +19,9 @@ using SamplesToFunctionsMap =
   Factory class that finds diverse potential functions.
 */
 class DiversePotentialHeuristics {
-    PotentialOptimizer optimizer;
+    const int num_threads;
+    // One optimizer per thread. We cover samples with the first one.
+    std::vector<std::unique_ptr<PotentialOptimizer>> optimizers;
     // TODO: Remove max_num_heuristics and control number of heuristics
     // with num_samples parameter?
     const int max_num_heuristics;
@@ -28,7 +30,7 @@ class DiversePotentialHeuristics {
     std::vector<std::unique_ptr<PotentialFunction>> diverse_functions;
 
     /* Filter dead end samples and duplicates. Store potential heuristics
-       for remaining samples. */
+       for remaining samples, which we compute in parallel. */
     SamplesToFunctionsMap filter_samples_and_compute_functions(
         const std::vector<State> &samples);
 
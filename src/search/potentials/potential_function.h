@@ -21,6 +21,10 @@ public:
     ~PotentialFunction() = default;
 
     int get_value(const State &state) const;
+
+    const std::vector<std::vector<double>> &get_fact_potentials() const {
+        return fact_potentials;
+    }
 };
 }
 
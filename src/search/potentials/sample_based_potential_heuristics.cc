@@ -6,6 +6,7 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
@@ -15,42 +16,57 @@
 using namespace std;
 
 namespace potentials {
-static void filter_dead_ends(PotentialOptimizer &optimizer, vector<State> &samples) {
-    assert(!optimizer.potentials_are_bounded());
-    vector<State> non_dead_end_samples;
-    for (const State &sample : samples) {
-        optimizer.optimize_for_state(sample);
-        if (optimizer.has_optimal_solution())
-            non_dead_end_samples.push_back(sample);
-    }
-    swap(samples, non_dead_end_samples);
-}
-
-static void optimize_for_samples(
-    PotentialOptimizer &optimizer,
-    int num_samples,
-    utils::RandomNumberGenerator &rng) {
-    vector<State> samples = sample_without_dead_end_detection(
-        optimizer, num_samples, rng);
-    if (!optimizer.potentials_are_bounded()) {
-        filter_dead_ends(optimizer, samples);
-    }
-    optimizer.optimize_for_samples(samples);
-}
-
 /*
   Compute multiple potential functions that are optimized for different
-  sets of samples.
+  sets of samples. We draw all samples first. Then we solve the LPs that
+  detect dead ends and the LPs for the sample sets in parallel.
 */
-static vector<unique_ptr<PotentialFunction>> create_sample_based_potential_functions(
+static PotentialFunctions create_sample_based_potential_functions(
     const Options &opts) {
-    vector<unique_ptr<PotentialFunction>> functions;
-    PotentialOptimizer optimizer(opts);
+    int num_heuristics = opts.get<int>("num_heuristics");
+    int num_samples = opts.get<int>("num_samples");
+    int num_threads = opts.get<int>("num_threads");
+    vector<unique_ptr<PotentialOptimizer>> optimizers =
+        create_optimizers(opts, num_threads);
     shared_ptr<utils::RandomNumberGenerator> rng(utils::parse_rng_from_options(opts));
-    for (int i = 0; i < opts.get<int>("num_heuristics"); ++i) {
-        optimize_for_samples(optimizer, opts.get<int>("num_samples"), *rng);
-        functions.push_back(optimizer.get_potential_function());
+    vector<vector<State>> samples_by_heuristic;
+    for (int i = 0; i < num_heuristics; ++i) {
+        samples_by_heuristic.push_back(sample_without_dead_end_detection(
+                                           *optimizers[0], num_samples, *rng, num_threads));
+    }
+
+    if (!optimizers[0]->potentials_are_bounded()) {
+        /*
+          Remove dead ends, for which the LP is unbounded. We don't use
+          vector<bool> since threads write to it concurrently.
+        */
+        vector<char> is_dead_end(num_heuristics * num_samples);
+        utils::process_jobs_in_parallel(
+            num_heuristics * num_samples, num_threads,
+            [&](int thread_id, int job) {
+                PotentialOptimizer &optimizer = *optimizers[thread_id];
+                optimizer.optimize_for_state(
+                    samples_by_heuristic[job / num_samples][job % num_samples]);
+                is_dead_end[job] = !optimizer.has_optimal_solution();
+            });
+        for (int i = 0; i < num_heuristics; ++i) {
+            vector<State> non_dead_end_samples;
+            for (int j = 0; j < num_samples; ++j) {
+                if (!is_dead_end[i * num_samples + j])
+                    non_dead_end_samples.push_back(samples_by_heuristic[i][j]);
+            }
+            swap(samples_by_heuristic[i], non_dead_end_samples);
+        }
     }
+
+    PotentialFunctions functions(num_heuristics);
+    utils::process_jobs_in_parallel(
+        num_heuristics, num_threads,
+        [&](int thread_id, int heuristic) {
+            PotentialOptimizer &optimizer = *optimizers[thread_id];
+            optimizer.optimize_for_samples(samples_by_heuristic[heuristic]);
+            functions[heuristic] = optimizer.get_potential_function();
+        });
     return functions;
 }
 
@@ -70,13 +86,17 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "1000",
         Bounds("0", "infinity"));
     prepare_parser_for_admissible_potentials(parser);
+    prepare_parser_for_multiple_potential_functions(parser);
     utils::add_rng_options(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
         return nullptr;
 
     return make_shared<PotentialMaxHeuristic>(
-        opts, create_sample_based_potential_functions(opts));
+        opts, get_cached_potential_functions(
+            opts, [&]() {
+                return create_sample_based_potential_functions(opts);
+            }));
 }
 
 static Plugin<Evaluator> _plugin(
@@ -7,31 +7,172 @@
 #include "../option_parser.h"
 
 #include "../task_utils/sampling.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/cache_file.h"
+#include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/memory.h"
+#include "../utils/memory_mapped_file.h"
+#include "../utils/parallel.h"
+#include "../utils/rng.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <limits>
+#include <ostream>
 
 using namespace std;
 
 namespace potentials {
+/*
+  The payload of a cache file is the number of functions as an int,
+  followed by the fact potentials of each function as doubles in native
+  byte order, ordered by variable and value.
+*/
+static const int CACHE_FILE_MAGIC = 0x504f5446;
+static const int CACHE_FILE_VERSION = 2;
+
+vector<unique_ptr<PotentialOptimizer>> create_optimizers(
+    const Options &opts, int num_threads) {
+    vector<unique_ptr<PotentialOptimizer>> optimizers;
+    for (int i = 0; i < num_threads; ++i) {
+        optimizers.push_back(utils::make_unique_ptr<PotentialOptimizer>(opts));
+    }
+    return optimizers;
+}
+
 vector<State> sample_without_dead_end_detection(
     PotentialOptimizer &optimizer,
     int num_samples,
-    utils::RandomNumberGenerator &rng) {
+    utils::RandomNumberGenerator &rng,
+    int num_threads) {
     const shared_ptr<AbstractTask> task = optimizer.get_task();
     const TaskProxy task_proxy(*task);
     State initial_state = task_proxy.get_initial_state();
     optimizer.optimize_for_state(initial_state);
     int init_h = optimizer.get_potential_function()->get_value(initial_state);
-    sampling::RandomWalkSampler sampler(task_proxy, rng);
+
+    vector<int> seeds;
+    seeds.reserve(num_samples);
+    for (int i = 0; i < num_samples; ++i) {
+        seeds.push_back(rng(numeric_limits<int>::max()));
+    }
+
+    /*
+      Each thread gets its own generator and sampler, which we create up
+      front because creating a successor generator is not thread-safe. The
+      jobs are consecutive blocks of samples.
+    */
+    int num_jobs = max(1, min(num_threads, num_samples));
+    vector<unique_ptr<utils::RandomNumberGenerator>> rngs;
+    vector<unique_ptr<sampling::RandomWalkSampler>> samplers;
+    for (int i = 0; i < num_jobs; ++i) {
+        rngs.push_back(utils::make_unique_ptr<utils::RandomNumberGenerator>());
+        samplers.push_back(utils::make_unique_ptr<sampling::RandomWalkSampler>(
+                               task_proxy, *rngs.back()));
+    }
+    vector<vector<State>> samples_by_job(num_jobs);
+    utils::process_jobs_in_parallel(
+        num_jobs, num_threads,
+        [&](int thread_id, int job) {
+            int begin = static_cast<long long>(num_samples) * job / num_jobs;
+            int end = static_cast<long long>(num_samples) * (job + 1) / num_jobs;
+            for (int i = begin; i < end; ++i) {
+                rngs[thread_id]->seed(seeds[i]);
+                samples_by_job[job].push_back(
+                    samplers[thread_id]->sample_state(init_h));
+            }
+        });
+
     vector<State> samples;
     samples.reserve(num_samples);
-    for (int i = 0; i < num_samples; ++i) {
-        samples.push_back(sampler.sample_state(init_h));
+    for (vector<State> &job_samples : samples_by_job) {
+        move(job_samples.begin(), job_samples.end(), back_inserter(samples));
     }
     return samples;
 }
 
+static bool read_cache_file(
+    const utils::CacheFile &cache_file, const TaskProxy &task_proxy,
+    PotentialFunctions &functions) {
+    assert(functions.empty());
+    size_t num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        num_facts += var.get_domain_size();
+    }
+    auto read_functions = [&](const char *payload, size_t num_bytes) {
+            const size_t header_bytes = sizeof(int);
+            int num_functions;
+            if (num_bytes < header_bytes) {
+                return false;
+            }
+            memcpy(&num_functions, payload, sizeof(int));
+            if (num_functions < 0 ||
+                num_bytes != header_bytes + num_functions * num_facts * sizeof(double)) {
+                return false;
+            }
+            const char *pos = payload + header_bytes;
+            for (int i = 0; i < num_functions; ++i) {
+                vector<vector<double>> fact_potentials;
+                for (VariableProxy var : task_proxy.get_variables()) {
+                    vector<double> potentials(var.get_domain_size());
+                    size_t potentials_bytes = potentials.size() * sizeof(double);
+                    memcpy(potentials.data(), pos, potentials_bytes);
+                    pos += potentials_bytes;
+                    fact_potentials.push_back(move(potentials));
+                }
+                functions.push_back(
+                    utils::make_unique_ptr<PotentialFunction>(fact_potentials));
+            }
+            return true;
+        };
+    if (!cache_file.read(read_functions)) {
+        functions.clear();
+        return false;
+    }
+    utils::g_log << "Read " << functions.size()
+                 << " potential functions from cache file "
+                 << cache_file.get_filename() << "." << endl;
+    return true;
+}
+
+static void write_cache_file(
+    const utils::CacheFile &cache_file, const PotentialFunctions &functions) {
+    auto write_functions = [&](ostream &file) {
+            int num_functions = functions.size();
+            file.write(reinterpret_cast<const char *>(&num_functions), sizeof(int));
+            for (const unique_ptr<PotentialFunction> &function : functions) {
+                for (const vector<double> &potentials : function->get_fact_potentials()) {
+                    file.write(reinterpret_cast<const char *>(potentials.data()),
+                               potentials.size() * sizeof(double));
+                }
+            }
+        };
+    if (cache_file.write(write_functions)) {
+        utils::g_log << "Wrote potential functions to cache file "
+                     << cache_file.get_filename() << "." << endl;
+    }
+}
+
+PotentialFunctions get_cached_potential_functions(
+    const Options &opts,
+    const function<PotentialFunctions()> &compute_functions) {
+    TaskProxy task_proxy(*opts.get<shared_ptr<AbstractTask>>("transform"));
+    unique_ptr<utils::CacheFile> cache_file = utils::parse_cache_file_from_options(
+        opts, "potentials", task_properties::compute_task_fingerprint(task_proxy),
+        CACHE_FILE_MAGIC, CACHE_FILE_VERSION);
+    if (!cache_file) {
+        return compute_functions();
+    }
+    PotentialFunctions functions;
+    if (!read_cache_file(*cache_file, task_proxy, functions)) {
+        functions = compute_functions();
+        write_cache_file(*cache_file, functions);
+    }
+    return functions;
+}
+
 string get_admissible_potentials_reference() {
     return "The algorithm is based on" + utils::format_conference_reference(
         {"Jendrik Seipp", "Florian Pommerening", "Malte Helmert"},
@@ -65,4 +206,24 @@ void prepare_parser_for_admissible_potentials(OptionParser &parser) {
     lp::add_lp_solver_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 }
+
+void prepare_parser_for_multiple_potential_functions(OptionParser &parser) {
+    parser.document_note(
+        "Note",
+        "With the option cache_dir, the potential functions are read from "
+        "a cache file in the given directory if they were computed before "
+        "for the same (possibly cost-transformed) task and the same options, "
+        "which is checked with a fingerprint of the task and a hash of the "
+        "options. Otherwise, they are computed and written to a new cache "
+        "file.");
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for sampling states and solving LPs. Each thread "
+        "uses its own LP solver. The samples do not depend on the number of "
+        "threads, but LPs with multiple optimal solutions may yield "
+        "different potential functions.",
+        "1",
+        Bounds("1", "infinity"));
+    utils::add_cache_dir_option_to_parser(parser);
+}
 }
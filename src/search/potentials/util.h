@@ -1,6 +1,7 @@
 #ifndef POTENTIALS_UTIL_H
 #define POTENTIALS_UTIL_H
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -9,6 +10,7 @@ class State;
 
 namespace options {
 class OptionParser;
+class Options;
 }
 
 namespace utils {
@@ -16,15 +18,40 @@ class RandomNumberGenerator;
 }
 
 namespace potentials {
+class PotentialFunction;
 class PotentialOptimizer;
 
+using PotentialFunctions = std::vector<std::unique_ptr<PotentialFunction>>;
+
+// Create one optimizer with its own LP solver for each thread.
+std::vector<std::unique_ptr<PotentialOptimizer>> create_optimizers(
+    const options::Options &opts, int num_threads);
+
+/*
+  Sample states with random walks on up to num_threads threads. Each
+  sample uses its own seed drawn from the given generator, so the samples
+  do not depend on the number of threads.
+*/
 std::vector<State> sample_without_dead_end_detection(
     PotentialOptimizer &optimizer,
     int num_samples,
-    utils::RandomNumberGenerator &rng);
+    utils::RandomNumberGenerator &rng,
+    int num_threads);
+
+/*
+  Read the potential functions from the cache file if the options name a
+  cache directory that contains one for this task and configuration.
+  Otherwise, compute the functions and write them to a new cache file if
+  the options name a cache directory.
+*/
+PotentialFunctions get_cached_potential_functions(
+    const options::Options &opts,
+    const std::function<PotentialFunctions()> &compute_functions);
 
 std::string get_admissible_potentials_reference();
 void prepare_parser_for_admissible_potentials(options::OptionParser &parser);
+void prepare_parser_for_multiple_potential_functions(
+    options::OptionParser &parser);
 }
 
 #endif
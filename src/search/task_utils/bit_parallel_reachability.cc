@@ -0,0 +1,159 @@
+#include "bit_parallel_reachability.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/collections.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace bit_parallel_reachability {
+static LaneMask get_lane_mask(int lane) {
+    assert(lane >= 0 && lane < BitParallelReachability::NUM_LANES);
+    return LaneMask(1) << lane;
+}
+
+BitParallelReachability::BitParallelReachability(const TaskProxy &task_proxy) {
+    int num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+
+    for (OperatorProxy op : task_proxy.get_operators())
+        add_unary_operators(op.get_id(), op);
+    for (OperatorProxy axiom : task_proxy.get_axioms())
+        add_unary_operators(-1, axiom);
+
+    precondition_of.resize(num_facts);
+    int num_unary_ops = unary_operators.size();
+    for (int op_id = 0; op_id < num_unary_ops; ++op_id) {
+        const UnaryOperator &op = unary_operators[op_id];
+        if (op.preconditions_begin == op.preconditions_end)
+            operators_without_preconditions.push_back(op_id);
+        for (int i = op.preconditions_begin; i < op.preconditions_end; ++i)
+            precondition_of[preconditions[i]].push_back(op_id);
+    }
+
+    reached.resize(num_facts, 0);
+    excluded_achievers.resize(num_facts, 0);
+    excluded_operators.resize(task_proxy.get_operators().size(), 0);
+    pending.resize(num_facts, 0);
+}
+
+int BitParallelReachability::get_fact_id(const FactPair &fact) const {
+    return fact_offsets[fact.var] + fact.value;
+}
+
+void BitParallelReachability::add_unary_operators(
+    int operator_id, const OperatorProxy &op) {
+    vector<int> op_preconditions;
+    for (FactProxy pre : op.get_preconditions())
+        op_preconditions.push_back(get_fact_id(pre.get_pair()));
+    for (EffectProxy effect : op.get_effects()) {
+        vector<int> effect_preconditions = op_preconditions;
+        for (FactProxy cond : effect.get_conditions())
+            effect_preconditions.push_back(get_fact_id(cond.get_pair()));
+        utils::sort_unique(effect_preconditions);
+        int begin = preconditions.size();
+        preconditions.insert(preconditions.end(),
+                             effect_preconditions.begin(),
+                             effect_preconditions.end());
+        unary_operators.emplace_back(
+            get_fact_id(effect.get_fact().get_pair()), operator_id,
+            begin, preconditions.size());
+    }
+}
+
+void BitParallelReachability::clear() {
+    fill(reached.begin(), reached.end(), 0);
+    fill(excluded_achievers.begin(), excluded_achievers.end(), 0);
+    fill(excluded_operators.begin(), excluded_operators.end(), 0);
+}
+
+void BitParallelReachability::add_initial_fact(int lane, const FactPair &fact) {
+    reached[get_fact_id(fact)] |= get_lane_mask(lane);
+}
+
+void BitParallelReachability::add_initial_state(int lane, const State &state) {
+    for (FactProxy fact : state)
+        add_initial_fact(lane, fact.get_pair());
+}
+
+void BitParallelReachability::exclude_operator(int lane, int op_id) {
+    excluded_operators[op_id] |= get_lane_mask(lane);
+}
+
+void BitParallelReachability::exclude_achievers(int lane, const FactPair &fact) {
+    excluded_achievers[get_fact_id(fact)] |= get_lane_mask(lane);
+}
+
+void BitParallelReachability::reach(int fact_id, LaneMask lanes) {
+    lanes &= ~reached[fact_id];
+    if (lanes) {
+        reached[fact_id] |= lanes;
+        if (!pending[fact_id])
+            pending_facts.push_back(fact_id);
+        pending[fact_id] |= lanes;
+    }
+}
+
+void BitParallelReachability::run() {
+    /*
+      Each fact is propagated whenever it is reached in new lanes. Then,
+      a unary operator becomes applicable in all new lanes in which all of
+      its preconditions are reached and it is not excluded.
+    */
+    assert(pending_facts.empty());
+    int num_facts = reached.size();
+    for (int fact_id = 0; fact_id < num_facts; ++fact_id) {
+        if (reached[fact_id]) {
+            pending[fact_id] = reached[fact_id];
+            pending_facts.push_back(fact_id);
+        }
+    }
+
+    auto get_allowed_lanes = [this](const UnaryOperator &op) {
+            LaneMask excluded = excluded_achievers[op.effect];
+            if (op.operator_id != -1)
+                excluded |= excluded_operators[op.operator_id];
+            return ~excluded;
+        };
+
+    for (int op_id : operators_without_preconditions) {
+        const UnaryOperator &op = unary_operators[op_id];
+        reach(op.effect, get_allowed_lanes(op));
+    }
+
+    while (!pending_facts.empty()) {
+        int fact_id = pending_facts.back();
+        pending_facts.pop_back();
+        LaneMask new_lanes = pending[fact_id];
+        pending[fact_id] = 0;
+        for (int op_id : precondition_of[fact_id]) {
+            const UnaryOperator &op = unary_operators[op_id];
+            LaneMask lanes = new_lanes & ~reached[op.effect];
+            for (int i = op.preconditions_begin;
+                 lanes && i < op.preconditions_end; ++i) {
+                lanes &= reached[preconditions[i]];
+            }
+            if (lanes)
+                reach(op.effect, lanes & get_allowed_lanes(op));
+        }
+    }
+}
+
+LaneMask BitParallelReachability::get_reached_lanes(const FactPair &fact) const {
+    return reached[get_fact_id(fact)];
+}
+
+LaneMask BitParallelReachability::get_lanes_reaching_all(
+    const vector<FactPair> &facts) const {
+    LaneMask lanes = ~LaneMask(0);
+    for (const FactPair &fact : facts)
+        lanes &= get_reached_lanes(fact);
+    return lanes;
+}
+}
@@ -0,0 +1,90 @@
+#ifndef TASK_UTILS_BIT_PARALLEL_REACHABILITY_H
+#define TASK_UTILS_BIT_PARALLEL_REACHABILITY_H
+
+#include <cstdint>
+#include <vector>
+
+class OperatorProxy;
+class State;
+class TaskProxy;
+struct FactPair;
+
+namespace bit_parallel_reachability {
+/*
+  Compute the facts that are reachable in the delete relaxation for up to
+  64 explorations at once. Exploration i uses bit i ("lane" i) of a 64-bit
+  mask for each fact and operator. Each exploration has its own initial
+  facts and can exclude operators and the achievers of facts, e.g., to test
+  if a fact is a landmark.
+
+  We only compute reachability, not costs or levels, which lets us
+  propagate the bits of all lanes with the same AND and OR operations on
+  the precompiled preconditions of the unary operators. This pays off
+  when many explorations are needed for the same task. Set up the lanes
+  with the add_* and exclude_* methods, call run() and query the results.
+  Call clear() before setting up the next batch of explorations.
+*/
+using LaneMask = uint64_t;
+
+class BitParallelReachability {
+    struct UnaryOperator {
+        int effect;
+        // Index into the task's operators or -1 for axioms.
+        int operator_id;
+        int preconditions_begin;
+        int preconditions_end;
+
+        UnaryOperator(int effect, int operator_id,
+                      int preconditions_begin, int preconditions_end)
+            : effect(effect),
+              operator_id(operator_id),
+              preconditions_begin(preconditions_begin),
+              preconditions_end(preconditions_end) {
+        }
+    };
+
+    // fact_offsets[var]: first fact ID related to variable var
+    std::vector<int> fact_offsets;
+    std::vector<UnaryOperator> unary_operators;
+    std::vector<int> preconditions;
+    std::vector<int> operators_without_preconditions;
+    // Unary operators that have each fact as a precondition.
+    std::vector<std::vector<int>> precondition_of;
+
+    // Per fact: lanes in which the fact is reached and lanes in which its
+    // achievers are excluded. Per operator: lanes in which it is excluded.
+    std::vector<LaneMask> reached;
+    std::vector<LaneMask> excluded_achievers;
+    std::vector<LaneMask> excluded_operators;
+
+    // Lanes in which a fact was reached but not propagated yet.
+    std::vector<LaneMask> pending;
+    std::vector<int> pending_facts;
+
+    int get_fact_id(const FactPair &fact) const;
+    void add_unary_operators(int operator_id, const OperatorProxy &op);
+    void reach(int fact_id, LaneMask lanes);
+public:
+    static const int NUM_LANES = 64;
+
+    explicit BitParallelReachability(const TaskProxy &task_proxy);
+
+    // Reset all lanes to explorations without initial facts or exclusions.
+    void clear();
+
+    void add_initial_fact(int lane, const FactPair &fact);
+    void add_initial_state(int lane, const State &state);
+    // Never apply the given operator.
+    void exclude_operator(int lane, int op_id);
+    // Never apply operators or axioms with the given fact as effect.
+    void exclude_achievers(int lane, const FactPair &fact);
+
+    void run();
+
+    LaneMask get_reached_lanes(const FactPair &fact) const;
+    // Return the lanes in which all given facts are reached.
+    LaneMask get_lanes_reaching_all(const std::vector<FactPair> &facts) const;
+};
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include "fact_tuple_index.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace fact_tuple_index {
+FactTupleIndex::FactTupleIndex(const TaskProxy &task_proxy, int max_size)
+    : max_size(max_size) {
+    assert(max_size >= 1);
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(fact_vars.size());
+        fact_vars.insert(fact_vars.end(), var.get_domain_size(), var.get_id());
+    }
+
+    int num_facts = fact_vars.size();
+    const long long limit = numeric_limits<int>::max();
+    vector<vector<long long>> binomials(
+        max_size + 1, vector<long long>(num_facts + 1, 0));
+    for (int n = 0; n <= num_facts; ++n) {
+        binomials[0][n] = 1;
+        for (int k = 1; k <= max_size && k <= n; ++k) {
+            // Cap the values to avoid overflows. We check the total below.
+            binomials[k][n] = min(limit + 1,
+                                  binomials[k - 1][n - 1] + binomials[k][n - 1]);
+        }
+    }
+
+    size_offsets.assign(2, 0);
+    long long num_tuples = 0;
+    for (int k = 1; k <= max_size; ++k) {
+        num_tuples += binomials[k][num_facts];
+        if (num_tuples > limit) {
+            cerr << "Too many fact tuples of size at most " << max_size
+                 << " (Overflow occurred)." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        size_offsets.push_back(num_tuples);
+    }
+
+    binomial_coefficients.resize(max_size + 1);
+    for (int k = 1; k <= max_size; ++k) {
+        binomial_coefficients[k].assign(binomials[k].begin(), binomials[k].end());
+    }
+}
+
+int FactTupleIndex::get_tuple_id(const vector<FactPair> &facts) const {
+    vector<int> fact_ids;
+    fact_ids.reserve(facts.size());
+    for (const FactPair &fact : facts)
+        fact_ids.push_back(get_fact_id(fact));
+    return get_tuple_id(fact_ids);
+}
+
+void FactTupleIndex::get_tuple(int tuple_id, vector<int> &fact_ids) const {
+    assert(tuple_id >= 0 && tuple_id < get_num_tuples());
+    int size = upper_bound(size_offsets.begin() + 1, size_offsets.end(), tuple_id) -
+        size_offsets.begin() - 1;
+    int rank = tuple_id - size_offsets[size];
+    fact_ids.resize(size);
+    for (int i = size; i >= 1; --i) {
+        // Find the largest fact ID f with binomial(f, i) <= rank.
+        const vector<int> &binomials = binomial_coefficients[i];
+        int fact_id = upper_bound(binomials.begin(), binomials.end(), rank) -
+            binomials.begin() - 1;
+        fact_ids[i - 1] = fact_id;
+        rank -= binomials[fact_id];
+    }
+    assert(rank == 0);
+}
+}
@@ -0,0 +1,80 @@
+#ifndef TASK_UTILS_FACT_TUPLE_INDEX_H
+#define TASK_UTILS_FACT_TUPLE_INDEX_H
+
+#include "../task_proxy.h"
+
+#include <cassert>
+#include <vector>
+
+namespace fact_tuple_index {
+/*
+  Assign consecutive IDs to the facts of a task and perfect-hash all sets
+  ("tuples") of 1 to max_size facts into the range [0, get_num_tuples()).
+
+  The ID of a tuple of size k with fact IDs f_0 < ... < f_{k-1} is the
+  number of tuples with less than k facts plus the rank of the tuple among
+  all tuples of size k in the combinatorial number system, i.e.,
+  sum_i binomial(f_i, i + 1). Computing an ID takes O(k) time and needs no
+  lookup structure.
+
+  The ID range includes tuples with several facts of the same variable,
+  which users can simply ignore. Since most tuples have facts of different
+  variables, this wastes little space.
+*/
+class FactTupleIndex {
+    const int max_size;
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_vars;
+    // binomial_coefficients[k][n] = binomial(n, k) for k <= max_size.
+    std::vector<std::vector<int>> binomial_coefficients;
+    // size_offsets[k]: number of tuples with less than k facts.
+    std::vector<int> size_offsets;
+public:
+    FactTupleIndex(const TaskProxy &task_proxy, int max_size);
+
+    int get_max_size() const {
+        return max_size;
+    }
+
+    int get_num_facts() const {
+        return fact_vars.size();
+    }
+
+    int get_num_tuples() const {
+        return size_offsets[max_size + 1];
+    }
+
+    int get_fact_id(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+
+    FactPair get_fact(int fact_id) const {
+        int var = fact_vars[fact_id];
+        return FactPair(var, fact_id - fact_offsets[var]);
+    }
+
+    int get_variable(int fact_id) const {
+        return fact_vars[fact_id];
+    }
+
+    // Fact IDs must be sorted in increasing order.
+    int get_tuple_id(const std::vector<int> &fact_ids) const {
+        int size = fact_ids.size();
+        assert(size >= 1 && size <= max_size);
+        int id = size_offsets[size];
+        for (int i = 0; i < size; ++i) {
+            assert(i == 0 || fact_ids[i - 1] < fact_ids[i]);
+            id += binomial_coefficients[i + 1][fact_ids[i]];
+        }
+        return id;
+    }
+
+    // Facts must be sorted, which sorts them by fact ID as well.
+    int get_tuple_id(const std::vector<FactPair> &facts) const;
+
+    // Store the sorted fact IDs of the given tuple in fact_ids.
+    void get_tuple(int tuple_id, std::vector<int> &fact_ids) const;
+};
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "task_properties.h"
 
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 #include "../utils/system.h"
@@ -100,6 +101,46 @@ int get_num_total_effects(const TaskProxy &task_proxy) {
     return num_effects;
 }
 
+static void feed_operator(utils::HashState &hash_state, const OperatorProxy &op) {
+    utils::feed(hash_state, op.get_cost());
+    utils::feed(hash_state, get_fact_pairs(op.get_preconditions()));
+    EffectsProxy effects = op.get_effects();
+    utils::feed(hash_state, static_cast<uint64_t>(effects.size()));
+    for (EffectProxy effect : effects) {
+        utils::feed(hash_state, get_fact_pairs(effect.get_conditions()));
+        utils::feed(hash_state, effect.get_fact().get_pair());
+    }
+}
+
+uint64_t compute_task_fingerprint(const TaskProxy &task_proxy) {
+    utils::HashState hash_state;
+    VariablesProxy variables = task_proxy.get_variables();
+    utils::feed(hash_state, static_cast<uint64_t>(variables.size()));
+    for (VariableProxy var : variables) {
+        utils::feed(hash_state, var.get_domain_size());
+        utils::feed(hash_state, var.is_derived());
+        if (var.is_derived()) {
+            utils::feed(hash_state, var.get_axiom_layer());
+            utils::feed(hash_state, var.get_default_axiom_value());
+        }
+    }
+    OperatorsProxy operators = task_proxy.get_operators();
+    utils::feed(hash_state, static_cast<uint64_t>(operators.size()));
+    for (OperatorProxy op : operators) {
+        feed_operator(hash_state, op);
+    }
+    AxiomsProxy axioms = task_proxy.get_axioms();
+    utils::feed(hash_state, static_cast<uint64_t>(axioms.size()));
+    for (OperatorProxy axiom : axioms) {
+        feed_operator(hash_state, axiom);
+    }
+    utils::feed(hash_state, get_fact_pairs(task_proxy.get_goals()));
+    State initial_state = task_proxy.get_initial_state();
+    initial_state.unpack();
+    utils::feed(hash_state, initial_state.get_unpacked_values());
+    return hash_state.get_hash64();
+}
+
 void print_variable_statistics(const TaskProxy &task_proxy) {
     const int_packer::IntPacker &state_packer = g_state_packers[task_proxy];
 
@@ -6,6 +6,8 @@
 
 #include "../algorithms/int_packer.h"
 
+#include <cstdint>
+
 namespace task_properties {
 inline bool is_applicable(OperatorProxy op, const State &state) {
     for (FactProxy precondition : op.get_preconditions()) {
@@ -76,6 +78,14 @@ std::vector<FactPair> get_fact_pairs(const FactProxyCollection &facts) {
     return fact_pairs;
 }
 
+/*
+  Return a hash value of the variables, operators, axioms, initial state
+  and goal of the task, ignoring all names. Equal tasks have equal
+  fingerprints, so the fingerprint can be used to check that data stored
+  on disk belongs to the task at hand.
+*/
+extern std::uint64_t compute_task_fingerprint(const TaskProxy &task_proxy);
+
 extern void print_variable_statistics(const TaskProxy &task_proxy);
 extern void dump_pddl(const State &state);
 extern void dump_fdr(const State &state);
@@ -0,0 +1,140 @@
+#include "cache_file.h"
+
+#include "hash.h"
+#include "logging.h"
+#include "memory.h"
+#include "memory_mapped_file.h"
+#include "system.h"
+
+#include "../options/option_parser.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+static const string CACHE_DIR_KEY = "cache_dir";
+
+static uint64_t compute_config_hash(const string &config) {
+    HashState hash_state;
+    for (char c : config) {
+        feed(hash_state, static_cast<int>(c));
+    }
+    return hash_state.get_hash64();
+}
+
+static void add_hash_to_header(vector<int> &header, uint64_t hash) {
+    header.push_back(static_cast<int>(static_cast<uint32_t>(hash)));
+    header.push_back(static_cast<int>(static_cast<uint32_t>(hash >> 32)));
+}
+
+CacheFile::CacheFile(
+    const string &cache_dir, const string &name, const string &config,
+    uint64_t task_fingerprint, int magic, int version) {
+    uint64_t config_hash = compute_config_hash(config);
+    ostringstream filename_stream;
+    filename_stream << cache_dir << "/" << name << "-" << hex << setfill('0')
+                    << setw(16) << task_fingerprint << "-"
+                    << setw(16) << config_hash << ".cache";
+    filename = filename_stream.str();
+
+    header = {magic, version};
+    add_hash_to_header(header, task_fingerprint);
+    add_hash_to_header(header, config_hash);
+}
+
+unique_ptr<MemoryMappedFile> CacheFile::read(
+    const function<bool(const char *, size_t)> &read_payload) const {
+    unique_ptr<MemoryMappedFile> file =
+        make_unique_ptr<MemoryMappedFile>(filename);
+    if (!file->is_open()) {
+        g_log << "Cache file " << filename << " not found." << endl;
+        return nullptr;
+    }
+
+    const size_t header_bytes = header.size() * sizeof(int);
+    bool valid = file->get_size() >= header_bytes &&
+        memcmp(file->get_data(), header.data(), header_bytes) == 0 &&
+        read_payload(file->get_data() + header_bytes,
+                     file->get_size() - header_bytes);
+    if (!valid) {
+        g_log << "Ignoring cache file " << filename
+              << " because it does not belong to this task or is corrupt."
+              << endl;
+        return nullptr;
+    }
+    return file;
+}
+
+/*
+  Create a new file with a unique name for writing the cache file. Return
+  an empty string if this is impossible.
+*/
+static string create_temporary_file(const string &filename) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    string pattern = filename + ".XXXXXX";
+    vector<char> tmp_file(pattern.begin(), pattern.end());
+    tmp_file.push_back('\0');
+    int fd = mkstemp(tmp_file.data());
+    if (fd == -1) {
+        return string();
+    }
+    // mkstemp() makes the file private, but cache files can be shared.
+    fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    close(fd);
+    return string(tmp_file.data());
+#else
+    return filename + "." + to_string(get_process_id()) + ".tmp";
+#endif
+}
+
+bool CacheFile::write(const function<void(ostream &)> &write_payload) const {
+    string tmp_file = create_temporary_file(filename);
+    if (tmp_file.empty()) {
+        g_log << "Could not write cache file " << filename << "." << endl;
+        return false;
+    }
+    ofstream file(tmp_file, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char *>(header.data()),
+               header.size() * sizeof(int));
+    write_payload(file);
+    file.close();
+    if (!file || rename(tmp_file.c_str(), filename.c_str()) != 0) {
+        g_log << "Could not write cache file " << filename << "." << endl;
+        remove(tmp_file.c_str());
+        return false;
+    }
+    return true;
+}
+
+void add_cache_dir_option_to_parser(options::OptionParser &parser) {
+    parser.add_option<string>(
+        CACHE_DIR_KEY,
+        "directory for cache files. If the directory contains a cache file "
+        "for the same task and configuration, the data is read from it. "
+        "Otherwise, the data is computed and written to a new cache file "
+        "in the directory. The directory must exist.",
+        options::OptionParser::NONE);
+}
+
+unique_ptr<CacheFile> parse_cache_file_from_options(
+    const options::Options &opts, const string &name,
+    uint64_t task_fingerprint, int magic, int version) {
+    if (!opts.contains(CACHE_DIR_KEY)) {
+        return nullptr;
+    }
+    return make_unique_ptr<CacheFile>(
+        opts.get<string>(CACHE_DIR_KEY), name,
+        opts.get_resolved_config(CACHE_DIR_KEY),
+        task_fingerprint, magic, version);
+}
+}
@@ -0,0 +1,83 @@
+#ifndef UTILS_CACHE_FILE_H
+#define UTILS_CACHE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace utils {
+class MemoryMappedFile;
+
+/*
+  File in which a planner component stores data that is expensive to
+  compute, so that later planner runs can reuse it.
+
+  Cache files are stored in the directory given by the option cache_dir.
+  The file name contains the task fingerprint and a hash of the
+  configuration of the component (without the option cache_dir), so runs
+  on other tasks or with other options use other files.
+
+  A cache file starts with a header of six ints in native byte order: a
+  magic number identifying the kind of data, the format version, the task
+  fingerprint and the configuration hash (lower and upper 32 bits each).
+  The payload follows the header and starts at an 8-byte boundary of the
+  file.
+*/
+class CacheFile {
+    std::string filename;
+    std::vector<int> header;
+public:
+    /*
+      The config is the resolved configuration of the component without the
+      option cache_dir (see Options::get_resolved_config()). The name is
+      used as the prefix of the file name.
+    */
+    CacheFile(const std::string &cache_dir, const std::string &name,
+              const std::string &config, std::uint64_t task_fingerprint,
+              int magic, int version);
+
+    const std::string &get_filename() const {
+        return filename;
+    }
+
+    /*
+      Map the file into memory, check its header and pass the payload to
+      read_payload, which returns false if the payload is corrupt. Return
+      the mapped file if all checks succeed and nullptr otherwise. The
+      caller may keep the mapped file to use the payload without copying it.
+    */
+    std::unique_ptr<MemoryMappedFile> read(
+        const std::function<bool(const char *, std::size_t)> &read_payload) const;
+
+    /*
+      Write the header and the payload written by write_payload to a new
+      temporary file in the cache directory and rename it to the cache
+      file afterwards. This way, concurrent planner runs never read or
+      write a partially written cache file. Return true on success.
+    */
+    bool write(const std::function<void(std::ostream &)> &write_payload) const;
+};
+
+// Add the option cache_dir to the parser.
+extern void add_cache_dir_option_to_parser(options::OptionParser &parser);
+
+/*
+  Return the cache file of the component configured by the given options,
+  or nullptr if the option cache_dir is not set. Only use this together
+  with "add_cache_dir_option_to_parser()".
+*/
+extern std::unique_ptr<CacheFile> parse_cache_file_from_options(
+    const options::Options &opts, const std::string &name,
+    std::uint64_t task_fingerprint, int magic, int version);
+}
+
+#endif
@@ -0,0 +1,62 @@
+#include "memory_mapped_file.h"
+
+#include "system.h"
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+using namespace std;
+
+namespace utils {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+MemoryMappedFile::MemoryMappedFile(const string &filename)
+    : data(nullptr),
+      size(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+    struct stat file_status;
+    if (fstat(fd, &file_status) == 0 && file_status.st_size > 0) {
+        void *mapping = mmap(
+            nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const char *>(mapping);
+            size = file_status.st_size;
+        }
+    }
+    // The mapping stays valid after closing the file descriptor.
+    close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+    if (data) {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+#else
+MemoryMappedFile::MemoryMappedFile(const string &filename)
+    : data(nullptr),
+      size(0) {
+    ifstream file(filename, ios::binary);
+    if (!file) {
+        return;
+    }
+    buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    if (!buffer.empty()) {
+        data = buffer.data();
+        size = buffer.size();
+    }
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+}
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef UTILS_MEMORY_MAPPED_FILE_H
+#define UTILS_MEMORY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace utils {
+/*
+  Read-only view of the contents of a file. On Unix systems, the file is
+  mapped into memory, so that only the pages that are accessed are read
+  and the pages can be shared between processes. On other systems, the
+  file is read into memory.
+
+  If the file cannot be opened or is empty, is_open() returns false.
+*/
+class MemoryMappedFile {
+    const char *data;
+    std::size_t size;
+    // Only used if memory mapping is not available.
+    std::vector<char> buffer;
+public:
+    explicit MemoryMappedFile(const std::string &filename);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+
+    bool is_open() const {
+        return data != nullptr;
+    }
+
+    const char *get_data() const {
+        return data;
+    }
+
+    std::size_t get_size() const {
+        return size;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,28 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+void process_jobs_in_parallel(
+    int num_jobs, int num_threads, const function<void(int, int)> &process) {
+    atomic<int> next_job(0);
+    auto work = [&](int thread_id) {
+            for (int job = next_job++; job < num_jobs; job = next_job++) {
+                process(thread_id, job);
+            }
+        };
+    vector<thread> helpers;
+    for (int i = 1; i < min(num_threads, num_jobs); ++i) {
+        helpers.emplace_back(work, i);
+    }
+    work(0);
+    for (thread &helper : helpers) {
+        helper.join();
+    }
+}
+}
@@ -0,0 +1,20 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <functional>
+
+namespace utils {
+/*
+  Call process(thread_id, job) for all jobs 0, ..., num_jobs - 1. The jobs
+  are distributed over min(num_threads, num_jobs) threads, including the
+  calling thread, with IDs 0, 1, .... Each thread takes the next
+  unprocessed job when it is done with its previous job, so jobs are
+  started in order of increasing number. Since the jobs run concurrently,
+  they must not write to the log.
+*/
+extern void process_jobs_in_parallel(
+    int num_jobs, int num_threads,
+    const std::function<void(int, int)> &process);
+}
+
+#endif